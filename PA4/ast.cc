@@ -7,17 +7,20 @@
 #include "ast_decl.h"
 #include "symtable.h"
 #include "irgen.h"
+#include "memstats.h"
 #include <string.h> // strdup
 #include <stdio.h>  // printf
 
 Node::Node(yyltype loc) {
     location = new yyltype(loc);
     parent = NULL;
+    CountNode(this);
 }
 
 Node::Node() {
     location = NULL;
     parent = NULL;
+    CountNode(this);
 }
 
 /* The Print method is used to print the parse tree nodes.
@@ -40,6 +40,7 @@
 #include <stdlib.h>   // for NULL
 #include "location.h"
 #include <iostream>
+#include <vector>
 #include "llvm/IR/Module.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Instructions.h"
@@ -80,6 +81,11 @@ class Node  {
     void Print(int indentLevel, const char *label = NULL); 
     virtual void PrintChildren(int indentLevel)  {}
 
+    // Appends the statements, expressions and declarations directly
+    // below this node to children, in source order.  Used to walk the
+    // tree before it is emitted.
+    virtual void GetChildren(vector<Node*> *children) {}
+
     virtual llvm::Value* Emit() {return NULL;}
 };
    
@@ -7,37 +7,121 @@
 #include "ast_stmt.h"
 #include "symtable.h"        
 #include "irgen.h"
+#include "timer.h"
+#include "utility.h"
          
 Decl::Decl(Identifier *n) : Node(*n->GetLocation()) {
     Assert(n != NULL);
     (id=n)->SetParent(this); 
 }
 
+/* Function: CheckInitializer()
+ * ----------------------------
+ * An array is initialized by an initializer list with exactly one
+ * element per array element, and nothing else is.  The elements' types
+ * are checked as they are emitted (see EmitInitializer).
+ */
+static bool CheckInitializer(VarDecl *decl) {
+	InitializerList* list = dynamic_cast<InitializerList*>(decl->GetAssign());
+	ArrayType* arrayType = dynamic_cast<ArrayType*>(decl->GetType());
+
+	if(list == NULL && arrayType != NULL) {
+		ReportError::Formatted(decl->GetAssign()->GetLocation(), "array '%s' must be initialized with an initializer list", decl->GetIdentifier()->GetName());
+		return false;
+	}
+	if(list == NULL) {
+		return true;
+	}
+	if(arrayType == NULL || list->NumElements() != arrayType->GetElemCount()) {
+		ReportError::Formatted(list->GetLocation(), "initializer list does not match the array size of '%s'", decl->GetIdentifier()->GetName());
+		return false;
+	}
+	list->SetTarget(arrayType, decl->GetIdentifier());
+	return true;
+}
+
+/* Function: IsHalfPrecision()
+ * ----------------------------
+ * A mediump or lowp global, or any global under -fhalf-precision, keeps
+ * its floats as half to halve the memory a large array takes; the
+ * arithmetic on it is still done as float (see IRGenerator::EmitLoad).
+ * Locals and consts are left alone, since they live in registers.
+ */
+bool VarDecl::IsHalfPrecision() const {
+	if(IsConst() || !symtab->is_global()) {
+		return false;
+	}
+	return IsOptionOn("half-precision") || (typeq != NULL && typeq->IsReducedPrecision());
+}
+
 llvm::Value* VarDecl::Emit() {
 	llvm::Value* value = NULL;
 	llvm::Value* inst = NULL;
-	
-	if(GetAssign() != NULL) {
-		value = GetAssign()->Emit();
+	llvm::Type* ty = irgen->ast_llvm(GetType(), irgen->GetContext());
+	llvm::Constant* constant = NULL;
+
+	if(GetAssign() != NULL && !CheckInitializer(this)) {
+		assignTo = NULL;
 	}
-	else{
-		value = llvm::Constant::getNullValue(irgen->ast_llvm(GetType(), irgen->GetContext()));
+
+	// const and global initializers are folded from the AST, so they
+	// never reach the IR as instructions
+	if(GetAssign() != NULL && (IsConst() || symtab->is_global())) {
+		constant = FoldInitializer(GetAssign(), GetType());
 	}
 
-	llvm::Constant* constant = dynamic_cast<llvm::Constant*>(value);
+	if(IsConst() && constant != NULL && !ty->isArrayTy()) {
+		// nothing to store: uses of the name get the value itself
+		symtab->add_decl(string(GetIdentifier()->GetName()), this, constant);
+		return constant;
+	}
+
+	if(IsConst() && ty->isArrayTy() && (constant != NULL || GetAssign() == NULL)) {
+		if(constant == NULL) {
+			constant = llvm::Constant::getNullValue(ty);
+		}
+		llvm::GlobalVariable* global = new llvm::GlobalVariable(*irgen->GetOrCreateModule("Program_Module.bc"), ty, true, llvm::GlobalValue::InternalLinkage, constant, id->GetName());
+		global->setUnnamedAddr(true);
+
+		symtab->add_decl(string(GetIdentifier()->GetName()), this, global);
+		return global;
+	}
 
 	if(symtab->is_global()) {
-		inst = new llvm::GlobalVariable(*irgen->GetOrCreateModule("Program_Module.bc"), irgen->ast_llvm(GetType(), irgen->GetContext()), false, llvm::GlobalValue::ExternalLinkage, constant, id->GetName());
+		// a global without an initializer starts out zeroed
+		if(constant == NULL && GetAssign() != NULL) {
+			ReportUnfolded(GetAssign(), GetType(), GetIdentifier());
+		}
+		if(constant == NULL) {
+			constant = llvm::Constant::getNullValue(ty);
+		}
+		// the storage may be padded (-fpad-vec3) or half, but the
+		// initializer is folded as computed on
+		ty = irgen->PaddedType(ty);
+		if(IsHalfPrecision()) {
+			ty = irgen->HalfType(ty);
+		}
+		constant = llvm::cast<llvm::Constant>(irgen->Convert(constant, ty));
+		inst = new llvm::GlobalVariable(*irgen->GetOrCreateModule("Program_Module.bc"), ty, false, llvm::GlobalValue::ExternalLinkage, constant, id->GetName());
 
 		symtab->add_decl(string(GetIdentifier()->GetName()), this, inst);
 	}
 	else {
-		inst = new llvm::AllocaInst(irgen->ast_llvm(GetType(), irgen->GetContext()),id->GetName(), irgen->GetBasicBlock());
+		if(GetAssign() != NULL) {
+			value = EmitInitializer(GetAssign(), GetType(), GetIdentifier());
+		}
+
+		// a local array stays in memory and is padded like a global; a
+		// local vector is promoted to a register, where padding is moot
+		if(ty->isArrayTy()) {
+			ty = irgen->PaddedType(ty);
+		}
+		inst = irgen->GetBuilder()->CreateAlloca(ty, NULL, id->GetName());
 
 		symtab->add_decl(string(GetIdentifier()->GetName()), this, inst);
 
-		if(GetAssign() != NULL) {
-			new llvm::StoreInst(value,inst,"Initial Store",irgen->GetBasicBlock());
+		if(value != NULL) {
+			irgen->EmitStore(value, inst);
 		}
 
 	}
@@ -48,6 +132,7 @@ llvm::Value* VarDecl::Emit() {
 VarDecl::VarDecl(Identifier *n, Type *t, Expr *e) : Decl(n) {
 	Assert(n != NULL && t != NULL);
 	(type=t)->SetParent(this);
+	assignTo = NULL;
 	if (e) (assignTo=e)->SetParent(this);
 	typeq = NULL;
 }
@@ -55,6 +140,7 @@ VarDecl::VarDecl(Identifier *n, Type *t, Expr *e) : Decl(n) {
 VarDecl::VarDecl(Identifier *n, TypeQualifier *tq, Expr *e) : Decl(n) {
 	Assert(n != NULL && tq != NULL);
 	(typeq=tq)->SetParent(this);
+	assignTo = NULL;
 	if (e) (assignTo=e)->SetParent(this);
 	type = NULL;
 }
@@ -63,6 +149,7 @@ VarDecl::VarDecl(Identifier *n, Type *t, TypeQualifier *tq, Expr *e) : Decl(n) {
 	Assert(n != NULL && t != NULL && tq != NULL);
 	(type=t)->SetParent(this);
     (typeq=tq)->SetParent(this);
+    assignTo = NULL;
     if (e) (assignTo=e)->SetParent(this);
 }
   
@@ -73,7 +160,12 @@ void VarDecl::PrintChildren(int indentLevel) {
    if (assignTo) assignTo->Print(indentLevel+1, "(initializer) ");
 }
 
+void VarDecl::GetChildren(vector<Node*> *children) {
+   if (assignTo) children->push_back(assignTo);
+}
+
 llvm::Value* FnDecl::Emit() {
+	PhaseTimer timer("function", GetIdentifier()->GetName());
 	std::vector<llvm::Type*> argTypes;
 
 	//llvm::LLVMContext *context = irgen->GetContext();
@@ -106,10 +198,10 @@ llvm::Value* FnDecl::Emit() {
 
 	for(llvm::Function::arg_iterator args = f->arg_begin(); args != f->arg_end(); args++) {
 		args->setName(formals->Nth(i)->GetIdentifier()->GetName());
-		llvm::Value* mem = new llvm::AllocaInst(irgen->ast_llvm(formals->Nth(i)->GetType(), irgen->GetContext()),formals->Nth(i)->GetIdentifier()->GetName(), irgen->GetBasicBlock());
+		llvm::Value* mem = irgen->GetBuilder()->CreateAlloca(irgen->ast_llvm(formals->Nth(i)->GetType(), irgen->GetContext()), NULL, formals->Nth(i)->GetIdentifier()->GetName());
 		//new llvm::StoreInst(args, symtab->val_search(formals->Nth(i)->GetIdentifier()->GetName()), irgen->GetBasicBlock());
 		symtab->add_decl(string(formals->Nth(i)->GetIdentifier()->GetName()), formals->Nth(i), mem);
-		new llvm::StoreInst(args, mem, irgen->GetBasicBlock());
+		irgen->GetBuilder()->CreateStore(&*args, mem);
 
 		i++;
 	}
@@ -157,3 +249,8 @@ void FnDecl::PrintChildren(int indentLevel) {
     if (body) body->Print(indentLevel+1, "(body) ");
 }
 
+void FnDecl::GetChildren(vector<Node*> *children) {
+    formals->AppendAllTo(children);
+    if (body) children->push_back(body);
+}
+
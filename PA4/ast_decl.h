@@ -56,8 +56,14 @@ class VarDecl : public Decl
     VarDecl(Identifier *name, Type *type, TypeQualifier *typeq, Expr *assignTo = NULL);
     const char *GetPrintNameForNode() { return "VarDecl"; }
     void PrintChildren(int indentLevel);
+    void GetChildren(vector<Node*> *children);
     Type *GetType() const { return type; }
     Expr *GetAssign() const { return assignTo; }
+    bool IsConst() const { return typeq != NULL && typeq->GetStorage() == TypeQualifier::constTypeQualifier; }
+    // in, out and uniform variables are set or read from outside
+    bool IsInterface() const { return typeq != NULL && typeq->GetStorage() != NULL && !IsConst(); }
+    // stored as half: see VarDecl::Emit
+    bool IsHalfPrecision() const;
     virtual llvm::Value* Emit();
 };
 
@@ -83,6 +89,7 @@ class FnDecl : public Decl
     void SetFunctionBody(Stmt *b);
     const char *GetPrintNameForNode() { return "FnDecl"; }
     void PrintChildren(int indentLevel);
+    void GetChildren(vector<Node*> *children);
     virtual llvm::Value* Emit();
 
     Type *GetType() const { return returnType; }
@@ -9,6 +9,9 @@
 #include "ast_decl.h"
 #include "symtable.h"
 #include "irgen.h"
+#include "errors.h"
+#include "mathlib.h"
+#include "llvm/IR/Intrinsics.h"
 
 llvm::Value* IntConstant::Emit() {
 	this->type = Type::intType;
@@ -22,6 +25,10 @@ llvm::Type* IntConstant::EmitType() {
 	return irgen->ast_llvm(Type::intType, irgen->GetContext());
 }
 
+llvm::Constant* IntConstant::Fold() {
+	return llvm::cast<llvm::Constant>(Emit());
+}
+
 IntConstant::IntConstant(yyltype loc, int val) : Expr(loc) {
 	value = val;
 }
@@ -29,6 +36,29 @@ void IntConstant::PrintChildren(int indentLevel) {
 	printf("%d", value);
 }
 
+llvm::Value* UintConstant::Emit() {
+	this->type = Type::uintType;
+	llvm::LLVMContext* context = irgen->GetContext();
+	llvm::Value* val = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context), GetValue());
+
+	return val;
+}
+
+llvm::Type* UintConstant::EmitType() {
+	return irgen->ast_llvm(Type::uintType, irgen->GetContext());
+}
+
+llvm::Constant* UintConstant::Fold() {
+	return llvm::cast<llvm::Constant>(Emit());
+}
+
+UintConstant::UintConstant(yyltype loc, unsigned int val) : Expr(loc) {
+	value = val;
+}
+void UintConstant::PrintChildren(int indentLevel) { 
+	printf("%uu", value);
+}
+
 llvm::Value* FloatConstant::Emit() {
 	this->type = Type::floatType;
 	llvm::LLVMContext* context = irgen->GetContext();
@@ -41,6 +71,10 @@ llvm::Type* FloatConstant::EmitType() {
 	return irgen->ast_llvm(Type::floatType, irgen->GetContext());
 }
 
+llvm::Constant* FloatConstant::Fold() {
+	return llvm::cast<llvm::Constant>(Emit());
+}
+
 FloatConstant::FloatConstant(yyltype loc, double val) : Expr(loc) {
 	value = val;
 }
@@ -60,6 +94,10 @@ llvm::Type* BoolConstant::EmitType() {
 	return irgen->ast_llvm(Type::boolType, irgen->GetContext());
 }
 
+llvm::Constant* BoolConstant::Fold() {
+	return llvm::cast<llvm::Constant>(Emit());
+}
+
 BoolConstant::BoolConstant(yyltype loc, bool val) : Expr(loc) {
 	value = val;
 }
@@ -79,7 +117,7 @@ void BoolConstant::PrintChildren(int indentLevel) {
    return irgen->ast_llvm(Type::voidType, irgen->GetContext());
    }*/
 
-VarExpr::VarExpr(yyltype loc, Identifier *ident) : Expr(loc) {
+VarExpr::VarExpr(yyltype loc, Identifier *ident) : LValue(loc) {
 	Assert(ident != NULL);
 	this->id = ident;
 }
@@ -88,16 +126,56 @@ void VarExpr::PrintChildren(int indentLevel) {
 	id->Print(indentLevel+1);
 }
 
+/* Function: IsFoldedConst()
+ * --------------------------
+ * A const variable with a constant initializer gets no storage: its
+ * symbol table entry is the value itself rather than an address.
+ */
+static bool IsFoldedConst(llvm::Value *val) {
+	return llvm::isa<llvm::Constant>(val) && !llvm::isa<llvm::GlobalValue>(val);
+}
+
 llvm::Value* VarExpr::Emit() {
 	llvm::Value* tempVal = symtab->val_search(string(GetIdentifier()->GetName()));
 	Decl* tempDecl = symtab->search_scope(string(GetIdentifier()->GetName()));
 	VarDecl* dynamcast = dynamic_cast<VarDecl*>(tempDecl);
 
 	this->type = dynamcast->GetType();
+	if(!valueUsed) {
+		return NULL;
+	}
+	if(IsFoldedConst(tempVal)) {
+		return tempVal;
+	}
+
+	return irgen->EmitLoad(tempVal, irgen->ast_llvm(type, irgen->GetContext()), GetIdentifier()->GetName());
+}
+
+bool VarExpr::EmitLValue(LValueRef *ref) {
+	Decl* tempDecl = symtab->search_scope(string(GetIdentifier()->GetName()));
+	VarDecl* dynamcast = dynamic_cast<VarDecl*>(tempDecl);
+
+	this->type = dynamcast->GetType();
+	ref->addr = symtab->val_search(string(GetIdentifier()->GetName()));
+	ref->type = irgen->ast_llvm(this->type, irgen->GetContext());
+	ref->readOnly = dynamcast->IsConst();
+	return true;
+}
 
-	llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, GetIdentifier()->GetName(), irgen->GetBasicBlock());
-	return vExprInst;
+llvm::Constant* VarExpr::Fold() {
+	VarDecl* decl = dynamic_cast<VarDecl*>(symtab->search_scope(string(GetIdentifier()->GetName())));
+	if(decl == NULL || !decl->IsConst()) {
+		return NULL;
+	}
+	this->type = decl->GetType();
 
+	// a const array is a constant global holding the whole array
+	llvm::Value* val = symtab->val_search(string(GetIdentifier()->GetName()));
+	llvm::GlobalVariable* global = llvm::dyn_cast<llvm::GlobalVariable>(val);
+	if(global != NULL) {
+		return global->isConstant() ? global->getInitializer() : NULL;
+	}
+	return IsFoldedConst(val) ? llvm::cast<llvm::Constant>(val) : NULL;
 }
 
 Operator::Operator(yyltype loc, const char *tok) : Node(loc) {
@@ -113,4110 +191,2228 @@ bool Operator::IsOp(const char *op) const {
 	return strcmp(tokenString, op) == 0;
 }
 
+/* Function: ScalarType()
+ * -----------------------
+ * The type of one lane of a vector type, or the type itself for a
+ * scalar.
+ */
+static Type* ScalarType(Type *type) {
+	if(type == Type::vec2Type || type == Type::vec3Type || type == Type::vec4Type) return Type::floatType;
+	if(type == Type::ivec2Type || type == Type::ivec3Type || type == Type::ivec4Type) return Type::intType;
+	if(type == Type::uvec2Type || type == Type::uvec3Type || type == Type::uvec4Type) return Type::uintType;
+	if(type == Type::bvec2Type || type == Type::bvec3Type || type == Type::bvec4Type) return Type::boolType;
+	return type;
+}
+
+/* Function: VectorSize()
+ * -----------------------
+ * Returns the number of lanes of a vector type, 0 for anything else.
+ */
+static int VectorSize(Type *type) {
+	if(type == Type::vec2Type || type == Type::ivec2Type || type == Type::uvec2Type || type == Type::bvec2Type) return 2;
+	if(type == Type::vec3Type || type == Type::ivec3Type || type == Type::uvec3Type || type == Type::bvec3Type) return 3;
+	if(type == Type::vec4Type || type == Type::ivec4Type || type == Type::uvec4Type || type == Type::bvec4Type) return 4;
+	return 0;
+}
+
+/* Function: VectorOf()
+ * --------------------
+ * Returns the vector type with n lanes of the given scalar type, or the
+ * scalar type itself for a single lane.
+ */
+static Type* VectorOf(Type *scalar, int n) {
+	if(n == 1) {
+		return scalar;
+	}
+	Type* floats[] = { Type::vec2Type, Type::vec3Type, Type::vec4Type };
+	Type* ints[] = { Type::ivec2Type, Type::ivec3Type, Type::ivec4Type };
+	Type* uints[] = { Type::uvec2Type, Type::uvec3Type, Type::uvec4Type };
+	Type* bools[] = { Type::bvec2Type, Type::bvec3Type, Type::bvec4Type };
+
+	if(n < 2 || n > 4) return NULL;
+	if(scalar == Type::floatType) return floats[n - 2];
+	if(scalar == Type::intType) return ints[n - 2];
+	if(scalar == Type::uintType) return uints[n - 2];
+	if(scalar == Type::boolType) return bools[n - 2];
+	return NULL;
+}
+
+/* Function: IsUnsigned()
+ * ----------------------
+ * uint and uvec values are plain i32s in the IR, so the AST type is what
+ * picks unsigned division, comparison and right shift.
+ */
+static bool IsUnsigned(Type *type) {
+	return ScalarType(type) == Type::uintType;
+}
+
+/* Function: IsUnsignedArithmetic()
+ * --------------------------------
+ * Whether l op r is unsigned: a shift takes its signedness from the
+ * value shifted alone, so int >> uint is still arithmetic, and the other
+ * operators from either operand.
+ */
+static bool IsUnsignedArithmetic(char op, Type *l, Type *r) {
+	if(op == '<' || op == '>') {
+		return IsUnsigned(l);
+	}
+	return IsUnsigned(l) || IsUnsigned(r);
+}
+
 llvm::Value* RelationalExpr::Emit() {
+	if(!valueUsed) {
+		this->type = Type::boolType;
+		return EmitOperandsForEffect();
+	}
+
 	llvm::Value* l = left->Emit();
 	llvm::Value* r = right->Emit();
+	return EmitCompare(l, r);
+}
 
-	if(left->GetType() == Type::intType && right->GetType() == Type::intType) {
-		this->type = Type::boolType;
-		llvm::CmpInst::Predicate pred;
+llvm::Constant* RelationalExpr::Fold() {
+	llvm::Constant* l = left->Fold();
+	llvm::Constant* r = right->Fold();
 
-		if(op->IsOp(">")) {
-			pred = llvm::ICmpInst::ICMP_SGT;
+	if(l == NULL || r == NULL) {
+		return NULL;
+	}
+	return llvm::dyn_cast_or_null<llvm::Constant>(EmitCompare(l, r));
+}
 
-			return llvm::CmpInst::Create(llvm::CmpInst::ICmp, pred, l, r, "IG", irgen->GetBasicBlock());
-		}
-		else if(op->IsOp("<")) {
-			pred = llvm::ICmpInst::ICMP_SLT;
+/* Function: EmitCompare()
+ * ------------------------
+ * Compares two operands of the same type.  Vectors are compared lane
+ * by lane in one instruction, giving a bvec mask for any() and all().
+ */
+llvm::Value* RelationalExpr::EmitCompare(llvm::Value *l, llvm::Value *r) {
+	llvm::IRBuilder<> *builder = irgen->GetBuilder();
+	static const char* const ops[] = { ">", "<", ">=", "<=" };
+	static const llvm::CmpInst::Predicate fpreds[] = { llvm::FCmpInst::FCMP_OGT, llvm::FCmpInst::FCMP_OLT, llvm::FCmpInst::FCMP_OGE, llvm::FCmpInst::FCMP_OLE };
+	static const llvm::CmpInst::Predicate spreds[] = { llvm::ICmpInst::ICMP_SGT, llvm::ICmpInst::ICMP_SLT, llvm::ICmpInst::ICMP_SGE, llvm::ICmpInst::ICMP_SLE };
+	static const llvm::CmpInst::Predicate upreds[] = { llvm::ICmpInst::ICMP_UGT, llvm::ICmpInst::ICMP_ULT, llvm::ICmpInst::ICMP_UGE, llvm::ICmpInst::ICMP_ULE };
+	static const char* const fnames[] = { "FG", "FL", "FGE", "FLE" };
+	static const char* const inames[] = { "IG", "IL", "IGE", "ILE" };
+
+	Type* scalar = ScalarType(left->GetType());
+	if(left->GetType() != right->GetType() || (scalar != Type::intType && scalar != Type::uintType && scalar != Type::floatType)) {
+		return NULL;
+	}
 
-			return llvm::CmpInst::Create(llvm::CmpInst::ICmp, pred, l, r, "IL", irgen->GetBasicBlock());
+	for(int i = 0; i < 4; i++) {
+		if(!op->IsOp(ops[i])) {
+			continue;
 		}
-		else if(op->IsOp(">=")) {
-			pred = llvm::ICmpInst::ICMP_SGE;
+		int lanes = VectorSize(left->GetType());
+		this->type = lanes != 0 ? VectorOf(Type::boolType, lanes) : Type::boolType;
 
-			return llvm::CmpInst::Create(llvm::CmpInst::ICmp, pred, l, r, "IGE", irgen->GetBasicBlock());
+		if(scalar == Type::floatType) {
+			return builder->CreateFCmp(fpreds[i], l, r, fnames[i]);
 		}
-		else if(op->IsOp("<=")) {
-			pred = llvm::ICmpInst::ICMP_SLE;	
+		return builder->CreateICmp(scalar == Type::uintType ? upreds[i] : spreds[i], l, r, inames[i]);
+	}
+	return NULL;
+}
 
-			return llvm::CmpInst::Create(llvm::CmpInst::ICmp, pred, l, r, "ILE", irgen->GetBasicBlock());
-		}
 
-	}
-	else if(left->GetType() == Type::floatType && right->GetType() == Type::floatType) {
+llvm::Value* EqualityExpr::Emit() {
+	if(!valueUsed) {
 		this->type = Type::boolType;
-		llvm::CmpInst::Predicate pred;
+		return EmitOperandsForEffect();
+	}
 
-		if(op->IsOp(">")) {
-			pred = llvm::FCmpInst::FCMP_OGT;
+	llvm::Value* l = left->Emit();
+	llvm::Value* r = right->Emit();
+	return EmitCompare(l, r);
+}
 
-			return llvm::CmpInst::Create(llvm::CmpInst::FCmp, pred, l, r, "FG", irgen->GetBasicBlock());
-		}
-		else if(op->IsOp("<")) {
-			pred = llvm::FCmpInst::FCMP_OLT;
+llvm::Constant* EqualityExpr::Fold() {
+	llvm::Constant* l = left->Fold();
+	llvm::Constant* r = right->Fold();
 
-			return llvm::CmpInst::Create(llvm::CmpInst::FCmp, pred, l, r, "FL", irgen->GetBasicBlock());
-		}
-		else if(op->IsOp(">=")) {
-			pred = llvm::FCmpInst::FCMP_OGE;
+	if(l == NULL || r == NULL) {
+		return NULL;
+	}
+	return llvm::dyn_cast_or_null<llvm::Constant>(EmitCompare(l, r));
+}
 
-			return llvm::CmpInst::Create(llvm::CmpInst::FCmp, pred, l, r, "FGE", irgen->GetBasicBlock());
-		}
-		else if(op->IsOp("<=")) {
-			pred = llvm::FCmpInst::FCMP_OLE;
+/* Function: EmitCompare()
+ * ------------------------
+ * == and != give a single bool for vectors too: the lanes are compared
+ * at once and the mask, viewed as an integer with one bit per lane, is
+ * tested against all ones or zero.
+ */
+llvm::Value* EqualityExpr::EmitCompare(llvm::Value *l, llvm::Value *r) {
+	llvm::IRBuilder<> *builder = irgen->GetBuilder();
+	bool equal = op->IsOp("==");
 
-			return llvm::CmpInst::Create(llvm::CmpInst::FCmp, pred, l, r, "FLE", irgen->GetBasicBlock());
-		}
+	Type* scalar = ScalarType(left->GetType());
+	if(left->GetType() != right->GetType() || (!equal && !op->IsOp("!="))) {
+		return NULL;
 	}
 
-	return NULL;
+	llvm::Value* mask;
+	if(scalar == Type::floatType) {
+		mask = builder->CreateFCmp(equal ? llvm::FCmpInst::FCMP_OEQ : llvm::FCmpInst::FCMP_UNE, l, r, equal ? "FEQ" : "FNEQ");
+	}
+	else if(scalar == Type::intType || scalar == Type::uintType || scalar == Type::boolType) {
+		mask = builder->CreateICmp(equal ? llvm::ICmpInst::ICMP_EQ : llvm::ICmpInst::ICMP_NE, l, r, equal ? "IEQ" : "INEQ");
+	}
+	else {
+		return NULL;
+	}
+	this->type = Type::boolType;
+
+	int lanes = VectorSize(left->GetType());
+	if(lanes == 0) {
+		return mask;
+	}
+	llvm::Value* bits = builder->CreateBitCast(mask, builder->getIntNTy(lanes), "Mask");
+	if(equal) {
+		return builder->CreateICmpEQ(bits, llvm::Constant::getAllOnesValue(bits->getType()), "All");
+	}
+	return builder->CreateICmpNE(bits, llvm::Constant::getNullValue(bits->getType()), "Any");
 }
 
 
-llvm::Value* EqualityExpr::Emit() {
-	llvm::Value* l = left->Emit();
-	llvm::Value* r = right->Emit();
+/* Function: SwizzleLanes()
+ * ------------------------
+ * Translates a swizzle such as "xy" or "wzyx" on base into the vector
+ * lanes it selects.  Returns false if the field is not a valid swizzle
+ * of base's type, after reporting the error unless quiet is set.
+ */
+static bool SwizzleLanes(Identifier *field, Expr *base, vector<int> *lanes, bool quiet = false) {
+	const char *name = field->GetName();
+	int width = VectorSize(base->GetType());
 
-	if(left->GetType() == Type::intType && right->GetType() == Type::intType) {
-		this->type = Type::boolType;
-		llvm::CmpInst::Predicate pred;
-		if(op->IsOp("==")) {
-			pred = llvm::ICmpInst::ICMP_EQ;
+	if(width == 0) {
+		if(!quiet) ReportError::InaccessibleSwizzle(field, base);
+		return false;
+	}
+	if(strlen(name) > 4) {
+		if(!quiet) ReportError::OversizedVector(field, base);
+		return false;
+	}
 
-			return llvm::CmpInst::Create(llvm::CmpInst::ICmp, pred, l, r, "IEQ", irgen->GetBasicBlock());
+	lanes->clear();
+	for(int i = 0; name[i] != '\0'; i++) {
+		const char *lane = strchr("xyzw", name[i]);
+		if(lane == NULL) {
+			if(!quiet) ReportError::InvalidSwizzle(field, base);
+			return false;
 		}
-		else if(op->IsOp("!=")) {
-			pred = llvm::ICmpInst::ICMP_NE;	
-
-			return llvm::CmpInst::Create(llvm::CmpInst::ICmp, pred, l, r, "INEQ", irgen->GetBasicBlock());
+		if(lane - "xyzw" >= width) {
+			if(!quiet) ReportError::SwizzleOutOfBound(field, base);
+			return false;
 		}
-
+		lanes->push_back(lane - "xyzw");
 	}
-	else if(left->GetType() == Type::floatType && right->GetType() == Type::floatType) {
-		this->type = Type::boolType;
-		llvm::CmpInst::Predicate pred;
-		if(op->IsOp("==")) {
-			pred = llvm::FCmpInst::FCMP_OEQ;
+	return true;
+}
 
-			return llvm::CmpInst::Create(llvm::CmpInst::FCmp, pred, l, r, "FEQ", irgen->GetBasicBlock());
+/* Function: LaneMask()
+ * --------------------
+ * Builds a shufflevector mask; a negative lane is left undefined.
+ */
+static llvm::Constant* LaneMask(const vector<int> &lanes) {
+	vector<llvm::Constant*> mask;
+	for(unsigned int i = 0; i < lanes.size(); i++) {
+		if(lanes[i] < 0) {
+			mask.push_back(llvm::UndefValue::get(Node::irgen->GetIntType()));
 		}
-		else if(op->IsOp("!=")) {
-			pred = llvm::FCmpInst::FCMP_ONE;
-
-			return llvm::CmpInst::Create(llvm::CmpInst::FCmp, pred, l, r, "FNEQ", irgen->GetBasicBlock());
+		else {
+			mask.push_back(llvm::ConstantInt::get(Node::irgen->GetIntType(), lanes[i]));
 		}
 	}
-	else if(left->GetType() == Type::boolType && right->GetType() == Type::boolType) {
-		this->type = Type::boolType;
-		llvm::CmpInst::Predicate pred;
-		if(op->IsOp("==")) {
-			pred = llvm::ICmpInst::ICMP_EQ;
+	return llvm::ConstantVector::get(mask);
+}
 
-			return llvm::CmpInst::Create(llvm::CmpInst::ICmp, pred, l, r, "IEQ", irgen->GetBasicBlock());
-		}
-		else if(op->IsOp("!=")) {
-			pred = llvm::ICmpInst::ICMP_NE;	
+/* Function: EmitSwizzle()
+ * -----------------------
+ * Selects lanes of the vector value vec: one lane as a scalar, more as
+ * a vector.
+ */
+static llvm::Value* EmitSwizzle(llvm::Value *vec, const vector<int> &lanes) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
 
-			return llvm::CmpInst::Create(llvm::CmpInst::ICmp, pred, l, r, "INEQ", irgen->GetBasicBlock());
-		}
+	if(lanes.size() == 1) {
+		return builder->CreateExtractElement(vec, builder->getInt32(lanes[0]), "Field Access");
 	}
+	return builder->CreateShuffleVector(vec, llvm::UndefValue::get(vec->getType()), LaneMask(lanes), "Shuffle Vector");
+}
 
-	return NULL;
+/* Function: IsAssignable()
+ * ------------------------
+ * A const variable, or a swizzle that names a lane twice such as v.xx,
+ * can be read but not written.  Reports an error for one used as an
+ * assignment target.
+ */
+static bool IsAssignable(Expr *target, const LValueRef &ref) {
+	if(ref.readOnly) {
+		ReportError::Formatted(target->GetLocation(), "cannot assign to a const variable");
+		return false;
+	}
+	for(unsigned int i = 0; i < ref.lanes.size(); i++) {
+		for(unsigned int j = i + 1; j < ref.lanes.size(); j++) {
+			if(ref.lanes[i] == ref.lanes[j]) {
+				ReportError::Formatted(target->GetLocation(), "swizzle assigns to a vector component more than once");
+				return false;
+			}
+		}
+	}
+	return true;
 }
 
+/* Function: Splat()
+ * -----------------
+ * Broadcasts a scalar to every lane of an n-lane vector, so it can be
+ * combined with a vector in one instruction.
+ */
+static llvm::Value* Splat(llvm::Value *scalar, int n) {
+	return Node::irgen->GetBuilder()->CreateVectorSplat(n, scalar, "Splat");
+}
 
-llvm::Value* ArithmeticExpr::Emit() {
+/* Function: MatrixSize()
+ * -----------------------
+ * Returns N for a matN type, 0 for anything else.
+ */
+static int MatrixSize(Type *type) {
+	if(type == Type::mat2Type) return 2;
+	if(type == Type::mat3Type) return 3;
+	if(type == Type::mat4Type) return 4;
+	return 0;
+}
 
-	if(left == NULL) {
-		llvm::Value* r = right->Emit();
+/* Function: ElementType()
+ * -----------------------
+ * The type of base[i]: an array's element type, or a column of a
+ * matrix.  count is set to the number of elements that can be indexed.
+ * Returns NULL if the type cannot be indexed.
+ */
+static Type* ElementType(Type *type, int *count) {
+	ArrayType* arrayType = dynamic_cast<ArrayType*>(type);
+	if(arrayType != NULL) {
+		*count = arrayType->GetElemCount();
+		return arrayType->GetElemType();
+	}
+	*count = MatrixSize(type);
+	return *count != 0 ? VectorOf(Type::floatType, *count) : NULL;
+}
 
-		if(right->GetType() == Type::intType) {
-			this->type = Type::intType;
+/* Function: EmitIntrinsic()
+ * -------------------------
+ * Calls the LLVM intrinsic id, overloaded on the type of the first
+ * argument.  Intrinsics are lowered by the backend to single
+ * instructions wherever the target has one, on every lane of a vector.
+ */
+static llvm::Value* EmitIntrinsic(llvm::Intrinsic::ID id, llvm::ArrayRef<llvm::Value*> args, const char *name) {
+	llvm::Function* fn = llvm::Intrinsic::getDeclaration(Node::irgen->GetOrCreateModule("Program_Module.bc"), id, args[0]->getType());
+	return Node::irgen->GetBuilder()->CreateCall(fn, args, name);
+}
 
-			if(op->IsOp("++")) {
-				llvm::Value *val = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-				llvm::Value *inst = llvm::BinaryOperator::CreateAdd(r, val, "IInc", irgen->GetBasicBlock());
+/* Function: EmitMulAdd()
+ * ----------------------
+ * a * b + c: one llvm.fmuladd when contraction is on, otherwise a
+ * multiply and an add, each rounded.
+ */
+static llvm::Value* EmitMulAdd(llvm::Value *a, llvm::Value *b, llvm::Value *c, const char *name) {
+	if(IRGenerator::GetContraction() == IRGenerator::ContractOff) {
+		llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+		return builder->CreateFAdd(builder->CreateFMul(a, b, "FMul"), c, name);
+	}
+	llvm::Value *args[] = { a, b, c };
+	return EmitIntrinsic(llvm::Intrinsic::fmuladd, args, name);
+}
 
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(right);
+/* Function: EmitMatrixVector()
+ * ----------------------------
+ * Emits m * v.  Matrices are stored as columns, so the product is the
+ * sum of every column scaled by the matching lane of v: one multiply
+ * and N-1 multiply-adds on whole vectors, with no horizontal adds.
+ */
+static llvm::Value* EmitMatrixVector(llvm::Value *m, llvm::Value *v) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	int n = m->getType()->getArrayNumElements();
 
-				llvm::Value* ret = new llvm::StoreInst(inst, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
+	llvm::Value *sum = NULL;
+	for(int j = 0; j < n; j++) {
+		llvm::Value *column = builder->CreateExtractValue(m, j, "Column");
+		llvm::Value *lane = EmitSwizzle(v, vector<int>(n, j));
+		if(sum == NULL) {
+			sum = builder->CreateFMul(column, lane, "FMul");
+		}
+		else {
+			sum = EmitMulAdd(column, lane, sum, "FMulAdd");
+		}
+	}
+	return sum;
+}
 
+/* Function: EmitTranspose()
+ * -------------------------
+ * Transposes a matrix with shuffles.  A 4x4 matrix takes the usual
+ * eight: interleave pairs of columns, then take halves of the pairs.
+ * Other sizes gather each row one column at a time.
+ */
+static llvm::Value* EmitTranspose(llvm::Value *m) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	int n = m->getType()->getArrayNumElements();
+	vector<llvm::Value*> cols, rows;
 
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
+	for(int j = 0; j < n; j++) {
+		cols.push_back(builder->CreateExtractValue(m, j, "Column"));
+	}
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
+	if(n == 4) {
+		static const int lo[] = { 0, 4, 1, 5 }, hi[] = { 2, 6, 3, 7 };
+		static const int first[] = { 0, 1, 4, 5 }, second[] = { 2, 3, 6, 7 };
+		vector<int> loMask(lo, lo + 4), hiMask(hi, hi + 4);
+		vector<int> firstMask(first, first + 4), secondMask(second, second + 4);
+
+		llvm::Value *t0 = builder->CreateShuffleVector(cols[0], cols[1], LaneMask(loMask), "Unpack");
+		llvm::Value *t1 = builder->CreateShuffleVector(cols[2], cols[3], LaneMask(loMask), "Unpack");
+		llvm::Value *t2 = builder->CreateShuffleVector(cols[0], cols[1], LaneMask(hiMask), "Unpack");
+		llvm::Value *t3 = builder->CreateShuffleVector(cols[2], cols[3], LaneMask(hiMask), "Unpack");
+		rows.push_back(builder->CreateShuffleVector(t0, t1, LaneMask(firstMask), "Row"));
+		rows.push_back(builder->CreateShuffleVector(t0, t1, LaneMask(secondMask), "Row"));
+		rows.push_back(builder->CreateShuffleVector(t2, t3, LaneMask(firstMask), "Row"));
+		rows.push_back(builder->CreateShuffleVector(t2, t3, LaneMask(secondMask), "Row"));
+	}
+	else {
+		for(int i = 0; i < n; i++) {
+			// lanes below j are already in place; lane j comes from
+			// lane i of column j
+			llvm::Value *row = cols[0];
+			for(int j = 1; j < n; j++) {
+				vector<int> mask(n, -1);
+				for(int k = 0; k < j; k++) {
+					mask[k] = j == 1 ? i : k;
+				}
+				mask[j] = n + i;
+				row = builder->CreateShuffleVector(row, cols[j], LaneMask(mask), "Row");
 			}
-			else if(op->IsOp("--")) {
-				llvm::Value *val = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-				llvm::Value *inst = llvm::BinaryOperator::CreateSub(r, val, "IDec", irgen->GetBasicBlock());
-
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(right);
+			rows.push_back(row);
+		}
+	}
 
-				new llvm::StoreInst(inst, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
+	llvm::Value *result = llvm::UndefValue::get(m->getType());
+	for(int i = 0; i < n; i++) {
+		result = builder->CreateInsertValue(result, rows[i], i, "Transpose");
+	}
+	return result;
+}
 
+static llvm::Value* EmitMatrixArithmetic(char op, llvm::Value *l, llvm::Value *r);
 
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
+/* Function: EmitArithmetic()
+ * --------------------------
+ * Emits l op r, where op is one of + - * / or < > for the shifts, and
+ * the operands are scalars, vectors or matrices.  A scalar combined with
+ * a vector is splatted first, so vector math always takes a single
+ * instruction for all the lanes.  isUnsigned selects unsigned division
+ * and right shift for integers.  Returns NULL if the operand types
+ * cannot be combined.
+ */
+static llvm::Value* EmitArithmetic(char op, llvm::Value *l, llvm::Value *r, bool isUnsigned = false) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	llvm::Type *lt = l->getType(), *rt = r->getType();
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
+	if(lt->isArrayTy() || rt->isArrayTy()) {
+		return EmitMatrixArithmetic(op, l, r);
+	}
+	if(lt->isVectorTy() && !rt->isVectorTy()) {
+		r = Splat(r, lt->getVectorNumElements());
+	}
+	else if(rt->isVectorTy() && !lt->isVectorTy()) {
+		l = Splat(l, rt->getVectorNumElements());
+	}
+	if(l->getType() != r->getType()) {
+		return NULL;
+	}
 
-			}
-			else if(op->IsOp("+")) {
-				return r;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value *val = llvm::ConstantInt::get(irgen->GetIntType(), -1);
-				return llvm::BinaryOperator::CreateMul(r, val, "IMul", irgen->GetBasicBlock());
-			}
+	if(l->getType()->getScalarType()->isFloatingPointTy()) {
+		switch(op) {
+			case '+': return builder->CreateFAdd(l, r, "FAdd");
+			case '-': return builder->CreateFSub(l, r, "FSub");
+			case '*': return builder->CreateFMul(l, r, "FMul");
+			case '/': return builder->CreateFDiv(l, r, "FDiv");
+		}
+	}
+	else if(l->getType()->getScalarType()->isIntegerTy(32)) {
+		switch(op) {
+			case '+': return builder->CreateAdd(l, r, "Add");
+			case '-': return builder->CreateSub(l, r, "Sub");
+			case '*': return builder->CreateMul(l, r, "Mul");
+			case '/': return isUnsigned ? builder->CreateUDiv(l, r, "UDiv") : builder->CreateSDiv(l, r, "Div");
+			case '<': return builder->CreateShl(l, r, "Shl");
+			case '>': return isUnsigned ? builder->CreateLShr(l, r, "LShr") : builder->CreateAShr(l, r, "AShr");
 		}
-		else if(right->GetType() == Type::floatType) {
-			this->type = Type::floatType;
+	}
+	return NULL;
+}
 
-			if(op->IsOp("++")) {
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-				llvm::Value* inst = llvm::BinaryOperator::CreateFAdd(r, val, "FInc", irgen->GetBasicBlock());
+/* Function: EmitMatrixArithmetic()
+ * --------------------------------
+ * Emits l op r where at least one operand is a matrix.  * is the linear
+ * algebra product when the other operand is a vector or matrix; every
+ * other combination works column by column, splatting a scalar operand.
+ */
+static llvm::Value* EmitMatrixArithmetic(char op, llvm::Value *l, llvm::Value *r) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	llvm::Type *lt = l->getType(), *rt = r->getType();
+	llvm::Type *matrixTy = lt->isArrayTy() ? lt : rt;
+	llvm::Type *columnTy = matrixTy->getArrayElementType();
+	int n = matrixTy->getArrayNumElements();
+
+	if((lt->isArrayTy() && rt->isArrayTy() && lt != rt) || (lt->isVectorTy() && lt != columnTy) || (rt->isVectorTy() && rt != columnTy)) {
+		return NULL;
+	}
+	if(op == '*' && lt->isArrayTy() && rt->isVectorTy()) {
+		return EmitMatrixVector(l, r);
+	}
+	if(op == '*' && lt->isVectorTy()) {
+		// v * m multiplies by the rows of m
+		return EmitMatrixVector(EmitTranspose(r), l);
+	}
+	if(lt->isVectorTy() || rt->isVectorTy()) {
+		return NULL;
+	}
 
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(right);
+	llvm::Value *result = llvm::UndefValue::get(matrixTy);
+	for(int j = 0; j < n; j++) {
+		llvm::Value *column;
+		if(op == '*' && lt->isArrayTy() && rt->isArrayTy()) {
+			column = EmitMatrixVector(l, builder->CreateExtractValue(r, j, "Column"));
+		}
+		else {
+			llvm::Value *lc = lt->isArrayTy() ? builder->CreateExtractValue(l, j, "Column") : l;
+			llvm::Value *rc = rt->isArrayTy() ? builder->CreateExtractValue(r, j, "Column") : r;
+			column = EmitArithmetic(op, lc, rc);
+		}
+		if(column == NULL) {
+			return NULL;
+		}
+		result = builder->CreateInsertValue(result, column, j, "Matrix");
+	}
+	return result;
+}
 
-				new llvm::StoreInst(inst, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
+/* Function: ArithmeticOp()
+ * ------------------------
+ * The arithmetic done by an operator: '+' for both + and +=, and so on.
+ */
+static char ArithmeticOp(Operator *op) {
+	if(op->IsOp("+") || op->IsOp("+=")) return '+';
+	if(op->IsOp("-") || op->IsOp("-=")) return '-';
+	if(op->IsOp("*") || op->IsOp("*=")) return '*';
+	if(op->IsOp("/") || op->IsOp("/=")) return '/';
+	if(op->IsOp("<<")) return '<';
+	if(op->IsOp(">>")) return '>';
+	return '\0';
+}
 
+/* Function: ArithmeticType()
+ * --------------------------
+ * The type of l op r: the vector operand's type if there is one, since
+ * a matrix times a vector is a vector, and otherwise the matrix's.
+ */
+static Type* ArithmeticType(char op, Type *l, Type *r) {
+	// a shift's value has the type of the value shifted
+	if(op == '<' || op == '>') {
+		return l;
+	}
+	if(VectorSize(r) != 0 || (MatrixSize(r) != 0 && VectorSize(l) == 0)) {
+		return r;
+	}
+	return l;
+}
 
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
+/* Function: EmitIncrement()
+ * -------------------------
+ * Emits val + 1 or val - 1 for the ++ and -- operators, on every lane
+ * of a vector.
+ */
+static llvm::Value* EmitIncrement(Operator *op, llvm::Value *val) {
+	llvm::Type *ty = val->getType();
+	llvm::Value *one;
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(op->IsOp("--")) {
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-				llvm::Value* inst = llvm::BinaryOperator::CreateFSub(r, val, "FDec", irgen->GetBasicBlock());
+	// a matrix is incremented a column at a time, by a scalar one
+	if(ty->isArrayTy()) {
+		ty = ty->getArrayElementType()->getScalarType();
+	}
+	if(ty->getScalarType()->isFloatingPointTy()) {
+		one = llvm::ConstantFP::get(ty, 1);
+	}
+	else {
+		one = llvm::ConstantInt::get(ty, 1);
+	}
+	return EmitArithmetic(op->IsOp("++") ? '+' : '-', val, one);
+}
+
+/* Function: LaneAddress()
+ * ------------------------
+ * The address of the one lane a swizzle such as v.y selects, so it can
+ * be loaded or stored without the rest of the vector; NULL unless it is
+ * a lane of a global or array element.  A local vector is left whole
+ * so it is still promoted to a register, and a bvec's lanes are bits,
+ * which have no address.
+ */
+llvm::Value* LValueRef::LaneAddress() {
+	llvm::Type *vecTy = addr->getType()->getPointerElementType();
+	if(lanes.size() != 1 || whole != NULL || llvm::isa<llvm::AllocaInst>(addr) ||
+	   !vecTy->isVectorTy() || vecTy->getVectorElementType()->isIntegerTy(1)) {
+		return NULL;
+	}
 
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(right);
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	llvm::Value *scalars = builder->CreateBitCast(addr, vecTy->getVectorElementType()->getPointerTo(), "Lanes");
+	return builder->CreateConstGEP1_32(scalars, lanes[0], "Lane");
+}
 
-				new llvm::StoreInst(inst, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
+llvm::Value* LValueRef::Load() {
+	if(lanes.empty()) {
+		return Node::irgen->EmitLoad(addr, type, "Load");
+	}
+	llvm::Value *lane = LaneAddress();
+	if(lane != NULL) {
+		return Node::irgen->EmitLoad(lane, NULL, "Load Lane");
+	}
+	// a swizzle selects from the vector as stored, padding and all
+	if(whole == NULL) {
+		whole = Node::irgen->EmitLoad(addr, NULL, "Load Vector");
+	}
+	return EmitSwizzle(whole, lanes);
+}
 
+void LValueRef::Store(llvm::Value *val) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
 
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
+	if(lanes.empty()) {
+		Node::irgen->EmitStore(val, addr);
+		return;
+	}
+	llvm::Value *lane = LaneAddress();
+	if(lane != NULL) {
+		Node::irgen->EmitStore(val, lane);
+		return;
+	}
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
+	llvm::Value *vec = whole;
+	if(vec == NULL) {
+		vec = Node::irgen->EmitLoad(addr, NULL, "Load Vector");
+	}
 
+	if(lanes.size() == 1) {
+		vec = builder->CreateInsertElement(vec, val, builder->getInt32(lanes[0]), "Insert Element");
+	}
+	else {
+		// blend the new lanes into the vector with one shuffle; both
+		// shuffle operands must be the same width, so a narrower value
+		// is widened first (which the backend folds into the blend)
+		int width = vec->getType()->getVectorNumElements();
+		int count = lanes.size();
+		if(count != width) {
+			vector<int> widen;
+			for(int i = 0; i < width; i++) {
+				widen.push_back(i < count ? i : -1);
 			}
-			else if(op->IsOp("+")) {
-				return r;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), -1);
-				return llvm::BinaryOperator::CreateFMul(r, val, "FMul", irgen->GetBasicBlock());
-			}
+			val = builder->CreateShuffleVector(val, llvm::UndefValue::get(val->getType()), LaneMask(widen), "Widen");
 		}
-		else if(right->GetType() == Type::vec2Type) {
-			this->type = Type::vec2Type;
 
-			if(op->IsOp("++")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
+		vector<int> blend;
+		for(int i = 0; i < width; i++) {
+			blend.push_back(i);
+		}
+		for(int i = 0; i < count; i++) {
+			blend[lanes[i]] = width + i;
+		}
+		vec = builder->CreateShuffleVector(vec, val, LaneMask(blend), "Swizzle Store");
+	}
+	Node::irgen->EmitStore(vec, addr);
+	whole = vec;
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, val, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, val, "FAdd", irgen->GetBasicBlock());
+/* Function: IsProduct()
+ * ---------------------
+ * Whether e is a binary multiplication, whose value EmitContracted can
+ * fuse into the addition or subtraction that uses it.
+ */
+static bool IsProduct(Expr *e) {
+	ArithmeticExpr* product = dynamic_cast<ArithmeticExpr*>(e);
+	return product != NULL && product->GetLeft() != NULL && product->GetOp()->IsOp("*");
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
+/* Function: EmitContracted()
+ * --------------------------
+ * Under -ffp-contract=on or fast, emits product op other, or other op
+ * product if productFirst is false, as one llvm.fmuladd, where product
+ * is the float multiply a child expression has just emitted; the
+ * multiply is deleted.  Returns NULL, having emitted nothing, if the
+ * two cannot be fused (a matrix or integer product, say).
+ */
+static llvm::Value* EmitContracted(char op, llvm::Value *product, llvm::Value *other, bool productFirst) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	llvm::BinaryOperator* mul = llvm::dyn_cast<llvm::BinaryOperator>(product);
+	if(mul == NULL || mul->getOpcode() != llvm::Instruction::FMul || !mul->use_empty()) {
+		return NULL;
+	}
+	if(other->getType() != product->getType()) {
+		if(!product->getType()->isVectorTy() || other->getType() != product->getType()->getScalarType()) {
+			return NULL;
+		}
+		other = Splat(other, product->getType()->getVectorNumElements());
+	}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+	// c - a*b is (-a)*b + c and a*b - c is a*b + (-c): negation is exact
+	llvm::Value* a = mul->getOperand(0);
+	llvm::Value* b = mul->getOperand(1);
+	if(op == '-' && productFirst) {
+		other = builder->CreateFNeg(other, "FNeg");
+	}
+	else if(op == '-') {
+		a = builder->CreateFNeg(a, "FNeg");
+	}
+	mul->eraseFromParent();
 
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(right);
+	llvm::Value* args[] = { a, b, other };
+	return EmitIntrinsic(llvm::Intrinsic::fmuladd, args, "FMulAdd");
+}
 
-				new llvm::StoreInst(newVec2, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
+llvm::Value* ArithmeticExpr::Emit() {
 
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
+	if(left == NULL) {
+		if(op->IsOp("++") || op->IsOp("--")) {
+			LValue* target = dynamic_cast<LValue*>(right);
+			LValueRef ref;
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
+			if(target == NULL || !target->EmitLValue(&ref) || !IsAssignable(right, ref)) {
+				return NULL;
 			}
-			else if(op->IsOp("--")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
+			this->type = right->GetType();
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, val, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, val, "FSub", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(right);
+			llvm::Value* newVal = EmitIncrement(op, ref.Load());
+			ref.Store(newVal);
+			return newVal;
+		}
 
-				new llvm::StoreInst(newVec2, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
+		if(!valueUsed) {
+			return EmitOperandsForEffect();
+		}
 
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
+		llvm::Value* r = right->Emit();
+		this->type = right->GetType();
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
+		if(op->IsOp("+")) {
+			return r;
+		}
+		else if(op->IsOp("-")) {
+			if(r->getType()->isArrayTy()) {
+				return EmitArithmetic('-', llvm::ConstantFP::get(irgen->GetFloatType(), -0.0), r);
 			}
-			else if(op->IsOp("+")) {
-				return r;
+			if(r->getType()->getScalarType()->isFloatingPointTy()) {
+				return irgen->GetBuilder()->CreateFNeg(r, "FNeg");
 			}
-			else if(op->IsOp("-")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), -1);
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(x, val, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(y, val, "FMul", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+			return irgen->GetBuilder()->CreateNeg(r, "Neg");
+		}
+	}
+	else {
+		if(!valueUsed) {
+			return EmitOperandsForEffect();
+		}
 
-				return newVec2;
+		llvm::Value* l = left->Emit();
+		llvm::Value* r = right->Emit();
+		llvm::Value* val = NULL;
+		if(l != NULL && r != NULL && (op->IsOp("+") || op->IsOp("-")) && IRGenerator::GetContraction() != IRGenerator::ContractOff) {
+			if(IsProduct(right)) {
+				val = EmitContracted(ArithmeticOp(op), r, l, false);
+			}
+			if(val == NULL && IsProduct(left)) {
+				val = EmitContracted(ArithmeticOp(op), l, r, true);
 			}
 		}
-		else if(right->GetType() == Type::vec3Type) {
-			this->type = Type::vec3Type;
-
-			if(op->IsOp("++")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, val, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, val, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(z, val, "FAdd", irgen->GetBasicBlock());
+		if(val == NULL) {
+			val = EmitArithmetic(ArithmeticOp(op), l, r, IsUnsignedArithmetic(ArithmeticOp(op), left->GetType(), right->GetType()));
+		}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
+		if(val != NULL) {
+			this->type = ArithmeticType(ArithmeticOp(op), left->GetType(), right->GetType());
+		}
+		return val;
+	}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+	return NULL;
+}
 
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(right);
+llvm::Constant* ArithmeticExpr::Fold() {
+	if(op->IsOp("++") || op->IsOp("--")) {
+		return NULL;
+	}
 
-				new llvm::StoreInst(newVec3, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(op->IsOp("--")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, val, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, val, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFSub(z, val, "FSub", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
+	llvm::Constant* r = right->Fold();
+	if(r == NULL || r->getType()->isArrayTy()) {
+		// matrix math needs instructions, so it is never folded
+		return NULL;
+	}
+	if(left == NULL) {
+		this->type = right->GetType();
+		if(op->IsOp("-")) {
+			return r->getType()->getScalarType()->isFloatingPointTy() ? llvm::ConstantExpr::getFNeg(r) : llvm::ConstantExpr::getNeg(r);
+		}
+		return r;
+	}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+	llvm::Constant* l = left->Fold();
+	if(l == NULL || l->getType()->isArrayTy()) {
+		return NULL;
+	}
+	// an integer division by zero is left for run time
+	if(ArithmeticOp(op) == '/' && r->getType()->getScalarType()->isIntegerTy() && r->isNullValue()) {
+		return NULL;
+	}
 
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(right);
+	llvm::Value* val = EmitArithmetic(ArithmeticOp(op), l, r, IsUnsignedArithmetic(ArithmeticOp(op), left->GetType(), right->GetType()));
+	if(val == NULL) {
+		return NULL;
+	}
+	this->type = ArithmeticType(ArithmeticOp(op), left->GetType(), right->GetType());
+	return llvm::dyn_cast<llvm::Constant>(val);
+}
 
-				new llvm::StoreInst(newVec3, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
+bool ArithmeticExpr::IsPure() {
+	if(op->IsOp("++") || op->IsOp("--")) {
+		return false;
+	}
+	// types are only known after Emit, so any division by a divisor that
+	// is not a known nonzero constant is treated as one that may trap
+	if(ArithmeticOp(op) == '/') {
+		llvm::Constant* divisor = right->Fold();
+		if(divisor == NULL || divisor->isNullValue()) {
+			return false;
+		}
+	}
+	return (left == NULL || left->IsPure()) && right->IsPure();
+}
 
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
+int ArithmeticExpr::Cost() {
+	int cost = (left ? left->Cost() : 0) + right->Cost();
+	return cost + (ArithmeticOp(op) == '/' ? 8 : 1);
+}
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(op->IsOp("+")) {
-				return r;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
+llvm::Value* PostfixExpr::Emit() {
+	LValue* target = dynamic_cast<LValue*>(left);
+	LValueRef ref;
 
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), -1);
+	if(target == NULL || !target->EmitLValue(&ref) || !IsAssignable(left, ref)) {
+		return NULL;
+	}
+	this->type = left->GetType();
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(x, val, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(y, val, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFMul(z, val, "FMul", irgen->GetBasicBlock());
+	llvm::Value* oldVal = ref.Load();
+	ref.Store(EmitIncrement(op, oldVal));
+	return oldVal;
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
+llvm::Value* AssignExpr::Emit() {
+	llvm::Value* r = right->Emit();
+	LValue* target = dynamic_cast<LValue*>(left);
+	LValueRef ref;
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+	if(target == NULL || !target->EmitLValue(&ref) || !IsAssignable(left, ref)) {
+		return NULL;
+	}
+	this->type = left->GetType();
 
-				return newVec3;
-			}
+	llvm::Value* newVal = r;
+	if(!op->IsOp("=")) {
+		// +=, -=, *= and /=: the target is read and written through
+		// the same address; x += a*b contracts like x + a*b
+		llvm::Value* oldVal = ref.Load();
+		newVal = NULL;
+		if(r != NULL && (op->IsOp("+=") || op->IsOp("-=")) && IsProduct(right) && IRGenerator::GetContraction() != IRGenerator::ContractOff) {
+			newVal = EmitContracted(ArithmeticOp(op), r, oldVal, false);
 		}
-		else if(right->GetType() == Type::vec4Type) {
-			this->type = Type::vec4Type;
-
-			if(op->IsOp("++")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
+		if(newVal == NULL) {
+			newVal = EmitArithmetic(ArithmeticOp(op), oldVal, r, IsUnsigned(left->GetType()));
+		}
+	}
+	if(newVal == NULL) {
+		return NULL;
+	}
 
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
+	ref.Store(newVal);
+	return newVal;
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, val, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, val, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(z, val, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFAdd(w, val, "FAdd", irgen->GetBasicBlock());
+CompoundExpr::CompoundExpr(Expr *l, Operator *o, Expr *r) 
+	: Expr(Join(l->GetLocation(), r->GetLocation())) {
+		Assert(l != NULL && o != NULL && r != NULL);
+		(op=o)->SetParent(this);
+		(left=l)->SetParent(this); 
+		(right=r)->SetParent(this);
+	}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+CompoundExpr::CompoundExpr(Operator *o, Expr *r) 
+	: Expr(Join(o->GetLocation(), r->GetLocation())) {
+		Assert(o != NULL && r != NULL);
+		left = NULL; 
+		(op=o)->SetParent(this);
+		(right=r)->SetParent(this);
+	}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+CompoundExpr::CompoundExpr(Expr *l, Operator *o) 
+	: Expr(Join(l->GetLocation(), o->GetLocation())) {
+		Assert(l != NULL && o != NULL);
+		(left=l)->SetParent(this);
+		(op=o)->SetParent(this);
+	}
 
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(right);
+void CompoundExpr::PrintChildren(int indentLevel) {
+	if (left) left->Print(indentLevel+1);
+	op->Print(indentLevel+1);
+	if (right) right->Print(indentLevel+1);
+}
 
-				new llvm::StoreInst(newVec4, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
+void CompoundExpr::GetChildren(vector<Node*> *children) {
+	if(left != NULL) {
+		children->push_back(left);
+	}
+	children->push_back(right);
+}
 
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
+/* Function: EmitOperandsForEffect()
+ * ---------------------------------
+ * Emits an operator whose value is unused: only the side effects of its
+ * operands are needed, so their values are unused too.
+ */
+llvm::Value* CompoundExpr::EmitOperandsForEffect() {
+	if(left != NULL) {
+		left->DiscardValue();
+		left->Emit();
+	}
+	right->DiscardValue();
+	right->Emit();
+	return NULL;
+}
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(op->IsOp("--")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
+ConditionalExpr::ConditionalExpr(Expr *c, Expr *t, Expr *f)
+	: Expr(Join(c->GetLocation(), f->GetLocation())) {
+		Assert(c != NULL && t != NULL && f != NULL);
+		(cond=c)->SetParent(this);
+		(trueExpr=t)->SetParent(this);
+		(falseExpr=f)->SetParent(this);
+	}
 
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
+void ConditionalExpr::PrintChildren(int indentLevel) {
+	cond->Print(indentLevel+1, "(cond) ");
+	trueExpr->Print(indentLevel+1, "(true) ");
+	falseExpr->Print(indentLevel+1, "(false) ");
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, val, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, val, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFSub(z, val, "FSub", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFSub(w, val, "FSub", irgen->GetBasicBlock());
+void ConditionalExpr::GetChildren(vector<Node*> *children) {
+	children->push_back(cond);
+	children->push_back(trueExpr);
+	children->push_back(falseExpr);
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+bool ArrayAccess::EmitLValue(LValueRef *ref) {
+	LValue* target = dynamic_cast<LValue*>(base);
+	LValueRef baseRef;
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+	if(target == NULL || !target->EmitLValue(&baseRef) || !baseRef.lanes.empty()) {
+		return false;
+	}
 
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(right);
+	int count;
+	Type* elemType = ElementType(base->GetType(), &count);
+	if(elemType != NULL) {
+		this->type = elemType;
+	}
 
-				new llvm::StoreInst(newVec4, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
+	llvm::Value* num = subscript->Emit();
 
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
+	llvm::Value* indices[] = { irgen->GetBuilder()->getInt32(0), num };
+	ref->addr = irgen->GetBuilder()->CreateGEP(baseRef.addr, indices, "Array Access");
+	ref->type = elemType != NULL ? irgen->ast_llvm(elemType, irgen->GetContext()) : NULL;
+	ref->readOnly = baseRef.readOnly;
+	return true;
+}
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(op->IsOp("+")) {
-				return r;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
+llvm::Constant* ArrayAccess::Fold() {
+	llvm::Constant* array = base->Fold();
+	int count;
+	Type* elemType = ElementType(base->GetType(), &count);
+	if(array == NULL || elemType == NULL) {
+		return NULL;
+	}
 
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), -1);
+	// an element of a const array indexed by a constant in range
+	llvm::ConstantInt* index = llvm::dyn_cast_or_null<llvm::ConstantInt>(subscript->Fold());
+	if(index == NULL || index->getSExtValue() < 0 || index->getSExtValue() >= count) {
+		return NULL;
+	}
+	this->type = elemType;
+	return array->getAggregateElement(index->getZExtValue());
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(x, val, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(y, val, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFMul(z, val, "FMul", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFMul(w, val, "FMul", irgen->GetBasicBlock());
+bool ArrayAccess::IsPure() {
+	// only an index known to be in bounds is safe to load early
+	int count;
+	Type* elemType = ElementType(base->GetType(), &count);
+	llvm::ConstantInt* index = llvm::dyn_cast_or_null<llvm::ConstantInt>(subscript->Fold());
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+	if(elemType == NULL || index == NULL || !base->IsPure()) {
+		return false;
+	}
+	return index->getSExtValue() >= 0 && index->getSExtValue() < count;
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+llvm::Value* ArrayAccess::Emit() {
+	LValueRef ref;
 
-				return newVec4;
-			}
-		}
+	if(!valueUsed) {
+		base->DiscardValue();
+		base->Emit();
+		subscript->DiscardValue();
+		subscript->Emit();
+		return NULL;
 	}
-	else if(left != NULL) {
-		llvm::Value* l = left->Emit();
-		llvm::Value* r = right->Emit();
 
-		if(left->GetType() == Type::vec2Type && right->GetType() == Type::floatType) {
-			this->type = Type::vec2Type;
-
-			if(op->IsOp("+")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+	llvm::Constant* folded = Fold();
+	if(folded != NULL) {
+		return folded;
+	}
 
-				llvm::Value* addx = llvm::BinaryOperator::CreateFAdd(x, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* addy = llvm::BinaryOperator::CreateFAdd(y, r, "FAdd", irgen->GetBasicBlock());
+	// a column of a matrix that was computed rather than loaded, such
+	// as (a * b)[0], is taken straight out of the value
+	if(dynamic_cast<LValue*>(base) == NULL) {
+		llvm::Value* value = base->Emit();
+		llvm::ConstantInt* index = llvm::dyn_cast_or_null<llvm::ConstantInt>(subscript->Fold());
+		int count;
+		Type* elemType = ElementType(base->GetType(), &count);
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
+		if(value == NULL || elemType == NULL || index == NULL || index->getSExtValue() < 0 || index->getSExtValue() >= count) {
+			return NULL;
+		}
+		this->type = elemType;
+		return irgen->GetBuilder()->CreateExtractValue(value, index->getZExtValue(), "Column");
+	}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, addx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, addy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+	if(!EmitLValue(&ref)) {
+		return NULL;
+	}
+	return ref.Load();
+}
 
-				return newVec2;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+ArrayAccess::ArrayAccess(yyltype loc, Expr *b, Expr *s) : LValue(loc) {
+	(base=b)->SetParent(this); 
+	(subscript=s)->SetParent(this);
+}
 
-				llvm::Value* subx = llvm::BinaryOperator::CreateFSub(x, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* suby = llvm::BinaryOperator::CreateFSub(y, r, "FSub", irgen->GetBasicBlock());
+void ArrayAccess::PrintChildren(int indentLevel) {
+	base->Print(indentLevel+1);
+	subscript->Print(indentLevel+1, "(subscript) ");
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
+void ArrayAccess::GetChildren(vector<Node*> *children) {
+	children->push_back(base);
+	children->push_back(subscript);
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, subx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, suby, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+FieldAccess::FieldAccess(Expr *b, Identifier *f) 
+	: LValue(b? Join(b->GetLocation(), f->GetLocation()) : *f->GetLocation()) {
+		Assert(f != NULL); // b can be be NULL (just means no explicit base)
+		base = b; 
+		if (base) base->SetParent(this); 
+		(field=f)->SetParent(this);
+	}
 
-				return newVec2;
-			}
-			else if(op->IsOp("*")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
 
-				llvm::Value* mulx = llvm::BinaryOperator::CreateFMul(x, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* muly = llvm::BinaryOperator::CreateFMul(y, r, "FMul", irgen->GetBasicBlock());
+void FieldAccess::PrintChildren(int indentLevel) {
+	if (base) base->Print(indentLevel+1);
+	field->Print(indentLevel+1);
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
+void FieldAccess::GetChildren(vector<Node*> *children) {
+	if(base != NULL) {
+		children->push_back(base);
+	}
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, mulx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, muly, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+bool FieldAccess::EmitLValue(LValueRef *ref) {
+	LValue* target = dynamic_cast<LValue*>(base);
+	vector<int> lanes;
 
-				return newVec2;
-			}
-			else if(op->IsOp("/")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+	if(target == NULL || !target->EmitLValue(ref) || !SwizzleLanes(field, base, &lanes)) {
+		return false;
+	}
+	this->type = VectorOf(ScalarType(base->GetType()), lanes.size());
 
-				llvm::Value* divx = llvm::BinaryOperator::CreateFDiv(x, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* divy = llvm::BinaryOperator::CreateFDiv(y, r, "FDiv", irgen->GetBasicBlock());
+	// a swizzle of a swizzle selects from the lanes the inner one selected
+	if(!ref->lanes.empty()) {
+		for(unsigned int i = 0; i < lanes.size(); i++) {
+			lanes[i] = ref->lanes[lanes[i]];
+		}
+	}
+	ref->lanes = lanes;
+	return true;
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
+llvm::Value* FieldAccess::Emit() {
+	LValueRef ref;
+	vector<int> lanes;
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, divx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, divy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+	if(!valueUsed) {
+		base->DiscardValue();
+		base->Emit();
+		return NULL;
+	}
 
-				return newVec2;
-			}
+	if(dynamic_cast<LValue*>(base) != NULL && base->Fold() == NULL) {
+		if(!EmitLValue(&ref)) {
+			return NULL;
 		}
-		else if(left->GetType() == Type::vec3Type && right->GetType() == Type::floatType) {
-			this->type = Type::vec3Type;
-
-			if(op->IsOp("+")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(z, r, "FAdd", irgen->GetBasicBlock());
+		return ref.Load();
+	}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
+	// swizzle of a value that is not stored anywhere, such as a call
+	// result or a const vector
+	llvm::Value* baseVal = base->Emit();
+	if(!SwizzleLanes(field, base, &lanes)) {
+		return NULL;
+	}
+	this->type = VectorOf(ScalarType(base->GetType()), lanes.size());
+	return EmitSwizzle(baseVal, lanes);
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+llvm::Constant* FieldAccess::Fold() {
+	llvm::Constant* vec = base->Fold();
+	vector<int> lanes;
 
-				return newVec3;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
+	if(vec == NULL || !SwizzleLanes(field, base, &lanes, true)) {
+		return NULL;
+	}
+	this->type = VectorOf(ScalarType(base->GetType()), lanes.size());
+	return llvm::dyn_cast<llvm::Constant>(EmitSwizzle(vec, lanes));
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFSub(z, r, "FSub", irgen->GetBasicBlock());
+Call::Call(yyltype loc, Expr *b, Identifier *f, List<Expr*> *a) : Expr(loc)  {
+	Assert(f != NULL && a != NULL); // b can be be NULL (just means no explicit base)
+	base = b;
+	if (base) base->SetParent(this);
+	(field=f)->SetParent(this);
+	(actuals=a)->SetParentAll(this);
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
+void Call::PrintChildren(int indentLevel) {
+	if (base) base->Print(indentLevel+1);
+	if (field) field->Print(indentLevel+1);
+	if (actuals) actuals->PrintAll(indentLevel+1, "(actuals) ");
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+void Call::GetChildren(vector<Node*> *children) {
+	if(base != NULL) {
+		children->push_back(base);
+	}
+	if(actuals != NULL) {
+		actuals->AppendAllTo(children);
+	}
+}
 
-				return newVec3;
-			}
-			else if(op->IsOp("*")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
+/* Constant: BranchlessCost
+ * ------------------------
+ * The most work an operand may cost and still be computed unconditionally
+ * instead of behind a branch.  Past this, skipping the work is worth more
+ * than avoiding the branch.
+ */
+static const int BranchlessCost = 6;
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(x, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(y, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFMul(z, r, "FMul", irgen->GetBasicBlock());
+llvm::Value* LogicalExpr::Emit() {
+	llvm::LLVMContext *context = irgen->GetContext();
+	llvm::Function *f = irgen->GetFunction();
+	bool isAnd = op->IsOp("&&");
+	this->type = Type::boolType;
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
+	llvm::Value* lVal = left->Emit();
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+	// a cheap right operand that cannot trap or write anything is safe to
+	// evaluate either way, so both sides are combined without a branch
+	if(right->IsPure() && right->Cost() <= BranchlessCost) {
+		if(!valueUsed) {
+			return NULL;
+		}
+		llvm::Value* rVal = right->Emit();
+		if(isAnd) {
+			return irgen->GetBuilder()->CreateAnd(lVal, rVal, "LogicalAnd");
+		}
+		return irgen->GetBuilder()->CreateOr(lVal, rVal, "LogicalOr");
+	}
 
-				return newVec3;
-			}
-			else if(op->IsOp("/")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
+	// otherwise the right operand only runs when the left does not
+	// already decide the result
+	llvm::BasicBlock *leftParent = irgen->GetBasicBlock();
+	llvm::BasicBlock *rb = llvm::BasicBlock::Create(*context, "Logical Right", f);
+	llvm::BasicBlock *eb = llvm::BasicBlock::Create(*context, "Logical End");
+	if(isAnd) {
+		irgen->GetBuilder()->CreateCondBr(lVal, rb, eb);
+	}
+	else {
+		irgen->GetBuilder()->CreateCondBr(lVal, eb, rb);
+	}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFDiv(x, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFDiv(y, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFDiv(z, r, "FDiv", irgen->GetBasicBlock());
+	if(!valueUsed) {
+		right->DiscardValue();
+	}
+	irgen->SetBasicBlock(rb);
+	llvm::Value* rVal = right->Emit();
+	llvm::BasicBlock *rightParent = irgen->GetBasicBlock();
+	if(rightParent->getTerminator() == NULL) {
+		irgen->GetBuilder()->CreateBr(eb);
+	}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
+	eb->insertInto(f);
+	irgen->SetBasicBlock(eb);
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+	if(!valueUsed) {
+		return NULL;
+	}
 
-				return newVec3;
-			}
-		}
-		else if(left->GetType() == Type::vec4Type && right->GetType() == Type::floatType) {
-			this->type = Type::vec4Type;
+	llvm::PHINode *phi = irgen->GetBuilder()->CreatePHI(llvm::Type::getInt1Ty(*context), 2, isAnd ? "LogicalAnd" : "LogicalOr");
+	phi->addIncoming(llvm::ConstantInt::get(llvm::Type::getInt1Ty(*context), isAnd ? 0 : 1), leftParent);
+	phi->addIncoming(rVal, rightParent);
+	return phi;
+}
 
-			if(op->IsOp("+")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
+llvm::Constant* LogicalExpr::Fold() {
+	if(left == NULL) {
+		return NULL;
+	}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(z, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFAdd(w, r, "FAdd", irgen->GetBasicBlock());
+	llvm::Constant* l = left->Fold();
+	llvm::Constant* r = right->Fold();
+	if(l == NULL || r == NULL) {
+		return NULL;
+	}
+	this->type = Type::boolType;
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+	if(op->IsOp("&&")) {
+		return llvm::ConstantExpr::getAnd(l, r);
+	}
+	else if(op->IsOp("||")) {
+		return llvm::ConstantExpr::getOr(l, r);
+	}
+	return NULL;
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+llvm::Constant* ConditionalExpr::Fold() {
+	llvm::ConstantInt* c = llvm::dyn_cast_or_null<llvm::ConstantInt>(cond->Fold());
+	if(c == NULL) {
+		return NULL;
+	}
 
-				return newVec4;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
+	Expr* chosen = c->isZero() ? falseExpr : trueExpr;
+	llvm::Constant* val = chosen->Fold();
+	if(val != NULL) {
+		this->type = chosen->GetType();
+	}
+	return val;
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFSub(z, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFSub(w, r, "FSub", irgen->GetBasicBlock());
+llvm::Value* ConditionalExpr::Emit() {
+	llvm::LLVMContext *context = irgen->GetContext();
+	llvm::Function *f = irgen->GetFunction();
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+	// a condition known while compiling selects its arm outright
+	llvm::ConstantInt* known = llvm::dyn_cast_or_null<llvm::ConstantInt>(cond->Fold());
+	if(known != NULL) {
+		Expr* chosen = known->isZero() ? falseExpr : trueExpr;
+		if(!valueUsed) {
+			chosen->DiscardValue();
+		}
+		llvm::Value* val = chosen->Emit();
+		this->type = chosen->GetType();
+		return val;
+	}
+	llvm::Value *co = cond->Emit();
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+	// when both arms are cheap and free of side effects, computing both and
+	// selecting one is cheaper than a branch that may be mispredicted
+	if(trueExpr->IsPure() && falseExpr->IsPure() && trueExpr->Cost() + falseExpr->Cost() <= BranchlessCost) {
+		if(!valueUsed) {
+			return NULL;
+		}
+		llvm::Value *truEx = trueExpr->Emit();
+		llvm::Value *falEx = falseExpr->Emit();
+		this->type = trueExpr->GetType();
+		return irgen->GetBuilder()->CreateSelect(co, truEx, falEx, "Conditional");
+	}
 
-				return newVec4;
-			}
-			else if(op->IsOp("*")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
+	// blocks are added to the function in the order they are emitted
+	llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context,"Then Block",f);
+	llvm::BasicBlock *eb = llvm::BasicBlock::Create(*context,"Else Block",f);
+	llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context,"Footer Block");
+	irgen->GetBuilder()->CreateCondBr(co,bb,eb);
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(x, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(y, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFMul(z, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFMul(w, r, "FMul", irgen->GetBasicBlock());
+	if(!valueUsed) {
+		trueExpr->DiscardValue();
+		falseExpr->DiscardValue();
+	}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+	symtab->push_scope(SymbolTable::Block);
+	irgen->SetBasicBlock(bb);
+	llvm::Value *truEx = trueExpr->Emit();
+	llvm::BasicBlock *trueParent = irgen->GetBasicBlock();
+	if(irgen->GetBasicBlock()->getTerminator() == NULL) {
+		irgen->GetBuilder()->CreateBr(fb);
+	}
+	symtab->pop_scope();
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+	symtab->push_scope(SymbolTable::Block);
+	irgen->SetBasicBlock(eb);
+	llvm::Value *falEx = falseExpr->Emit();
+	llvm::BasicBlock *falseParent = irgen->GetBasicBlock();
+	if(irgen->GetBasicBlock()->getTerminator() == NULL) {
+		irgen->GetBuilder()->CreateBr(fb);
+	}
+	symtab->pop_scope();
 
-				return newVec4;
-			}
-			else if(op->IsOp("/")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
+	fb->insertInto(f);
+	irgen->SetBasicBlock(fb);
+	this->type = trueExpr->GetType();
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFDiv(x, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFDiv(y, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFDiv(z, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFDiv(w, r, "FDiv", irgen->GetBasicBlock());
+	if(!valueUsed) {
+		return NULL;
+	}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+	llvm::PHINode *phi = irgen->GetBuilder()->CreatePHI(truEx->getType(), 2, "phinode");
+	phi->addIncoming(truEx, trueParent);
+	phi->addIncoming(falEx, falseParent);
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+	return phi;
+}
 
-				return newVec4;
-			}
+/* Function: ConstructorType()
+ * ----------------------------
+ * The type built by a constructor call such as vec3(...), or NULL if
+ * name is not a type.
+ */
+static Type* ConstructorType(const char *name) {
+	Type* types[] = { Type::intType, Type::uintType, Type::floatType, Type::boolType,
+	                  Type::vec2Type, Type::vec3Type, Type::vec4Type,
+	                  Type::ivec2Type, Type::ivec3Type, Type::ivec4Type,
+	                  Type::uvec2Type, Type::uvec3Type, Type::uvec4Type,
+	                  Type::bvec2Type, Type::bvec3Type, Type::bvec4Type,
+	                  Type::mat2Type, Type::mat3Type, Type::mat4Type };
+
+	for(unsigned int i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+		if(strcmp(types[i]->GetTypeName(), name) == 0) {
+			return types[i];
 		}
-		else if(left->GetType() == Type::floatType && right->GetType() == Type::vec2Type) {
-			this->type = Type::vec2Type;
+	}
+	return NULL;
+}
 
-			if(op->IsOp("+")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+/* Function: EmitConversion()
+ * --------------------------
+ * Converts val from type from to the scalar type to, every lane of a
+ * vector at once.  Returns NULL for a type that does not convert.
+ */
+static llvm::Value* EmitConversion(llvm::Value *val, Type *from, Type *to) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	Type* src = ScalarType(from);
+	llvm::Type* ty = Node::irgen->ast_llvm(to, Node::irgen->GetContext());
 
-				llvm::Value* addx = llvm::BinaryOperator::CreateFAdd(x, l, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* addy = llvm::BinaryOperator::CreateFAdd(y, l, "FAdd", irgen->GetBasicBlock());
+	if(src != Type::floatType && src != Type::intType && src != Type::uintType && src != Type::boolType) {
+		return NULL;
+	}
+	if(src == to || (src != Type::floatType && src != Type::boolType && to != Type::floatType && to != Type::boolType)) {
+		// int and uint share a representation
+		return val;
+	}
+	if(val->getType()->isVectorTy()) {
+		ty = llvm::VectorType::get(ty, val->getType()->getVectorNumElements());
+	}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, addx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, addy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-
-				return newVec2;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-
-				llvm::Value* subx = llvm::BinaryOperator::CreateFSub(x, l, "FSub", irgen->GetBasicBlock());
-				llvm::Value* suby = llvm::BinaryOperator::CreateFSub(y, l, "FSub", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, subx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, suby, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-
-				return newVec2;
-			}
-			else if(op->IsOp("*")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-
-				llvm::Value* mulx = llvm::BinaryOperator::CreateFMul(x, l, "FMul", irgen->GetBasicBlock());
-				llvm::Value* muly = llvm::BinaryOperator::CreateFMul(y, l, "FMul", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
+	if(to == Type::boolType) {
+		llvm::Value* zero = llvm::Constant::getNullValue(val->getType());
+		return src == Type::floatType ? builder->CreateFCmpUNE(val, zero, "To Bool") : builder->CreateICmpNE(val, zero, "To Bool");
+	}
+	if(src == Type::boolType) {
+		return to == Type::floatType ? builder->CreateUIToFP(val, ty, "From Bool") : builder->CreateZExt(val, ty, "From Bool");
+	}
+	if(src == Type::floatType) {
+		return to == Type::uintType ? builder->CreateFPToUI(val, ty, "To Int") : builder->CreateFPToSI(val, ty, "To Int");
+	}
+	return src == Type::uintType ? builder->CreateUIToFP(val, ty, "To Float") : builder->CreateSIToFP(val, ty, "To Float");
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, mulx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, muly, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+/* Struct: Component
+ * -----------------
+ * One scalar fed to a constructor: lane of the vector value, or value
+ * itself if lane is negative.
+ */
+struct Component {
+	llvm::Value* value;
+	int lane;
+	Component(llvm::Value *v, int l) : value(v), lane(l) {}
+};
+
+/* Function: BuildVector()
+ * -----------------------
+ * Assembles the n components starting at parts[first] into a vector in
+ * as few instructions as it can.  Copies of one scalar are a splat; the
+ * lanes taken from one vector move with a single shuffle, and the first
+ * such shuffle also brings in constant lanes through its second operand;
+ * only the scalars left over are inserted one at a time.
+ */
+static llvm::Value* BuildVector(const vector<Component> &parts, int first, int n) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	const Component* c = &parts[first];
+	llvm::Type* laneTy = c[0].value->getType()->getScalarType();
+	vector<bool> done(n, false);
+	llvm::Value* result = NULL;
+
+	bool splat = true;
+	for(int k = 0; k < n; k++) {
+		splat = splat && c[k].lane < 0 && c[k].value == c[0].value;
+	}
+	if(splat) {
+		return Splat(c[0].value, n);
+	}
 
-				return newVec2;
+	for(int k = 0; k < n; k++) {
+		if(done[k] || c[k].lane < 0) {
+			continue;
+		}
+		llvm::Value* vec = c[k].value;
+		int width = vec->getType()->getVectorNumElements();
+		vector<int> mask(n, -1);
+		for(int m = k; m < n; m++) {
+			if(c[m].value == vec && c[m].lane >= 0) {
+				mask[m] = c[m].lane;
+				done[m] = true;
 			}
-			else if(op->IsOp("/")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-
-				llvm::Value* divx = llvm::BinaryOperator::CreateFDiv(x, l, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* divy = llvm::BinaryOperator::CreateFDiv(y, l, "FDiv", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, divx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, divy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+		}
 
-				return newVec2;
+		if(result == NULL) {
+			vector<llvm::Constant*> extra(width, llvm::UndefValue::get(laneTy));
+			int used = 0;
+			for(int m = 0; m < n && used < width; m++) {
+				if(!done[m] && c[m].lane < 0 && llvm::isa<llvm::Constant>(c[m].value)) {
+					extra[used] = llvm::cast<llvm::Constant>(c[m].value);
+					mask[m] = width + used++;
+					done[m] = true;
+				}
 			}
+			result = builder->CreateShuffleVector(vec, llvm::ConstantVector::get(extra), LaneMask(mask), "Construct");
 		}
-		else if(left->GetType() == Type::floatType && right->GetType() == Type::vec3Type) {
-			this->type = Type::vec3Type;
-
-			if(op->IsOp("+")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, l, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, l, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(z, l, "FAdd", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-
-				return newVec3;
+		else {
+			// gather this vector's lanes into place, then blend them in
+			llvm::Value* gathered = builder->CreateShuffleVector(vec, llvm::UndefValue::get(vec->getType()), LaneMask(mask), "Construct");
+			vector<int> blend;
+			for(int m = 0; m < n; m++) {
+				blend.push_back(mask[m] >= 0 ? n + m : m);
 			}
-			else if(op->IsOp("-")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, l, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, l, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFSub(z, l, "FSub", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+			result = builder->CreateShuffleVector(result, gathered, LaneMask(blend), "Construct");
+		}
+	}
 
-				return newVec3;
+	if(result == NULL) {
+		vector<llvm::Constant*> constants(n, llvm::UndefValue::get(laneTy));
+		for(int m = 0; m < n; m++) {
+			if(llvm::isa<llvm::Constant>(c[m].value)) {
+				constants[m] = llvm::cast<llvm::Constant>(c[m].value);
+				done[m] = true;
 			}
-			else if(op->IsOp("*")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(x, l, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(y, l, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFMul(z, l, "FMul", irgen->GetBasicBlock());
+		}
+		result = llvm::ConstantVector::get(constants);
+	}
+	for(int m = 0; m < n; m++) {
+		if(!done[m]) {
+			result = builder->CreateInsertElement(result, c[m].value, builder->getInt32(m), "Construct");
+		}
+	}
+	return result;
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
+/* Function: EmitConstructor()
+ * ---------------------------
+ * Emits type(args...).  The arguments are converted to type's scalar
+ * type and their components fill the result in order, columns first for
+ * a matrix.  A single scalar fills every lane of a vector and the
+ * diagonal of a matrix.  Returns NULL if the arguments do not fit.
+ */
+static llvm::Value* EmitConstructor(Type *type, List<Expr*> *actuals, const vector<llvm::Value*> &args) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	int columns = MatrixSize(type);
+	int lanes = columns != 0 ? columns : VectorSize(type);
+	Type* scalar = columns != 0 ? Type::floatType : ScalarType(type);
+	vector<Component> parts;
+
+	for(unsigned int i = 0; i < args.size(); i++) {
+		Type* argType = actuals->Nth(i)->GetType();
+		llvm::Value* val = EmitConversion(args[i], argType, scalar);
+		if(val == NULL) {
+			return NULL;
+		}
+		int width = VectorSize(argType);
+		for(int j = 0; j < width; j++) {
+			parts.push_back(Component(val, j));
+		}
+		if(width == 0) {
+			parts.push_back(Component(val, -1));
+		}
+	}
+	if(parts.empty()) {
+		return NULL;
+	}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+	if(lanes == 0) {
+		if(parts[0].lane < 0) {
+			return parts[0].value;
+		}
+		return builder->CreateExtractElement(parts[0].value, builder->getInt32(parts[0].lane), "Construct");
+	}
 
-				return newVec3;
-			}
-			else if(op->IsOp("/")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
+	if(columns != 0 && args.size() == 1 && parts.size() == 1) {
+		// s on the diagonal, zero everywhere else
+		llvm::Value* zero = llvm::Constant::getNullValue(parts[0].value->getType());
+		vector<Component> diagonal;
+		for(int i = 0; i < columns * columns; i++) {
+			diagonal.push_back(Component(i % (columns + 1) == 0 ? parts[0].value : zero, -1));
+		}
+		parts = diagonal;
+	}
+	else if(args.size() == 1 && parts.size() == 1) {
+		return Splat(parts[0].value, lanes);
+	}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFDiv(x, l, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFDiv(y, l, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFDiv(z, l, "FDiv", irgen->GetBasicBlock());
+	int count = columns != 0 ? columns * columns : lanes;
+	if((int)parts.size() < count) {
+		return NULL;
+	}
+	if(columns == 0) {
+		return BuildVector(parts, 0, lanes);
+	}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
+	llvm::Value* matrix = llvm::UndefValue::get(Node::irgen->ast_llvm(type, Node::irgen->GetContext()));
+	for(int j = 0; j < columns; j++) {
+		matrix = builder->CreateInsertValue(matrix, BuildVector(parts, j * columns, columns), j, "Construct");
+	}
+	return matrix;
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+/* Function: HasSurplusArguments()
+ * --------------------------------
+ * A constructor argument none of whose components are needed, such as
+ * the c of vec2(a, b, c), is an error in GLSL.  Only the last argument
+ * used may have components left over, as in vec2(v) of a vec3 v.
+ */
+static bool HasSurplusArguments(Type *type, List<Expr*> *actuals) {
+	int columns = MatrixSize(type);
+	int count = columns != 0 ? columns * columns : VectorSize(type);
+	if(count == 0) {
+		count = 1;
+	}
 
-				return newVec3;
-			}
+	int used = 0;
+	for(int i = 0; i < actuals->NumElements(); i++) {
+		if(used >= count) {
+			return true;
 		}
-		else if(left->GetType() == Type::floatType && right->GetType() == Type::vec4Type) {
-			this->type = Type::vec4Type;
-
-			if(op->IsOp("+")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
+		int width = VectorSize(actuals->Nth(i)->GetType());
+		used += width != 0 ? width : 1;
+	}
+	return false;
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, l, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, l, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(z, l, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFAdd(w, l, "FAdd", irgen->GetBasicBlock());
+/* Function: Widen()
+ * -----------------
+ * Splats a scalar to the width of like if like is a vector, so built-ins
+ * such as clamp(v, 0.0, 1.0) can take scalar bounds.
+ */
+static llvm::Value* Widen(llvm::Value *val, llvm::Value *like) {
+	if(like->getType()->isVectorTy() && !val->getType()->isVectorTy()) {
+		return Splat(val, like->getType()->getVectorNumElements());
+	}
+	return val;
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+/* Function: EmitSum()
+ * -------------------
+ * Adds up the lanes of a float vector.  A power of two width is halved
+ * with shuffles first, so a vec4 takes two vector adds and one scalar.
+ */
+static llvm::Value* EmitSum(llvm::Value *v) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	if(!v->getType()->isVectorTy()) {
+		return v;
+	}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+	int n = v->getType()->getVectorNumElements();
+	while(n > 2 && n % 2 == 0) {
+		vector<int> lo, hi;
+		for(int i = 0; i < n / 2; i++) {
+			lo.push_back(i);
+			hi.push_back(n / 2 + i);
+		}
+		v = builder->CreateFAdd(EmitSwizzle(v, lo), EmitSwizzle(v, hi), "FAdd");
+		n /= 2;
+	}
 
-				return newVec4;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
+	llvm::Value* sum = builder->CreateExtractElement(v, builder->getInt32(0), "Lane");
+	for(int i = 1; i < n; i++) {
+		sum = builder->CreateFAdd(sum, builder->CreateExtractElement(v, builder->getInt32(i), "Lane"), "FAdd");
+	}
+	return sum;
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, l, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, l, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFSub(z, l, "FSub", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFSub(w, l, "FSub", irgen->GetBasicBlock());
+/* Function: EmitDot()
+ * -------------------
+ * The dot product of two float vectors: one vector multiply and a sum.
+ */
+static llvm::Value* EmitDot(llvm::Value *a, llvm::Value *b) {
+	return EmitSum(Node::irgen->GetBuilder()->CreateFMul(a, b, "FMul"));
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+/* Function: EmitMinMax()
+ * ----------------------
+ * min(x, y) or max(x, y) on every lane: minnum and maxnum for floats,
+ * a compare and select for ints.
+ */
+static llvm::Value* EmitMinMax(bool isMax, llvm::Value *x, llvm::Value *y, Type *type) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	y = Widen(y, x);
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+	if(ScalarType(type) == Type::floatType) {
+		llvm::Value* args[] = { x, y };
+		return EmitIntrinsic(isMax ? llvm::Intrinsic::maxnum : llvm::Intrinsic::minnum, args, isMax ? "Max" : "Min");
+	}
+	llvm::Value* less = builder->CreateICmp(IsUnsigned(type) ? llvm::ICmpInst::ICMP_ULT : llvm::ICmpInst::ICMP_SLT, x, y, "Less");
+	return isMax ? builder->CreateSelect(less, y, x, "Max") : builder->CreateSelect(less, x, y, "Min");
+}
 
-				return newVec4;
-			}
-			else if(op->IsOp("*")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
+/* Type: BuiltinFn
+ * ---------------
+ * Emits a built-in inline for arguments args of AST types types, after
+ * their types have been checked, and sets type to the result's type.
+ */
+typedef llvm::Value* (*BuiltinFn)(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type);
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(x, l, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(y, l, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFMul(z, l, "FMul", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFMul(w, l, "FMul", irgen->GetBasicBlock());
+static llvm::Value* BuiltinTranspose(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitTranspose(args[0]);
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+static llvm::Value* BuiltinMatrixCompMult(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	llvm::Value *result = llvm::UndefValue::get(args[0]->getType());
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+	for(int j = 0; j < MatrixSize(types[0]); j++) {
+		llvm::Value *l = builder->CreateExtractValue(args[0], j, "Column");
+		llvm::Value *r = builder->CreateExtractValue(args[1], j, "Column");
+		result = builder->CreateInsertValue(result, builder->CreateFMul(l, r, "FMul"), j, "Matrix");
+	}
+	*type = types[0];
+	return result;
+}
 
-				return newVec4;
-			}
-			else if(op->IsOp("/")) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
+// a bvec is an i1 mask, so reducing it is a single compare of the mask
+// as an integer with one bit per lane
+static llvm::Value* BuiltinAny(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	llvm::Value* bits = builder->CreateBitCast(args[0], builder->getIntNTy(VectorSize(types[0])), "Mask");
+	*type = Type::boolType;
+	return builder->CreateICmpNE(bits, llvm::Constant::getNullValue(bits->getType()), "Any");
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFDiv(x, l, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFDiv(y, l, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFDiv(z, l, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFDiv(w, l, "FDiv", irgen->GetBasicBlock());
+static llvm::Value* BuiltinAll(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	llvm::Value* bits = builder->CreateBitCast(args[0], builder->getIntNTy(VectorSize(types[0])), "Mask");
+	*type = Type::boolType;
+	return builder->CreateICmpEQ(bits, llvm::Constant::getAllOnesValue(bits->getType()), "All");
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+static llvm::Value* BuiltinNot(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return Node::irgen->GetBuilder()->CreateNot(args[0], "Not");
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+static llvm::Value* BuiltinDot(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = Type::floatType;
+	return EmitDot(args[0], args[1]);
+}
 
-				return newVec4;
-			}
-		}
-		else if(left->GetType() == Type::vec2Type && right->GetType() == Type::vec2Type) {
-			this->type = Type::vec2Type;
+static llvm::Value* BuiltinCross(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	static const int yzx[] = { 1, 2, 0 }, zxy[] = { 2, 0, 1 };
+	vector<int> first(yzx, yzx + 3), second(zxy, zxy + 3);
 
-			if(op->IsOp("+")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+	// a.yzx * b.zxy - a.zxy * b.yzx
+	llvm::Value* l = builder->CreateFMul(EmitSwizzle(args[0], first), EmitSwizzle(args[1], second), "FMul");
+	llvm::Value* r = builder->CreateFMul(EmitSwizzle(args[0], second), EmitSwizzle(args[1], first), "FMul");
+	*type = types[0];
+	return builder->CreateFSub(l, r, "Cross");
+}
 
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+static llvm::Value* BuiltinLength(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	llvm::Value* dot[] = { EmitDot(args[0], args[0]) };
+	*type = Type::floatType;
+	return EmitIntrinsic(llvm::Intrinsic::sqrt, dot, "Length");
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(lx, rx, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(ly, ry, "FAdd", irgen->GetBasicBlock());
+static llvm::Value* BuiltinDistance(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	llvm::Value* d = Node::irgen->GetBuilder()->CreateFSub(args[0], args[1], "FSub");
+	llvm::Value* dot[] = { EmitDot(d, d) };
+	*type = Type::floatType;
+	return EmitIntrinsic(llvm::Intrinsic::sqrt, dot, "Distance");
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));				
+static llvm::Value* BuiltinNormalize(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	llvm::Value* dot[] = { EmitDot(args[0], args[0]) };
+	llvm::Value* length = EmitIntrinsic(llvm::Intrinsic::sqrt, dot, "Length");
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+	// one division, then a multiply on every lane
+	llvm::Value* inverse = builder->CreateFDiv(llvm::ConstantFP::get(length->getType(), 1.0), length, "Inverse");
+	*type = types[0];
+	return builder->CreateFMul(args[0], Widen(inverse, args[0]), "Normalize");
+}
 
-				return newVec2;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+static llvm::Value* BuiltinReflect(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
 
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+	// I - 2 * dot(N, I) * N, as one multiply-add
+	llvm::Value* scale = builder->CreateFMul(EmitDot(args[1], args[0]), llvm::ConstantFP::get(Node::irgen->GetFloatType(), -2.0), "FMul");
+	*type = types[0];
+	return EmitMulAdd(args[1], Widen(scale, args[1]), args[0], "Reflect");
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(lx, rx, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(ly, ry, "FSub", irgen->GetBasicBlock());
+static llvm::Value* BuiltinMix(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	// x + (y - x) * a, as one multiply-add
+	llvm::Value* d = Node::irgen->GetBuilder()->CreateFSub(args[1], args[0], "FSub");
+	*type = types[0];
+	return EmitMulAdd(d, Widen(args[2], args[0]), args[0], "Mix");
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));				
+static llvm::Value* BuiltinClamp(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMinMax(false, EmitMinMax(true, args[0], args[1], types[0]), args[2], types[0]);
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+static llvm::Value* BuiltinMin(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMinMax(false, args[0], args[1], types[0]);
+}
 
-				return newVec2;
-			}
-			else if(op->IsOp("*")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+static llvm::Value* BuiltinMax(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMinMax(true, args[0], args[1], types[0]);
+}
 
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+static llvm::Value* BuiltinAbs(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	*type = types[0];
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(lx, rx, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(ly, ry, "FMul", irgen->GetBasicBlock());
+	if(ScalarType(types[0]) == Type::floatType) {
+		return EmitIntrinsic(llvm::Intrinsic::fabs, args, "Abs");
+	}
+	if(IsUnsigned(types[0])) {
+		return args[0];
+	}
+	llvm::Value* negative = builder->CreateICmpSLT(args[0], llvm::Constant::getNullValue(args[0]->getType()), "Negative");
+	return builder->CreateSelect(negative, builder->CreateNeg(args[0], "Neg"), args[0], "Abs");
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));				
+static llvm::Value* BuiltinSqrt(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitIntrinsic(llvm::Intrinsic::sqrt, args, "Sqrt");
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+static llvm::Value* BuiltinFloor(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitIntrinsic(llvm::Intrinsic::floor, args, "Floor");
+}
 
-				return newVec2;
-			}
-			else if(op->IsOp("/")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+static llvm::Value* BuiltinFract(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return Node::irgen->GetBuilder()->CreateFSub(args[0], EmitIntrinsic(llvm::Intrinsic::floor, args, "Floor"), "Fract");
+}
 
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
+static llvm::Value* BuiltinStep(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	llvm::Type* ty = args[1]->getType();
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFDiv(lx, rx, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFDiv(ly, ry, "FDiv", irgen->GetBasicBlock());
+	// x < edge ? 0.0 : 1.0 on every lane, which is a compare and a blend
+	llvm::Value* below = builder->CreateFCmpOLT(args[1], Widen(args[0], args[1]), "Below");
+	*type = types[1];
+	return builder->CreateSelect(below, llvm::ConstantFP::get(ty, 0.0), llvm::ConstantFP::get(ty, 1.0), "Step");
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));				
+static llvm::Value* BuiltinInverseSqrt(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	llvm::Value* one = llvm::ConstantFP::get(args[0]->getType(), 1.0);
+	return Node::irgen->GetBuilder()->CreateFDiv(one, EmitIntrinsic(llvm::Intrinsic::sqrt, args, "Sqrt"), "InverseSqrt");
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
+/* The built-ins computed by the bundled math library (see mathlib.h). */
+static const char* const mathFunctions[] = { "atan", "cos", "exp", "exp2", "log", "log2", "pow", "sin", "tan" };
 
-				return newVec2;
-			}
+static bool IsMathBuiltin(const char *name) {
+	for(unsigned int i = 0; i < sizeof(mathFunctions) / sizeof(mathFunctions[0]); i++) {
+		if(strcmp(mathFunctions[i], name) == 0) {
+			return true;
 		}
-		else if(left->GetType() == Type::vec3Type && right->GetType() == Type::vec3Type) {
-			this->type = Type::vec3Type;
-
-			if(op->IsOp("+")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* lz = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* rz = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(lx, rx, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(ly, ry, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(lz, rz, "FAdd", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));				
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+	}
+	return false;
+}
 
-				return newVec3;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* lz = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
+/* Function: EmitMathCall()
+ * ------------------------
+ * Calls the math library function for the built-in name.  The library
+ * works on vec4, so narrower arguments are widened with a shuffle and
+ * the result narrowed back again; the call is inlined once the whole
+ * module is emitted, and the shuffles fold into the inlined code.
+ */
+static llvm::Value* EmitMathCall(const char *name, const vector<llvm::Value*> &args) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	llvm::Type* vec4 = llvm::VectorType::get(Node::irgen->GetFloatType(), 4);
+	llvm::Type* ty = args[0]->getType();
+	int n = ty->isVectorTy() ? ty->getVectorNumElements() : 1;
+
+	// a vec2 or vec3 repeats its last lane rather than leave lanes undef
+	vector<int> widen, narrow;
+	for(int i = 0; i < 4; i++) {
+		widen.push_back(i < n ? i : n - 1);
+	}
+	for(int i = 0; i < n; i++) {
+		narrow.push_back(i);
+	}
 
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* rz = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
+	vector<llvm::Value*> wide;
+	vector<llvm::Type*> params;
+	for(unsigned int i = 0; i < args.size(); i++) {
+		if(n == 1) {
+			wide.push_back(Splat(args[i], 4));
+		}
+		else {
+			wide.push_back(n == 4 ? args[i] : EmitSwizzle(args[i], widen));
+		}
+		params.push_back(vec4);
+	}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(lx, rx, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(ly, ry, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFSub(lz, rz, "FSub", irgen->GetBasicBlock());
+	llvm::Module* mod = Node::irgen->GetOrCreateModule("Program_Module.bc");
+	llvm::FunctionType* fnType = llvm::FunctionType::get(vec4, params, false);
+	llvm::Function* fn = llvm::cast<llvm::Function>(mod->getOrInsertFunction(MathFunctionName(name), fnType));
+	fn->setDoesNotAccessMemory();
+	fn->setDoesNotThrow();
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));				
+	llvm::Value* result = builder->CreateCall(fn, wide, name);
+	if(n == 1) {
+		return builder->CreateExtractElement(result, builder->getInt32(0), name);
+	}
+	return n == 4 ? result : EmitSwizzle(result, narrow);
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+static llvm::Value* BuiltinSin(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMathCall("sin", args);
+}
 
-				return newVec3;
-			}
-			else if(op->IsOp("*")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* lz = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
+static llvm::Value* BuiltinCos(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMathCall("cos", args);
+}
 
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* rz = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
+static llvm::Value* BuiltinTan(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMathCall("tan", args);
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(lx, rx, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(ly, ry, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFMul(lz, rz, "FMul", irgen->GetBasicBlock());
+static llvm::Value* BuiltinAtan(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMathCall(args.size() == 2 ? "atan2" : "atan", args);
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));				
+static llvm::Value* BuiltinExp(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMathCall("exp", args);
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+static llvm::Value* BuiltinExp2(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMathCall("exp2", args);
+}
 
-				return newVec3;
-			}
-			else if(op->IsOp("/")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* lz = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
+static llvm::Value* BuiltinLog(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMathCall("log", args);
+}
 
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* rz = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
+static llvm::Value* BuiltinLog2(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMathCall("log2", args);
+}
 
-				llvm::Value* newx = llvm::BinaryOperator::CreateFDiv(lx, rx, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFDiv(ly, ry, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFDiv(lz, rz, "FDiv", irgen->GetBasicBlock());
+static llvm::Value* BuiltinPow(const vector<llvm::Value*> &args, const vector<Type*> &types, Type **type) {
+	*type = types[0];
+	return EmitMathCall("pow", args);
+}
 
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));				
+/* Enum: ArgKind
+ * -------------
+ * The argument types a built-in accepts.  Gen is float, vec2, vec3 or
+ * vec4.  The others are relative to the type of the first argument:
+ * Same is that type, SameOrScalar also allows its scalar type, and
+ * Wider allows a vector of the same scalar type where the first is a
+ * scalar, as in step(0.5, v).
+ */
+typedef enum { Gen, GenNumber, GenBool, Vec3, Matrix, Same, SameOrScalar, Wider } ArgKind;
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
+/* Struct: Builtin
+ * ---------------
+ * A built-in function: the kinds of its first argument, of any middle
+ * ones and of its last one, and the function that emits it.
+ */
+struct Builtin {
+	const char *name;
+	int numArgs;
+	ArgKind first, middle, last;
+	BuiltinFn emit;
+};
+
+/* The built-in functions, resolved while compiling and emitted inline
+ * (see EmitBuiltin).  A declared function of the same name hides one.
+ */
+static const Builtin builtins[] = {
+	{ "abs",            1, GenNumber, Same,         Same,         BuiltinAbs },
+	{ "all",            1, GenBool,   Same,         Same,         BuiltinAll },
+	{ "any",            1, GenBool,   Same,         Same,         BuiltinAny },
+	{ "atan",           1, Gen,       Same,         Same,         BuiltinAtan },
+	{ "atan",           2, Gen,       Same,         Same,         BuiltinAtan },
+	{ "clamp",          3, GenNumber, SameOrScalar, SameOrScalar, BuiltinClamp },
+	{ "cos",            1, Gen,       Same,         Same,         BuiltinCos },
+	{ "cross",          2, Vec3,      Same,         Same,         BuiltinCross },
+	{ "distance",       2, Gen,       Same,         Same,         BuiltinDistance },
+	{ "dot",            2, Gen,       Same,         Same,         BuiltinDot },
+	{ "exp",            1, Gen,       Same,         Same,         BuiltinExp },
+	{ "exp2",           1, Gen,       Same,         Same,         BuiltinExp2 },
+	{ "floor",          1, Gen,       Same,         Same,         BuiltinFloor },
+	{ "fract",          1, Gen,       Same,         Same,         BuiltinFract },
+	{ "inversesqrt",    1, Gen,       Same,         Same,         BuiltinInverseSqrt },
+	{ "length",         1, Gen,       Same,         Same,         BuiltinLength },
+	{ "log",            1, Gen,       Same,         Same,         BuiltinLog },
+	{ "log2",           1, Gen,       Same,         Same,         BuiltinLog2 },
+	{ "matrixCompMult", 2, Matrix,    Same,         Same,         BuiltinMatrixCompMult },
+	{ "max",            2, GenNumber, SameOrScalar, SameOrScalar, BuiltinMax },
+	{ "min",            2, GenNumber, SameOrScalar, SameOrScalar, BuiltinMin },
+	{ "mix",            3, Gen,       Same,         SameOrScalar, BuiltinMix },
+	{ "normalize",      1, Gen,       Same,         Same,         BuiltinNormalize },
+	{ "not",            1, GenBool,   Same,         Same,         BuiltinNot },
+	{ "pow",            2, Gen,       Same,         Same,         BuiltinPow },
+	{ "reflect",        2, Gen,       Same,         Same,         BuiltinReflect },
+	{ "sin",            1, Gen,       Same,         Same,         BuiltinSin },
+	{ "sqrt",           1, Gen,       Same,         Same,         BuiltinSqrt },
+	{ "step",           2, Gen,       Wider,        Wider,        BuiltinStep },
+	{ "tan",            1, Gen,       Same,         Same,         BuiltinTan },
+	{ "transpose",      1, Matrix,    Same,         Same,         BuiltinTranspose },
+};
+
+/* Function: ArgFits()
+ * -------------------
+ * Whether an argument of type type is accepted where kind is expected;
+ * first is the type of the first argument.
+ */
+static bool ArgFits(ArgKind kind, Type *type, Type *first) {
+	Type* scalar = ScalarType(type);
+	switch(kind) {
+		case Gen:          return scalar == Type::floatType;
+		case GenNumber:    return scalar == Type::floatType || scalar == Type::intType || scalar == Type::uintType;
+		case GenBool:      return scalar == Type::boolType && VectorSize(type) != 0;
+		case Vec3:         return type == Type::vec3Type;
+		case Matrix:       return MatrixSize(type) != 0;
+		case Same:         return type == first;
+		case SameOrScalar: return type == first || type == ScalarType(first);
+		case Wider:        return type == first || (first == ScalarType(first) && scalar == first);
+	}
+	return false;
+}
 
-				return newVec3;
-			}
+/* Function: IsBuiltin()
+ * ----------------------
+ * Whether name is the name of a built-in function.
+ */
+static bool IsBuiltin(const char *name) {
+	for(unsigned int i = 0; i < sizeof(builtins) / sizeof(builtins[0]); i++) {
+		if(strcmp(builtins[i].name, name) == 0) {
+			return true;
 		}
-		else if(left->GetType() == Type::vec4Type && right->GetType() == Type::vec4Type) {
-			this->type = Type::vec4Type;
-
-			if(op->IsOp("+")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* lz = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* lw = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* rz = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* rw = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(lx, rx, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(ly, ry, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(lz, rz, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFAdd(lw, rw, "FAdd", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
+	}
+	return false;
+}
 
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
+/* Function: EmitBuiltin()
+ * -----------------------
+ * Emits a call to a built-in function with the given arguments, and
+ * sets type to the type of its result.  Returns NULL if there is no
+ * built-in of that name taking those arguments.
+ */
+static llvm::Value* EmitBuiltin(const char *name, List<Expr*> *actuals, const vector<llvm::Value*> &args, Type **type) {
+	vector<Type*> types;
+	for(int i = 0; i < actuals->NumElements(); i++) {
+		types.push_back(actuals->Nth(i)->GetType());
+	}
 
-				return newVec4;
-			}
-			else if(op->IsOp("-")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* lz = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* lw = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* rz = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* rw = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(lx, rx, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(ly, ry, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFSub(lz, rz, "FSub", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFSub(lw, rw, "FSub", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
-
-				return newVec4;
-			}
-			else if(op->IsOp("*")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* lz = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* lw = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* rz = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* rw = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(lx, rx, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(ly, ry, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFMul(lz, rz, "FMul", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFMul(lw, rw, "FMul", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
-
-				return newVec4;
-			}
-			else if(op->IsOp("/")) {
-				llvm::Value* lx = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ly = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* lz = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* lw = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-
-				llvm::Value* rx = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* ry = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* rz = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* rw = llvm::ExtractElementInst::Create(r,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFDiv(lx, rx, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFDiv(ly, ry, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFDiv(lz, rz, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFDiv(lw, rw, "FDiv", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
-
-				return newVec4;
-			}
+	for(unsigned int i = 0; i < sizeof(builtins) / sizeof(builtins[0]); i++) {
+		const Builtin &b = builtins[i];
+		if(strcmp(b.name, name) != 0 || b.numArgs != (int)args.size() || !ArgFits(b.first, types[0], types[0])) {
+			continue;
 		}
-		else if(left->GetType() == Type::floatType && right->GetType() == Type::floatType) {
-			this->type = Type::floatType;
-
-			if(op->IsOp("+")) {
-				return llvm::BinaryOperator::CreateFAdd(l, r, "FAdd", irgen->GetBasicBlock());
-			}
-			else if(op->IsOp("-")) {
-				return llvm::BinaryOperator::CreateFSub(l, r, "FSub", irgen->GetBasicBlock());
-			}
-			else if(op->IsOp("*")) {
-				return llvm::BinaryOperator::CreateFMul(l, r, "FMul", irgen->GetBasicBlock());
-			}
-			else if(op->IsOp("/")) {
-				return llvm::BinaryOperator::CreateFDiv(l, r, "FDiv", irgen->GetBasicBlock());
-			}
+		bool fits = true;
+		for(unsigned int j = 1; j < types.size(); j++) {
+			fits = fits && ArgFits(j + 1 == types.size() ? b.last : b.middle, types[j], types[0]);
 		}
-		else if(left->GetType() == Type::intType && right->GetType() == Type::intType) {
-			this->type = Type::intType;
-
-			if(op->IsOp("+")) {
-				return llvm::BinaryOperator::CreateAdd(l, r, "Add", irgen->GetBasicBlock());
-			}
-			else if(op->IsOp("-")) {
-				return llvm::BinaryOperator::CreateSub(l, r, "Sub", irgen->GetBasicBlock());
-			}
-			else if(op->IsOp("*")) {
-				return llvm::BinaryOperator::CreateMul(l, r, "Mul", irgen->GetBasicBlock());
-			}
-			else if(op->IsOp("/")) {
-				return llvm::BinaryOperator::CreateSDiv(l, r, "Div", irgen->GetBasicBlock());
-			}
+		if(fits) {
+			return b.emit(args, types, type);
 		}
 	}
-
 	return NULL;
 }
 
-llvm::Value* PostfixExpr::Emit() {
-	llvm::Value* l = left->Emit();
-
-	if(left->GetType() == Type::intType) {
-		this->type = Type::intType;
-
-		if(op->IsOp("++")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
+llvm::Value* Call::Emit() {
+	std::vector<llvm::Value*> argTypes;
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
+	for(int i = 0; i < actuals->NumElements(); i++) {
+		llvm::Value* arg = actuals->Nth(i)->Emit();
+		if(arg == NULL) {
+			return NULL;
+		}
+		argTypes.push_back(arg);
+	}
 
-				llvm::Value *val = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-				llvm::Value *inst = llvm::BinaryOperator::CreateAdd(vExprInst, val, "IInc", irgen->GetBasicBlock());
+	Type* constructed = ConstructorType(field->GetName());
+	if(constructed != NULL) {
+		if(HasSurplusArguments(constructed, actuals)) {
+			ReportError::Formatted(GetLocation(), "too many arguments to constructor of '%s'", field->GetName());
+			return NULL;
+		}
+		llvm::Value* value = EmitConstructor(constructed, actuals, argTypes);
+		if(value == NULL) {
+			ReportError::Formatted(GetLocation(), "arguments do not match any constructor of '%s'", field->GetName());
+			return NULL;
+		}
+		this->type = constructed;
+		return value;
+	}
 
-				new llvm::StoreInst(inst,ptr, "Store Element", irgen->GetBasicBlock());
+	llvm::ArrayRef<llvm::Value*> argArray(argTypes);
 
-				return l;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value *val = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-				llvm::Value *inst = llvm::BinaryOperator::CreateAdd(l, val, "IInc", irgen->GetBasicBlock());
+	llvm::Value* tempVal = symtab->val_search(string(field->GetName()));
+	Decl* tempDecl = symtab->search_scope(string(field->GetName()));
+	FnDecl* dynamcast = dynamic_cast<FnDecl*>(tempDecl);
 
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(left);
+	// a declared function hides a built-in of the same name
+	if(dynamcast == NULL) {
+		llvm::Value* builtin = EmitBuiltin(field->GetName(), actuals, argTypes, &this->type);
+		if(builtin == NULL) {
+			ReportError::IdentifierNotDeclared(field, LookingForFunction);
+		}
+		return builtin;
+	}
 
-				llvm::Value* ret = new llvm::StoreInst(inst, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
+	this->type = dynamcast->GetType();
 
+	// a void result cannot be named
+	llvm::Function* callee = llvm::cast<llvm::Function>(tempVal);
+	llvm::CallInst* call = irgen->GetBuilder()->CreateCall(callee, argArray, callee->getReturnType()->isVoidTy() ? "" : "Function Call");
+	call->setCallingConv(callee->getCallingConv());
+	return call;
+}
 
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
+llvm::Constant* Call::Fold() {
+	Type* constructed = ConstructorType(field->GetName());
+	vector<llvm::Value*> args;
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return l;
-			}
+	// only a constructor of constants is a constant; the builder folds
+	// every step, so nothing is emitted
+	if(constructed == NULL) {
+		return NULL;
+	}
+	for(int i = 0; i < actuals->NumElements(); i++) {
+		llvm::Constant* arg = actuals->Nth(i)->Fold();
+		if(arg == NULL) {
+			return NULL;
 		}
-		else if(op->IsOp("--")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
+		args.push_back(arg);
+	}
+	if(HasSurplusArguments(constructed, actuals)) {
+		return NULL;
+	}
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
+	llvm::Value* value = EmitConstructor(constructed, actuals, args);
+	if(value == NULL) {
+		return NULL;
+	}
+	this->type = constructed;
+	return llvm::dyn_cast<llvm::Constant>(value);
+}
 
-				llvm::Value *val = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-				llvm::Value *inst = llvm::BinaryOperator::CreateSub(vExprInst, val, "ISub", irgen->GetBasicBlock());
+bool Call::IsPure() {
+	// constructors and built-ins are computed inline, with no effects;
+	// a declared function of the same name as a built-in hides it
+	const char* name = field->GetName();
+	if(ConstructorType(name) == NULL && (!IsBuiltin(name) || symtab->search_scope(string(name)) != NULL)) {
+		return false;
+	}
+	for(int i = 0; i < actuals->NumElements(); i++) {
+		if(!actuals->Nth(i)->IsPure()) {
+			return false;
+		}
+	}
+	return true;
+}
 
-				new llvm::StoreInst(inst,ptr, "Store Element", irgen->GetBasicBlock());
+int Call::Cost() {
+	// a math library function inlines to a few dozen instructions
+	const char* name = field->GetName();
+	int cost = ConstructorType(name) != NULL ? 1 : IsMathBuiltin(name) ? 30 : 4;
+	for(int i = 0; i < actuals->NumElements(); i++) {
+		cost += actuals->Nth(i)->Cost();
+	}
+	return cost;
+}
 
-				return l;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value *val = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-				llvm::Value *inst = llvm::BinaryOperator::CreateSub(l, val, "IDec", irgen->GetBasicBlock());
+InitializerList::InitializerList(yyltype loc, List<Expr*> *e) : Expr(loc) {
+	Assert(e != NULL);
+	(elems=e)->SetParentAll(this);
+	arrayType = NULL;
+	target = NULL;
+}
 
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(left);
+void InitializerList::PrintChildren(int indentLevel) {
+	elems->PrintAll(indentLevel+1, "(element) ");
+}
 
-				llvm::Value* ret = new llvm::StoreInst(inst, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
+void InitializerList::GetChildren(vector<Node*> *children) {
+	elems->AppendAllTo(children);
+}
 
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
+llvm::Value* InitializerList::Emit() {
+	Assert(arrayType != NULL);
+	llvm::IRBuilder<> *builder = irgen->GetBuilder();
+	this->type = arrayType;
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return l;
-			}
+	// every element is emitted, so each mismatch is reported
+	llvm::Value* array = llvm::UndefValue::get(irgen->ast_llvm(arrayType, irgen->GetContext()));
+	for(int i = 0; i < elems->NumElements(); i++) {
+		llvm::Value* elem = EmitInitializer(elems->Nth(i), arrayType->GetElemType(), target);
+		if(elem == NULL) {
+			array = NULL;
+		}
+		if(array != NULL) {
+			array = builder->CreateInsertValue(array, elem, i, "Initializer");
 		}
 	}
-	else if(left->GetType() == Type::floatType) {
-		this->type = Type::floatType;
-
-		if(op->IsOp("++")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
+	return array;
+}
 
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
+llvm::Constant* InitializerList::Fold() {
+	Assert(arrayType != NULL);
+	vector<llvm::Constant*> values;
+	this->type = arrayType;
 
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
+	for(int i = 0; i < elems->NumElements(); i++) {
+		llvm::Constant* elem = FoldInitializer(elems->Nth(i), arrayType->GetElemType());
+		if(elem == NULL) {
+			return NULL;
+		}
+		values.push_back(elem);
+	}
+	llvm::ArrayType* arrayTy = llvm::cast<llvm::ArrayType>(irgen->ast_llvm(arrayType, irgen->GetContext()));
+	return llvm::ConstantArray::get(arrayTy, values);
+}
 
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
+void InitializerList::ReportUnfolded() {
+	for(int i = 0; i < elems->NumElements(); i++) {
+		if(FoldInitializer(elems->Nth(i), arrayType->GetElemType()) == NULL) {
+			::ReportUnfolded(elems->Nth(i), arrayType->GetElemType(), target);
+		}
+	}
+}
 
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-				llvm::Value *inst = llvm::BinaryOperator::CreateFAdd(vExprInst, val, "FAdd", irgen->GetBasicBlock());
+/* Function: SameType()
+ * --------------------
+ * Built-in types are shared, but each array declaration has its own
+ * ArrayType, so arrays are compared by shape.
+ */
+static bool SameType(Type *a, Type *b) {
+	ArrayType* x = dynamic_cast<ArrayType*>(a);
+	ArrayType* y = dynamic_cast<ArrayType*>(b);
+	if(x != NULL && y != NULL) {
+		return x->GetElemCount() == y->GetElemCount() && SameType(x->GetElemType(), y->GetElemType());
+	}
+	return a == b;
+}
 
-				new llvm::StoreInst(inst,ptr, "Store Element", irgen->GetBasicBlock());
+/* Function: ConvertInitializer()
+ * ------------------------------
+ * val, of type from, as an initializer of type to, or NULL if from does
+ * not convert to it.
+ */
+static llvm::Value* ConvertInitializer(llvm::Value *val, Type *from, Type *to) {
+	if(from == NULL) {
+		return NULL;
+	}
+	if(SameType(from, to)) {
+		return val;
+	}
+	Type* scalar = ScalarType(from);
+	if(ScalarType(to) == Type::floatType && (scalar == Type::intType || scalar == Type::uintType) && VectorSize(from) == VectorSize(to)) {
+		return EmitConversion(val, from, Type::floatType);
+	}
+	return NULL;
+}
 
-				return l;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* dynamcast = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-
-				llvm::Value* baseVec = dynamcast->base->Emit();
-				llvm::Value* fieldIdx;
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				string swiz = string(dynamcast->field->GetName());
-
-				if(swiz.length() == 1) {
-					if(swiz[0] == 'x') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[0] == 'y') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[0] == 'z') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[0] == 'w') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-				}
+llvm::Constant* FoldInitializer(Expr *init, Type *to) {
+	InitializerList* list = dynamic_cast<InitializerList*>(init);
+	if(list != NULL) {
+		return list->Fold();
+	}
 
-				llvm::Value* orig = llvm::ExtractElementInst::Create(baseVec, fieldIdx, "Extract Element", irgen->GetBasicBlock());
+	llvm::Constant* val = init->Fold();
+	if(val == NULL) {
+		return NULL;
+	}
+	// the builder folds a conversion of a constant
+	return llvm::dyn_cast_or_null<llvm::Constant>(ConvertInitializer(val, init->GetType(), to));
+}
 
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-				llvm::Value *inst = llvm::BinaryOperator::CreateFAdd(orig, val, "FAdd", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::InsertElementInst::Create(baseVec, inst, fieldIdx, "Insert Vector", irgen->GetBasicBlock());
+llvm::Value* EmitInitializer(Expr *init, Type *to, Identifier *id) {
+	InitializerList* list = dynamic_cast<InitializerList*>(init);
+	if(list != NULL) {
+		return list->Emit();
+	}
 
-				new llvm::StoreInst(newVec, tempVal, irgen->GetBasicBlock());
+	llvm::Value* val = init->Emit();
+	if(val == NULL) {
+		return NULL;
+	}
+	llvm::Value* converted = ConvertInitializer(val, init->GetType(), to);
+	if(converted == NULL) {
+		ReportError::InvalidInitialization(id, to, init->GetType() != NULL ? init->GetType() : Type::errorType);
+	}
+	return converted;
+}
 
-				return l;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-				llvm::Value* inst = llvm::BinaryOperator::CreateFAdd(l, val, "FInc", irgen->GetBasicBlock());
-
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(left);
-
-				llvm::Value* ret = new llvm::StoreInst(inst, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return l;
-			}
-		}
-		else if(op->IsOp("--")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-				llvm::Value *inst = llvm::BinaryOperator::CreateFSub(vExprInst, val, "FSub", irgen->GetBasicBlock());
-
-				new llvm::StoreInst(inst,ptr, "Store Element", irgen->GetBasicBlock());
-
-				return l;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* dynamcast = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-
-				llvm::Value* baseVec = dynamcast->base->Emit();
-				llvm::Value* fieldIdx;
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				string swiz = string(dynamcast->field->GetName());
-
-				if(swiz.length() == 1) {
-					if(swiz[0] == 'x') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[0] == 'y') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[0] == 'z') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[0] == 'w') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-				}
-
-				llvm::Value* orig = llvm::ExtractElementInst::Create(baseVec, fieldIdx, "Extract Element", irgen->GetBasicBlock());
-
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-				llvm::Value *inst = llvm::BinaryOperator::CreateFSub(orig, val, "FSub", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::InsertElementInst::Create(baseVec, inst, fieldIdx, "Insert Vector", irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVec, tempVal, irgen->GetBasicBlock());
-
-				return l;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-				llvm::Value* inst = llvm::BinaryOperator::CreateFSub(l, val, "FDec", irgen->GetBasicBlock());
-
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(left);
-
-				new llvm::StoreInst(inst, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(varexpr->GetIdentifier()->GetName()));
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, varexpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return l;
-			}
-		}
-	}
-	else if(left->GetType() == Type::vec2Type) {
-		this->type = Type::vec4Type;
-
-		if(op->IsOp("++")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);	
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(oldVal,val,"FAdd",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return l;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-
-				llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, val, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, val, "FAdd", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
-
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-
-				VarExpr* varexpr = dynamic_cast<VarExpr*>(left);
-
-				new llvm::StoreInst(newVec2, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
-
-				return l;
-			}
-		}
-		else if(op->IsOp("--")) {
-			llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-			llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-
-			llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-
-			llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, val, "FSub", irgen->GetBasicBlock());
-			llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, val, "FSub", irgen->GetBasicBlock());
-
-			llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
-
-			llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-			llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-
-			VarExpr* varexpr = dynamic_cast<VarExpr*>(left);
-
-			new llvm::StoreInst(newVec2, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
-
-			return l;
-		}
-	}
-	else if(left->GetType() == Type::vec3Type) {
-		this->type = Type::vec3Type;
-
-		if(op->IsOp("++")) {
-			llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-			llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-			llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-
-			llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-
-			llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, val, "FAdd", irgen->GetBasicBlock());
-			llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, val, "FAdd", irgen->GetBasicBlock());
-			llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(z, val, "FAdd", irgen->GetBasicBlock());
-
-			llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
-
-			llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-			llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-			llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-
-			VarExpr* varexpr = dynamic_cast<VarExpr*>(left);
-
-			new llvm::StoreInst(newVec3, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
-
-			return l;
-		}
-		else if(op->IsOp("--")) {
-			llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-			llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-			llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-
-			llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-
-			llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, val, "FSub", irgen->GetBasicBlock());
-			llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, val, "FSub", irgen->GetBasicBlock());
-			llvm::Value* newz = llvm::BinaryOperator::CreateFSub(z, val, "FSub", irgen->GetBasicBlock());
-
-			llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
-
-			llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-			llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-			llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-
-			VarExpr* varexpr = dynamic_cast<VarExpr*>(left);
-
-			new llvm::StoreInst(newVec3, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
-
-			return l;
-		}
-	}
-	else if(left->GetType() == Type::vec4Type) {
-		this->type = Type::vec4Type;
-
-		if(op->IsOp("++")) {
-			llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-			llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-			llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-			llvm::Value* w = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-
-			llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-
-			llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, val, "FAdd", irgen->GetBasicBlock());
-			llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, val, "FAdd", irgen->GetBasicBlock());
-			llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(z, val, "FAdd", irgen->GetBasicBlock());
-			llvm::Value* neww = llvm::BinaryOperator::CreateFAdd(w, val, "FAdd", irgen->GetBasicBlock());
-
-			llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
-
-			llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-			llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-			llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-			llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
-
-			VarExpr* varexpr = dynamic_cast<VarExpr*>(left);
-
-			new llvm::StoreInst(newVec4, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
-
-			return l;
-		}
-		else if(op->IsOp("--")) {
-			llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-			llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-			llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-			llvm::Value* w = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-
-			llvm::Value *val = llvm::ConstantFP::get(irgen->GetFloatType(), 1);
-
-			llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, val, "FSub", irgen->GetBasicBlock());
-			llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, val, "FSub", irgen->GetBasicBlock());
-			llvm::Value* newz = llvm::BinaryOperator::CreateFSub(z, val, "FSub", irgen->GetBasicBlock());
-			llvm::Value* neww = llvm::BinaryOperator::CreateFSub(w, val, "FSub", irgen->GetBasicBlock());
-
-			llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
-
-			llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-			llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-			llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-			llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
-
-			VarExpr* varexpr = dynamic_cast<VarExpr*>(left);
-
-			new llvm::StoreInst(newVec4, symtab->val_search(string(varexpr->GetIdentifier()->GetName())), irgen->GetBasicBlock());
-
-			return l;
-		}
-	}
-
-	return NULL;
-}
-
-llvm::Value* AssignExpr::Emit() {
-	//TODO emitting left might be wrong dunno what to do with it
-	
-	llvm::Value* r = right->Emit();
-	llvm::Value* l = left->Emit();
-
-	if(left->GetType() == Type::intType) {
-		this->type = Type::intType;
-
-		if(op->IsOp("=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				//llvm::Value* mem = base->Emit();
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-	
-				//return new llvm::StoreInst(r,ptr, "Store Element", irgen->GetBasicBlock());
-				new llvm::StoreInst(r,ptr, "Store Element", irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-			
-				new llvm::StoreInst(r, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("+=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				//llvm::Value* mem = base->Emit();
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateAdd(l, r, "IAddA", irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal,ptr, "Store Element", irgen->GetBasicBlock());
-			
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* newVal = llvm::BinaryOperator::CreateAdd(l, r, "IAddA", irgen->GetBasicBlock());
-
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("*=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				//llvm::Value* mem = base->Emit();
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateMul(l, r, "IMulA", irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal,ptr, "Store Element", irgen->GetBasicBlock());
-			
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* newVal = llvm::BinaryOperator::CreateMul(l, r, "IMulA", irgen->GetBasicBlock());
-
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("-=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				//llvm::Value* mem = base->Emit();
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateSub(l, r, "ISubA", irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal,ptr, "Store Element", irgen->GetBasicBlock());
-			
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* newVal = llvm::BinaryOperator::CreateSub(l, r, "ISubA", irgen->GetBasicBlock());
-
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("/=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				//llvm::Value* mem = base->Emit();
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateSDiv(l, r, "IDivA", irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal,ptr, "Store Element", irgen->GetBasicBlock());
-			
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* newVal = llvm::BinaryOperator::CreateSDiv(l, r, "IDivA", irgen->GetBasicBlock());
-
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-	}
-	else if(left->GetType() == Type::floatType) {
-		this->type = Type::floatType;
-
-		if(op->IsOp("=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-	
-				new llvm::StoreInst(r,ptr, "Store Element", irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* dynamcast = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-
-				llvm::Value* baseVec = dynamcast->base->Emit();
-				llvm::Value* fieldIdx;
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				string swiz = string(dynamcast->field->GetName());
-
-				if(swiz.length() == 1) {
-					if(swiz[0] == 'x') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[0] == 'y') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[0] == 'z') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[0] == 'w') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-				}
-
-				llvm::Value* newVec = llvm::InsertElementInst::Create(baseVec, r, fieldIdx, "Insert Vector", irgen->GetBasicBlock());
-				
-				new llvm::StoreInst(newVec, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return llvm::ExtractElementInst::Create(vExprInst, fieldIdx, "Extract Element", irgen->GetBasicBlock());
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-			
-				new llvm::StoreInst(r, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("+=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(l, r, "FAddA", irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal,ptr, "Store Element", irgen->GetBasicBlock());
-			
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* dynamcast = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-
-				llvm::Value* baseVec = dynamcast->base->Emit();
-				llvm::Value* fieldIdx = NULL;
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				string swiz = string(dynamcast->field->GetName());
-
-				if(swiz.length() == 1) {
-					if(swiz[0] == 'x') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[0] == 'y') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[0] == 'z') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[0] == 'w') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-				}
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(l,r,"FAddA", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::InsertElementInst::Create(baseVec,newVal,fieldIdx,"Insert Element",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVec, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return llvm::ExtractElementInst::Create(vExprInst, fieldIdx, "Extract Element", irgen->GetBasicBlock());
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(l, r, "FAddA", irgen->GetBasicBlock());
-
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("*=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(l, r, "FMulA", irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal,ptr, "Store Element", irgen->GetBasicBlock());
-			
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* dynamcast = dynamic_cast<FieldAccess*>(left);
-
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-
-				llvm::Value* baseVec = dynamcast->base->Emit();
-				llvm::Value* fieldIdx = NULL;
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				string swiz = string(dynamcast->field->GetName());
-
-				if(swiz.length() == 1) {
-					if(swiz[0] == 'x') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[0] == 'y') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[0] == 'z') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[0] == 'w') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-				}
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(l,r,"FMulA", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::InsertElementInst::Create(baseVec,newVal,fieldIdx,"Insert Element",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVec, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return llvm::ExtractElementInst::Create(vExprInst, fieldIdx, "Extract Element", irgen->GetBasicBlock());
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(l, r, "FMulA", irgen->GetBasicBlock());
-
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-
-		}
-		else if(op->IsOp("-=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(l, r, "FSubA", irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal,ptr, "Store Element", irgen->GetBasicBlock());
-			
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* dynamcast = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-
-				llvm::Value* baseVec = dynamcast->base->Emit();
-				llvm::Value* fieldIdx = NULL;
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				string swiz = string(dynamcast->field->GetName());
-
-				if(swiz.length() == 1) {
-					if(swiz[0] == 'x') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[0] == 'y') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[0] == 'z') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[0] == 'w') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-				}
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(l,r,"FSubA", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::InsertElementInst::Create(baseVec,newVal,fieldIdx,"Insert Element",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVec, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return llvm::ExtractElementInst::Create(vExprInst, fieldIdx, "Extract Element", irgen->GetBasicBlock());
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(l, r, "FSubA", irgen->GetBasicBlock());
-
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("/=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* dynamcast = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = dynamcast->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = dynamcast->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(l, r, "FDivA", irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal,ptr, "Store Element", irgen->GetBasicBlock());
-			
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* dynamcast = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(dynamcast->base);
-
-				llvm::Value* baseVec = dynamcast->base->Emit();
-				llvm::Value* fieldIdx = NULL;
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				string swiz = string(dynamcast->field->GetName());
-
-				if(swiz.length() == 1) {
-					if(swiz[0] == 'x') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[0] == 'y') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[0] == 'z') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[0] == 'w') {
-						fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-				}
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(l,r,"FDivA", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::InsertElementInst::Create(baseVec,newVal,fieldIdx,"Insert Element",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVec, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return llvm::ExtractElementInst::Create(vExprInst, fieldIdx, "Extract Element", irgen->GetBasicBlock());
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(l, r, "FDivA", irgen->GetBasicBlock());
-
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-	}
-	else if(left->GetType() == Type::vec2Type && right->GetType() == Type::vec2Type) {
-		this->type = Type::vec2Type;
-
-		if(op->IsOp("=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				
-				llvm::Value* baseEmit = a->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = a->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-	
-				new llvm::StoreInst(r,ptr, "Store Element", irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-				
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,val,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(r, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("+=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(l,r,"VecFAdd",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(oldVal,val,"FAdd",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(l,r,"VecFAdd",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("-=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(l,r,"VecFSub",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(oldVal,val,"FSub",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(l,r,"VecFSub",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("*=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(l,r,"VecFMul",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(oldVal,val,"FMul",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(l,r,"VecFMul",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("/=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(l,r,"VecFDiv",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(oldVal,val,"FDiv",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(l,r,"VecFDiv",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-	}
-	else if(left->GetType() == Type::vec3Type && right->GetType() == Type::vec3Type) {
-		this->type = Type::vec3Type;
-
-		if(op->IsOp("=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				
-				llvm::Value* baseEmit = a->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = a->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-	
-				new llvm::StoreInst(r,ptr, "Store Element", irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-				
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,val,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}		
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(r, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("+=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(l,r,"VecFAdd",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(oldVal,val,"FAdd",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(l,r,"VecFAdd",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("-=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(l,r,"VecFSub",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(oldVal,val,"FSub",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(l,r,"VecFSub",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("*=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(l,r,"VecFMul",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(oldVal,val,"FMul",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(l,r,"VecFMul",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("/=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(l,r,"VecFDiv",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(oldVal,val,"FDiv",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(l,r,"VecFDiv",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-	}
-	else if(left->GetType() == Type::vec4Type && right->GetType() == Type::vec4Type) {
-		this->type = Type::vec4Type;
-
-		if(op->IsOp("=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				
-				llvm::Value* baseEmit = a->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-	
-				llvm::Value* num = a->subscript->Emit();
-	
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-	
-				new llvm::StoreInst(r,ptr, "Store Element", irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-				
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,val,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(r, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("+=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(l,r,"VecFAdd",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(oldVal,val,"FAdd",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(l,r,"VecFAdd",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("-=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(l,r,"VecFSub",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(oldVal,val,"FSub",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(l,r,"VecFSub",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("*=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(l,r,"VecFMul",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(oldVal,val,"FMul",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(l,r,"VecFMul",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("/=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(l,r,"VecFDiv",irgen->GetBasicBlock());
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, baseExpr->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), i);
-					llvm::Value* val = llvm::ExtractElementInst::Create(r,fieldIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* insertIdx = NULL;
-
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(oldVal,val,"FAdd",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(l,r,"VecFDiv",irgen->GetBasicBlock());
-
-				new llvm::StoreInst(newVal, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-	}
-	else if(left->GetType() == Type::vec2Type && right->GetType() == Type::floatType) {
-		this->type = Type::vec2Type;
-
-		if(op->IsOp("+=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(oldVal,r,"FAdd",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, r, "FAdd", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVec2, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("-=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(oldVal,r,"FSub",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-	
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, r, "FSub", irgen->GetBasicBlock());
-		
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-					
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-	
-				new llvm::StoreInst(newVec2, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("*=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(oldVal,r,"FMul",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(x, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(y, r, "FMul", irgen->GetBasicBlock());
-	
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-					
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVec2, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("/=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(oldVal,r,"FDiv",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFDiv(x, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFDiv(y, r, "FDiv", irgen->GetBasicBlock());
-	
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 2));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVec2, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-	}
-	else if(left->GetType() == Type::vec3Type && right->GetType() == Type::floatType) {
-		this->type = Type::vec3Type;
-
-		if(op->IsOp("+=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(oldVal,r,"FAdd",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-			
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(z, r, "FAdd", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-	
-				new llvm::StoreInst(newVec3, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("-=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(oldVal,r,"FSub",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-		
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFSub(z, r, "FSub", irgen->GetBasicBlock());
-			
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-			
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVec3, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("*=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(oldVal,r,"FMul",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-			
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(x, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(y, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFMul(z, r, "FMul", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-	
-				new llvm::StoreInst(newVec3, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("/=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(oldVal,r,"FDiv",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-			
-				llvm::Value* newx = llvm::BinaryOperator::CreateFDiv(x, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFDiv(y, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFDiv(z, r, "FDiv", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 3));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-	
-				new llvm::StoreInst(newVec3, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-	}
-	else if(left->GetType() == Type::vec4Type && right->GetType() == Type::floatType) {
-		this->type = Type::vec4Type;
-
-		if(op->IsOp("+=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFAdd(oldVal,r,"FAdd",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-			
-				llvm::Value* newx = llvm::BinaryOperator::CreateFAdd(x, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFAdd(y, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFAdd(z, r, "FAdd", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFAdd(w, r, "FAdd", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
-				
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-	
-				new llvm::StoreInst(newVec4, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("-=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFSub(oldVal,r,"FSub",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-			
-				llvm::Value* newx = llvm::BinaryOperator::CreateFSub(x, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFSub(y, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFSub(z, r, "FSub", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFSub(w, r, "FSub", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
-				
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-	
-				new llvm::StoreInst(newVec4, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("*=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFMul(oldVal,r,"FMul",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-			
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-			
-				llvm::Value* newx = llvm::BinaryOperator::CreateFMul(x, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFMul(y, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFMul(z, r, "FMul", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFMul(w, r, "FMul", irgen->GetBasicBlock());
-				
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
-				
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-	
-				new llvm::StoreInst(newVec4, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-		else if(op->IsOp("/=")) {
-			if(dynamic_cast<FieldAccess*>(left) != NULL) {
-				FieldAccess* d = dynamic_cast<FieldAccess*>(left);
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(d->base);
-				string swiz = string(d->field->GetName());
-				llvm::Value* baseMem = d->base->Emit();
-
-				for(int i = 0; i < swiz.length(); i++) {
-					llvm::Value* insertIdx;
-					if(swiz[i] == 'x') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-					}
-					else if(swiz[i] == 'y') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-					}
-					else if(swiz[i] == 'z') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-					}
-					else if(swiz[i] == 'w') {
-						insertIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-					}
-					else {
-					}
-
-					llvm::Value* oldVal = llvm::ExtractElementInst::Create(baseMem,insertIdx,"Extract Element",irgen->GetBasicBlock());
-					llvm::Value* newVal = llvm::BinaryOperator::CreateFDiv(oldVal,r,"FDiv",irgen->GetBasicBlock());
-
-					baseMem = llvm::InsertElementInst::Create(baseMem,newVal,insertIdx,"Insert Element",irgen->GetBasicBlock());
-				}
-
-				llvm::Value* tempVal = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-				new llvm::StoreInst(baseMem, tempVal, irgen->GetBasicBlock());
-
-				return baseMem;
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				llvm::Value* x = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),0),"Access x", irgen->GetBasicBlock());
-				llvm::Value* y = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),1),"Access y", irgen->GetBasicBlock());
-				llvm::Value* z = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),2),"Access z", irgen->GetBasicBlock());
-				llvm::Value* w = llvm::ExtractElementInst::Create(l,llvm::ConstantInt::get(irgen->GetIntType(),3),"Access w", irgen->GetBasicBlock());
-
-				llvm::Value* newx = llvm::BinaryOperator::CreateFDiv(x, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newy = llvm::BinaryOperator::CreateFDiv(y, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* newz = llvm::BinaryOperator::CreateFDiv(z, r, "FDiv", irgen->GetBasicBlock());
-				llvm::Value* neww = llvm::BinaryOperator::CreateFDiv(w, r, "FDiv", irgen->GetBasicBlock());
-
-				llvm::Value* newVec = llvm::Constant::getNullValue(llvm::VectorType::get(llvm::Type::getFloatTy(*irgen->GetContext()), 4));
-				llvm::Value* newVec1 = llvm::InsertElementInst::Create(newVec, newx, llvm::ConstantInt::get(irgen->GetIntType(),0), "Insert x", irgen->GetBasicBlock());
-				llvm::Value* newVec2 = llvm::InsertElementInst::Create(newVec1, newy, llvm::ConstantInt::get(irgen->GetIntType(),1), "Insert y", irgen->GetBasicBlock());
-				llvm::Value* newVec3 = llvm::InsertElementInst::Create(newVec2, newz, llvm::ConstantInt::get(irgen->GetIntType(),2), "Insert z", irgen->GetBasicBlock());
-				llvm::Value* newVec4 = llvm::InsertElementInst::Create(newVec3, neww, llvm::ConstantInt::get(irgen->GetIntType(),3), "Insert w", irgen->GetBasicBlock());
-
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(newVec4, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-	}
-	else if ( left->GetType() == Type::boolType ) {
-		if(op->IsOp("=")) {
-			if(dynamic_cast<ArrayAccess*>(left) != NULL) {
-				ArrayAccess* a = dynamic_cast<ArrayAccess*>(left);
-
-				llvm::Value* baseEmit = a->base->Emit();
-				VarExpr* baseExpr = dynamic_cast<VarExpr*>(a->base);
-				llvm::Value* mem = symtab->val_search(string(baseExpr->GetIdentifier()->GetName()));
-
-				llvm::Value* num = a->subscript->Emit();
-
-				vector<llvm::Value*> indices;
-				indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-				indices.push_back(num);
-				llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-				llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-
-				new llvm::StoreInst(r,ptr, "Store Element", irgen->GetBasicBlock());
-
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(ptr, "Load", irgen->GetBasicBlock());
-				return vExprInst;
-			}
-			else if(dynamic_cast<FieldAccess*>(left) != NULL) {
-			}
-			else if(dynamic_cast<VarExpr*>(left) != NULL) {
-				VarExpr* dynamcast = dynamic_cast<VarExpr*>(left);
-				llvm::Value* tempVal = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-				new llvm::StoreInst(r, tempVal, irgen->GetBasicBlock());
-				llvm::LoadInst* vExprInst = new llvm::LoadInst(tempVal, dynamcast->GetIdentifier()->GetName(), irgen->GetBasicBlock());
-				return vExprInst;
-			}
-		}
-	}
-
-	return NULL;
-}
-
-CompoundExpr::CompoundExpr(Expr *l, Operator *o, Expr *r) 
-	: Expr(Join(l->GetLocation(), r->GetLocation())) {
-		Assert(l != NULL && o != NULL && r != NULL);
-		(op=o)->SetParent(this);
-		(left=l)->SetParent(this); 
-		(right=r)->SetParent(this);
-	}
-
-CompoundExpr::CompoundExpr(Operator *o, Expr *r) 
-	: Expr(Join(o->GetLocation(), r->GetLocation())) {
-		Assert(o != NULL && r != NULL);
-		left = NULL; 
-		(op=o)->SetParent(this);
-		(right=r)->SetParent(this);
-	}
-
-CompoundExpr::CompoundExpr(Expr *l, Operator *o) 
-	: Expr(Join(l->GetLocation(), o->GetLocation())) {
-		Assert(l != NULL && o != NULL);
-		(left=l)->SetParent(this);
-		(op=o)->SetParent(this);
-	}
-
-void CompoundExpr::PrintChildren(int indentLevel) {
-	if (left) left->Print(indentLevel+1);
-	op->Print(indentLevel+1);
-	if (right) right->Print(indentLevel+1);
-}
-
-ConditionalExpr::ConditionalExpr(Expr *c, Expr *t, Expr *f)
-	: Expr(Join(c->GetLocation(), f->GetLocation())) {
-		Assert(c != NULL && t != NULL && f != NULL);
-		(cond=c)->SetParent(this);
-		(trueExpr=t)->SetParent(this);
-		(falseExpr=f)->SetParent(this);
-	}
-
-void ConditionalExpr::PrintChildren(int indentLevel) {
-	cond->Print(indentLevel+1, "(cond) ");
-	trueExpr->Print(indentLevel+1, "(true) ");
-	falseExpr->Print(indentLevel+1, "(false) ");
-}
-
-llvm::Value* ArrayAccess::Emit() {
-	llvm::Value* baseEmit = base->Emit();
-	VarExpr* dynamcast = dynamic_cast<VarExpr*>(base);
-	llvm::Value* mem = symtab->val_search(string(dynamcast->GetIdentifier()->GetName()));
-
-	ArrayType* fullType = dynamic_cast<ArrayType*>(dynamcast->GetType());
-
-	if(fullType != NULL) {
-		this->type = fullType->GetElemType();
-	}
-
-	//llvm::Value* mem = base->Emit();
-	llvm::Value* num = subscript->Emit();
-
-	vector<llvm::Value*> indices;
-	indices.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-	indices.push_back(num);
-	llvm::ArrayRef<llvm::Value*> indRef = llvm::ArrayRef<llvm::Value*>(indices);
-
-	llvm::Value* ptr = llvm::GetElementPtrInst::Create(mem, indRef, "Array Access", irgen->GetBasicBlock());
-	
-	return new llvm::LoadInst(ptr, "Load Element", irgen->GetBasicBlock());
-}
-
-ArrayAccess::ArrayAccess(yyltype loc, Expr *b, Expr *s) : LValue(loc) {
-	(base=b)->SetParent(this); 
-	(subscript=s)->SetParent(this);
-}
-
-void ArrayAccess::PrintChildren(int indentLevel) {
-	base->Print(indentLevel+1);
-	subscript->Print(indentLevel+1, "(subscript) ");
-}
-
-FieldAccess::FieldAccess(Expr *b, Identifier *f) 
-	: LValue(b? Join(b->GetLocation(), f->GetLocation()) : *f->GetLocation()) {
-		Assert(f != NULL); // b can be be NULL (just means no explicit base)
-		base = b; 
-		if (base) base->SetParent(this); 
-		(field=f)->SetParent(this);
-	}
-
-
-void FieldAccess::PrintChildren(int indentLevel) {
-	if (base) base->Print(indentLevel+1);
-	field->Print(indentLevel+1);
-}
-
-llvm::Value* FieldAccess::Emit() {
-	//TODO @1453
-	llvm::Value* baseVal = base->Emit();
-	llvm::Value* fieldIdx;
-	string swiz = string(field->GetName());
-	std::vector<llvm::Constant*> swizzles;
-
-	if (swiz.length() == 1) {
-		this->type = Type::floatType;
-	}
-	else if (swiz.length() == 2) {
-		this->type = Type::vec2Type;
-	}
-	else if (swiz.length() == 3) {
-		this->type = Type::vec3Type;
-	}
-	else if (swiz.length() == 4) {
-		this->type = Type::vec4Type;
-	}
-	else {
-		return NULL;
+void ReportUnfolded(Expr *init, Type *to, Identifier *id) {
+	InitializerList* list = dynamic_cast<InitializerList*>(init);
+	if(list != NULL) {
+		list->ReportUnfolded();
 	}
-
-
-	if (swiz.length() == 1) {
-		if(swiz[0] == 'x') {
-			fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-		}
-		else if(swiz[0] == 'y') {
-			fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-		}
-		else if(swiz[0] == 'z') {
-			fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-		}
-		else if(swiz[0] == 'w') {
-			fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-		}
-		return llvm::ExtractElementInst::Create(baseVal, fieldIdx, "Field Access", irgen->GetBasicBlock());
-
+	else if(init->Fold() == NULL) {
+		ReportError::Formatted(init->GetLocation(), "initializer of global variable '%s' is not constant", id->GetName());
 	}
-
 	else {
-		for(int i = 0; i < swiz.length(); i++) {
-			if(swiz[i] == 'x') {
-				fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 0);
-				swizzles.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 0));
-			}
-			else if(swiz[i] == 'y') {
-				fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 1);
-				swizzles.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 1));
-			}
-			else if(swiz[i] == 'z') {
-				fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 2);
-				swizzles.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 2));
-			}
-			else if(swiz[i] == 'w') {
-				fieldIdx = llvm::ConstantInt::get(irgen->GetIntType(), 3);
-				swizzles.push_back(llvm::ConstantInt::get(irgen->GetIntType(), 3));
-			}
-		}
-
-		VarExpr* dynam = dynamic_cast<VarExpr*>(base);
-		if(dynam != NULL) {
-			llvm::Value* tempVal = symtab->val_search(string(dynam->GetIdentifier()->GetName()));
-
-			llvm::LoadInst* vecVal = new llvm::LoadInst(tempVal, field->GetName(), irgen->GetBasicBlock());
-			llvm::UndefValue* undef = llvm::UndefValue::get(baseVal->getType());
-	
-			llvm::ArrayRef<llvm::Constant*> swizzleArrayRef(swizzles);
-			llvm::Constant *mask = llvm::ConstantVector::get(swizzleArrayRef);
-			return new llvm::ShuffleVectorInst(vecVal, undef, mask, "Shuffle Vector", irgen->GetBasicBlock());
-		}
-		else if(dynamic_cast<FieldAccess*>(base)) {
-			llvm::UndefValue* undef = llvm::UndefValue::get(baseVal->getType());
-	
-			llvm::ArrayRef<llvm::Constant*> swizzleArrayRef(swizzles);
-			llvm::Constant *mask = llvm::ConstantVector::get(swizzleArrayRef);
-			return new llvm::ShuffleVectorInst(baseVal, undef, mask, "Shuffle Vector", irgen->GetBasicBlock());
-		}
-		else if(dynamic_cast<ArrayAccess*>(base)) {
-			llvm::UndefValue* undef = llvm::UndefValue::get(baseVal->getType());
-	
-			llvm::ArrayRef<llvm::Constant*> swizzleArrayRef(swizzles);
-			llvm::Constant *mask = llvm::ConstantVector::get(swizzleArrayRef);
-			return new llvm::ShuffleVectorInst(baseVal, undef, mask, "Shuffle Vector", irgen->GetBasicBlock());
-		}
-		else {
-			llvm::UndefValue* undef = llvm::UndefValue::get(baseVal->getType());
-	
-			llvm::ArrayRef<llvm::Constant*> swizzleArrayRef(swizzles);
-			llvm::Constant *mask = llvm::ConstantVector::get(swizzleArrayRef);
-			return new llvm::ShuffleVectorInst(baseVal, undef, mask, "Shuffle Vector", irgen->GetBasicBlock());
-		}	
-
-		return NULL;
-	}
-
-}	
-
-Call::Call(yyltype loc, Expr *b, Identifier *f, List<Expr*> *a) : Expr(loc)  {
-	Assert(f != NULL && a != NULL); // b can be be NULL (just means no explicit base)
-	base = b;
-	if (base) base->SetParent(this);
-	(field=f)->SetParent(this);
-	(actuals=a)->SetParentAll(this);
-}
-
-void Call::PrintChildren(int indentLevel) {
-	if (base) base->Print(indentLevel+1);
-	if (field) field->Print(indentLevel+1);
-	if (actuals) actuals->PrintAll(indentLevel+1, "(actuals) ");
-}
-
-llvm::Value* LogicalExpr::Emit() {
-	llvm::Value* rVal = right->Emit();
-	llvm::Value* lVal = left->Emit();
-	this->type == Type::boolType;
-
-	if(op->IsOp("&&")) {
-		return llvm::BinaryOperator::CreateAnd(lVal, rVal, "LogicalAnd", irgen->GetBasicBlock());
-	}
-	else if(op->IsOp("||")) {
-		return llvm::BinaryOperator::CreateOr(lVal, rVal, "LogicalOr", irgen->GetBasicBlock());
-	}
-
-	return NULL;
-}
-
-llvm::Value* ConditionalExpr::Emit() {
-	llvm::LLVMContext *context = irgen->GetContext();
-	llvm::Function *f = irgen->GetFunction();
-	llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context,"Footer Block",f);
-	llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context,"Then Block",f);
-	llvm::BasicBlock *eb = llvm::BasicBlock::Create(*context,"Else Block",f);
-	llvm::BasicBlock *cur = irgen->GetBasicBlock();
-	llvm::Value *co = cond->Emit();
-
-	llvm::BranchInst::Create(bb,eb,co,cur);
-
-	symtab->push_scope(SymbolTable::Block);
-	irgen->SetBasicBlock(bb);
-	llvm::Value *truEx = trueExpr->Emit();
-	llvm::BasicBlock *trueParent = irgen->GetBasicBlock();
-	if(irgen->GetBasicBlock()->getTerminator() == NULL) {
-		llvm::BranchInst::Create(fb,irgen->GetBasicBlock());
+		ReportError::InvalidInitialization(id, to, init->GetType() != NULL ? init->GetType() : Type::errorType);
 	}
-	symtab->pop_scope();
-
-	symtab->push_scope(SymbolTable::Block);
-	irgen->SetBasicBlock(eb);
-	llvm::Value *falEx = falseExpr->Emit();
-	llvm::BasicBlock *falseParent = irgen->GetBasicBlock();
-	if(irgen->GetBasicBlock()->getTerminator() == NULL) {
-		llvm::BranchInst::Create(fb,irgen->GetBasicBlock());
-	}
-	symtab->pop_scope();
-
-	irgen->SetBasicBlock(fb);
-
-	llvm::PHINode *phi = llvm::PHINode::Create(truEx->getType(), 2, "phinode", fb);
-	phi->addIncoming(truEx, trueParent);
-	phi->addIncoming(falEx, falseParent);
-
-	return phi;
-	//return llvm::SelectInst::Create(cond->Emit(), trueExpr->Emit(), falseExpr->Emit(), "Conditional Expression", irgen->GetBasicBlock());
-}
-
-llvm::Value* Call::Emit() {
-	std::vector<llvm::Value*> argTypes;
-
-	for(int i = 0; i < actuals->NumElements(); i++) {
-		argTypes.push_back(actuals->Nth(i)->Emit());
-	}
-
-	llvm::ArrayRef<llvm::Value*> argArray(argTypes);
-
-	llvm::Value* tempVal = symtab->val_search(string(field->GetName()));
-	Decl* tempDecl = symtab->search_scope(string(field->GetName()));
-	FnDecl* dynamcast = dynamic_cast<FnDecl*>(tempDecl);
-
-	this->type = dynamcast->GetType();
-
-	return llvm::CallInst::Create(tempVal, argArray, "Function Call", irgen->GetBasicBlock());
 }
@@ -29,13 +29,38 @@ class Expr : public Stmt
   public:
     Type* type;
     Type* GetType() {return type;}
-    Expr(yyltype loc) : Stmt(loc) {}
-    Expr() : Stmt() {}
+    Expr(yyltype loc) : Stmt(loc), valueUsed(true) {}
+    Expr() : Stmt(), valueUsed(true) {}
     virtual llvm::Type* EmitType() {return NULL;}
 
+    // Marks the expression as evaluated only for its side effects (an
+    // expression statement, or the step of a for loop).  Emit() then
+    // leaves out the work whose only purpose is computing the value and
+    // returns NULL.  Only done under -flean-ir.
+    void DiscardValue() {valueUsed = false;}
+    bool IsValueUsed() {return valueUsed;}
+
+    // Returns the value of the expression if it can be computed while
+    // compiling, from literals and const variables, or NULL if it can't.
+    // Sets the type as Emit() does, but emits nothing and reports no
+    // errors, so it is safe to try before emitting.
+    virtual llvm::Constant* Fold() {return NULL;}
+
+    // IsPure() is true if evaluating the expression has no effect but
+    // its value: no stores or calls, and nothing that can trap, such as
+    // an integer division or an array index not known to be in bounds.
+    // A pure expression may be evaluated where the program would not
+    // have evaluated it.  Cost() is a rough count of the instructions it
+    // takes; both are used to lower && || and ?: without branches.
+    virtual bool IsPure() {return false;}
+    virtual int Cost() {return 1;}
+
     friend std::ostream& operator<< (std::ostream& stream, Expr * expr) {
         return stream << expr->GetPrintNameForNode();
     }
+
+  protected:
+    bool valueUsed;
 };
 
 class ExprError : public Expr
@@ -68,6 +93,26 @@ class IntConstant : public Expr
     int GetValue() {return value;}
     virtual llvm::Type* EmitType();
     virtual llvm::Value* Emit();
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure() {return true;}
+    virtual int Cost() {return 0;}
+};
+
+class UintConstant : public Expr 
+{
+  protected:
+    unsigned int value;
+  
+  public:
+    UintConstant(yyltype loc, unsigned int val);
+    const char *GetPrintNameForNode() { return "UintConstant"; }
+    void PrintChildren(int indentLevel);
+    unsigned int GetValue() {return value;}
+    virtual llvm::Type* EmitType();
+    virtual llvm::Value* Emit();
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure() {return true;}
+    virtual int Cost() {return 0;}
 };
 
 class FloatConstant: public Expr 
@@ -82,6 +127,9 @@ class FloatConstant: public Expr
     double GetValue() {return value;}
     virtual llvm::Type* EmitType();
     virtual llvm::Value* Emit();
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure() {return true;}
+    virtual int Cost() {return 0;}
 };
 
 class BoolConstant : public Expr 
@@ -96,9 +144,50 @@ class BoolConstant : public Expr
     bool GetValue() {return value;}
     virtual llvm::Type* EmitType();
     virtual llvm::Value* Emit();
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure() {return true;}
+    virtual int Cost() {return 0;}
+};
+
+/* An LValueRef is the storage an lvalue names, worked out once: the
+ * address of the variable or array element, and for a swizzle the lanes
+ * of the vector stored there that it selects.  Assignments, compound
+ * assignments and increments read and write the target through one
+ * LValueRef, so its base and subscript are only emitted once and the
+ * vector under a swizzle is only loaded once.  A single lane of a vector
+ * in memory, such as a[i].y, is loaded and stored on its own.
+ */
+class LValueRef
+{
+  public:
+    llvm::Value *addr;
+    llvm::Type *type;       // of the value at addr once loaded, which may
+                            // be stored as half or padded
+    vector<int> lanes;      // empty unless a swizzle selects part of a vector
+    bool readOnly;          // names a const variable
+
+    LValueRef() : addr(NULL), type(NULL), readOnly(false), whole(NULL) {}
+    llvm::Value* Load();
+    void Store(llvm::Value *val);
+
+  private:
+    llvm::Value *whole;     // the vector at addr, once loaded or stored
+
+    llvm::Value* LaneAddress();
+};
+
+class LValue : public Expr 
+{
+  public:
+    LValue(yyltype loc) : Expr(loc) {}
+
+    // Emits the address of the storage this expression names and sets
+    // its type.  Returns false if it does not name storage (e.g. a
+    // swizzle of a call result).
+    virtual bool EmitLValue(LValueRef *ref) = 0;
 };
 
-class VarExpr : public Expr
+class VarExpr : public LValue
 {
   protected:
     Identifier *id;
@@ -109,6 +198,10 @@ class VarExpr : public Expr
     void PrintChildren(int indentLevel);
     Identifier *GetIdentifier() {return id;}
     virtual llvm::Value* Emit();
+    virtual bool EmitLValue(LValueRef *ref);
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure() {return true;}
+    virtual int Cost() {return 1;}
 };
 
 class Operator : public Node 
@@ -135,6 +228,13 @@ class CompoundExpr : public Expr
     CompoundExpr(Operator *op, Expr *rhs);             // for unary
     CompoundExpr(Expr *lhs, Operator *op);             // for unary
     void PrintChildren(int indentLevel);
+    Operator* GetOp() {return op;}
+    Expr* GetLeft() {return left;}
+    Expr* GetRight() {return right;}
+    void GetChildren(vector<Node*> *children);
+
+  protected:
+    llvm::Value* EmitOperandsForEffect();
 };
 
 class ArithmeticExpr : public CompoundExpr 
@@ -144,6 +244,9 @@ class ArithmeticExpr : public CompoundExpr
     ArithmeticExpr(Operator *op, Expr *rhs) : CompoundExpr(op,rhs) {}
     const char *GetPrintNameForNode() { return "ArithmeticExpr"; }
     virtual llvm::Value* Emit();
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure();
+    virtual int Cost();
 };
 
 class RelationalExpr : public CompoundExpr 
@@ -152,6 +255,12 @@ class RelationalExpr : public CompoundExpr
     RelationalExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
     const char *GetPrintNameForNode() { return "RelationalExpr"; }
     virtual llvm::Value* Emit();
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure() {return left->IsPure() && right->IsPure();}
+    virtual int Cost() {return 1 + left->Cost() + right->Cost();}
+
+  private:
+    llvm::Value* EmitCompare(llvm::Value *l, llvm::Value *r);
 };
 
 class EqualityExpr : public CompoundExpr 
@@ -160,6 +269,12 @@ class EqualityExpr : public CompoundExpr
     EqualityExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
     const char *GetPrintNameForNode() { return "EqualityExpr"; }
     virtual llvm::Value* Emit();
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure() {return left->IsPure() && right->IsPure();}
+    virtual int Cost() {return 1 + left->Cost() + right->Cost();}
+
+  private:
+    llvm::Value* EmitCompare(llvm::Value *l, llvm::Value *r);
 };
 
 class LogicalExpr : public CompoundExpr 
@@ -169,6 +284,9 @@ class LogicalExpr : public CompoundExpr
     LogicalExpr(Operator *op, Expr *rhs) : CompoundExpr(op,rhs) {}
     const char *GetPrintNameForNode() { return "LogicalExpr"; }
     virtual llvm::Value* Emit();
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure() {return (left == NULL || left->IsPure()) && right->IsPure();}
+    virtual int Cost() {return 1 + (left ? left->Cost() : 0) + right->Cost();}
 };
 
 class AssignExpr : public CompoundExpr 
@@ -177,6 +295,11 @@ class AssignExpr : public CompoundExpr
     AssignExpr(Expr *lhs, Operator *op, Expr *rhs) : CompoundExpr(lhs,op,rhs) {}
     const char *GetPrintNameForNode() { return "AssignExpr"; }
     virtual llvm::Value* Emit();
+
+    // The target, and the value stored by a plain "=" (NULL for +=, -=,
+    // *= and /=, which also read the target).
+    Expr* GetTarget() {return left;}
+    Expr* GetStoredValue() {return op->IsOp("=") ? right : NULL;}
 };
 
 class PostfixExpr : public CompoundExpr
@@ -194,14 +317,12 @@ class ConditionalExpr : public Expr
   public:
     ConditionalExpr(Expr *c, Expr *t, Expr *f);
     void PrintChildren(int indentLevel);
+    void GetChildren(vector<Node*> *children);
     const char *GetPrintNameForNode() { return "ConditionalExpr"; }
     virtual llvm::Value* Emit();
-};
-
-class LValue : public Expr 
-{
-  public:
-    LValue(yyltype loc) : Expr(loc) {}
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure() {return cond->IsPure() && trueExpr->IsPure() && falseExpr->IsPure();}
+    virtual int Cost() {return 1 + cond->Cost() + trueExpr->Cost() + falseExpr->Cost();}
 };
 
 class ArrayAccess : public LValue 
@@ -214,7 +335,12 @@ class ArrayAccess : public LValue
     ArrayAccess(yyltype loc, Expr *base, Expr *subscript);
     const char *GetPrintNameForNode() { return "ArrayAccess"; }
     void PrintChildren(int indentLevel);
+    void GetChildren(vector<Node*> *children);
     virtual llvm::Value* Emit();
+    virtual bool EmitLValue(LValueRef *ref);
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure();
+    virtual int Cost() {return 2 + base->Cost() + subscript->Cost();}
 };
 
 /* Note that field access is used both for qualified names
@@ -233,9 +359,50 @@ class FieldAccess : public LValue
     FieldAccess(Expr *base, Identifier *field); //ok to pass NULL base
     const char *GetPrintNameForNode() { return "FieldAccess"; }
     void PrintChildren(int indentLevel);
+    void GetChildren(vector<Node*> *children);
+    virtual llvm::Value* Emit();
+    virtual bool EmitLValue(LValueRef *ref);
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure() {return base != NULL && base->IsPure();}
+    virtual int Cost() {return 1 + (base ? base->Cost() : 0);}
+};
+
+/* The brace-enclosed element list that initializes an array, as in
+ * float weights[3] = {0.25, 0.5, 0.25}.  It emits the whole array value,
+ * which VarDecl stores (or uses as the initializer of a global). */
+class InitializerList : public Expr
+{
+  protected:
+    List<Expr*> *elems;
+    ArrayType *arrayType;   // of the variable it initializes
+    Identifier *target;
+
+  public:
+    InitializerList(yyltype loc, List<Expr*> *elems);
+    const char *GetPrintNameForNode() { return "InitializerList"; }
+    void PrintChildren(int indentLevel);
+    void GetChildren(vector<Node*> *children);
+    int NumElements() { return elems->NumElements(); }
+    // Must be called before the list is emitted or folded: each element
+    // initializes an element of the array id is declared as.
+    void SetTarget(ArrayType *type, Identifier *id) { arrayType = type; target = id; }
     virtual llvm::Value* Emit();
+    virtual llvm::Constant* Fold();
+    void ReportUnfolded();
 };
 
+/* A variable's initializer takes the declared type: an int or uint
+ * value initializes a float, or an ivec or uvec a vec of the same size,
+ * converted as GLSL converts it implicitly, and any other type is an
+ * error.  FoldInitializer() returns NULL, reporting nothing, unless
+ * init is a constant of a type that converts; EmitInitializer() reports
+ * a mismatch against the declaration of id.  A global's initializer must
+ * fold, and ReportUnfolded() reports why one did not.
+ */
+llvm::Constant* FoldInitializer(Expr *init, Type *to);
+llvm::Value* EmitInitializer(Expr *init, Type *to, Identifier *id);
+void ReportUnfolded(Expr *init, Type *to, Identifier *id);
+
 /* Like field access, call is used both for qualified base.field()
  * and unqualified field().  We won't figure out until later
  * whether we need implicit "this." so we use one node type for either
@@ -252,7 +419,12 @@ class Call : public Expr
     Call(yyltype loc, Expr *base, Identifier *field, List<Expr*> *args);
     const char *GetPrintNameForNode() { return "Call"; }
     void PrintChildren(int indentLevel);
+    void GetChildren(vector<Node*> *children);
     virtual llvm::Value* Emit();
+    virtual llvm::Constant* Fold();
+    virtual bool IsPure();
+    virtual int Cost();
+    Identifier *GetCallee() {return field;}
 };
 
 class ActualsError : public Call
@@ -9,10 +9,65 @@
 #include "symtable.h"
 
 #include "irgen.h"
+#include "timer.h"
+#include "optimize.h"
+#include "inline.h"
+#include "mathlib.h"
+#include "utility.h"
+#include <string.h>
+#include <set>
+#include <map>
 #include "llvm/Bitcode/ReaderWriter.h"
 #include "llvm/Support/raw_ostream.h"
 
 
+/* Function: EmitStatement()
+ * -------------------------
+ * Emits s into the current block.  Nothing after a return, break or
+ * continue can run, so once the block has its terminator the remaining
+ * statements are skipped instead of being given a block of their own.
+ * Under -flean-ir the value of an expression statement is discarded.
+ */
+static void EmitStatement(Stmt *s) {
+	if(Node::irgen->GetBasicBlock()->getTerminator() != NULL) {
+		return;
+	}
+
+	Expr *e = dynamic_cast<Expr*>(s);
+	if(e != NULL && IsOptionOn("lean-ir")) {
+		e->DiscardValue();
+	}
+	s->Emit();
+}
+
+/* Function: BranchIfOpen()
+ * ------------------------
+ * Ends the current block with a branch to target, unless a return,
+ * break or continue has already ended it.
+ */
+static void BranchIfOpen(llvm::BasicBlock *target) {
+	if(Node::irgen->GetBasicBlock()->getTerminator() == NULL) {
+		Node::irgen->GetBuilder()->CreateBr(target);
+	}
+}
+
+/* Function: ContinueAt()
+ * ----------------------
+ * Footer blocks are created outside the function and added once the
+ * statement they follow has been emitted.  If nothing branches to the
+ * footer the code after the statement is unreachable, so the footer is
+ * dropped and the current (already terminated) block is left in place,
+ * which makes EmitStatement() skip the rest of the enclosing block.
+ */
+static void ContinueAt(llvm::BasicBlock *footer) {
+	if(footer->use_empty()) {
+		delete footer;
+		return;
+	}
+	footer->insertInto(Node::irgen->GetFunction());
+	Node::irgen->SetBasicBlock(footer);
+}
+
 Program::Program(List<Decl*> *d) {
 	Assert(d != NULL);
 	(decls=d)->SetParentAll(this);
@@ -23,12 +78,132 @@ void Program::PrintChildren(int indentLevel) {
 	printf("\n");
 }
 
+void Program::GetChildren(vector<Node*> *children) {
+	decls->AppendAllTo(children);
+}
+
 llvm::Value* DeclStmt::Emit() {
 	decl->Emit();
 
 	return NULL;
 }
 
+typedef map<string, vector<Decl*> > DeclsByName;
+
+/* Function: MarkReachable()
+ * ---------------------------
+ * Adds the top-level declarations that n names, in calls and variable
+ * references, to reachable, along with everything those name in turn.
+ * Names are not resolved through scopes, so a local that shadows a
+ * global keeps the global, which only costs an unused global.
+ */
+static void MarkReachable(Node *n, const DeclsByName &byName, set<Decl*> *reachable) {
+	Call *call = dynamic_cast<Call*>(n);
+	VarExpr *var = dynamic_cast<VarExpr*>(n);
+	const char *name = call ? call->GetCallee()->GetName() : (var ? var->GetIdentifier()->GetName() : NULL);
+
+	if(name != NULL) {
+		DeclsByName::const_iterator found = byName.find(string(name));
+		for(size_t i = 0; found != byName.end() && i < found->second.size(); i++) {
+			if(reachable->insert(found->second[i]).second) {
+				MarkReachable(found->second[i], byName, reachable);
+			}
+		}
+	}
+
+	vector<Node*> children;
+	n->GetChildren(&children);
+	for(size_t i = 0; i < children.size(); i++) {
+		MarkReachable(children[i], byName, reachable);
+	}
+}
+
+/* Function: ReachableDecls()
+ * --------------------------
+ * Returns the top-level declarations reachable from the entry points
+ * (see IRGenerator::IsEntryPoint()) and the in, out and uniform
+ * variables, which are reached from outside.  Returns all of them if
+ * there is no entry point to start from.
+ */
+static set<Decl*> ReachableDecls(List<Decl*> *decls) {
+	DeclsByName byName;
+	set<Decl*> reachable;
+	bool hasEntry = false;
+
+	for(int i = 0; i < decls->NumElements(); i++) {
+		Decl *d = decls->Nth(i);
+		byName[string(d->GetIdentifier()->GetName())].push_back(d);
+	}
+
+	for(int i = 0; i < decls->NumElements(); i++) {
+		Decl *d = decls->Nth(i);
+		VarDecl *var = dynamic_cast<VarDecl*>(d);
+		bool entry = dynamic_cast<FnDecl*>(d) != NULL && Node::irgen->IsEntryPoint(d->GetIdentifier()->GetName());
+		hasEntry = hasEntry || entry;
+		if((entry || (var != NULL && var->IsInterface())) && reachable.insert(d).second) {
+			MarkReachable(d, byName, &reachable);
+		}
+	}
+
+	if(!hasEntry) {
+		for(int i = 0; i < decls->NumElements(); i++) {
+			reachable.insert(decls->Nth(i));
+		}
+	}
+	return reachable;
+}
+
+/* Function: DropUnreached()
+ * -------------------------
+ * Removes the functions (by now bodiless, see Program::Emit()) and the
+ * globals emitted for the declarations not in reachable.  Nothing
+ * reachable refers to them by name, so their only users are each other.
+ * Returns how many were removed.
+ */
+static long DropUnreached(llvm::Module *mod, List<Decl*> *decls, const set<Decl*> &reachable) {
+	set<llvm::Function*> functions;
+	vector<llvm::GlobalVariable*> globals;
+
+	for(int i = 0; i < decls->NumElements(); i++) {
+		Decl *d = decls->Nth(i);
+		if(reachable.count(d) != 0) {
+			continue;
+		}
+		const char *name = d->GetIdentifier()->GetName();
+		if(dynamic_cast<FnDecl*>(d) != NULL && mod->getFunction(name) != NULL) {
+			functions.insert(mod->getFunction(name));
+		}
+		else if(dynamic_cast<VarDecl*>(d) != NULL && mod->getNamedGlobal(name) != NULL) {
+			globals.push_back(mod->getNamedGlobal(name));
+		}
+	}
+
+	// the functions may call one another, so all their bodies go first
+	for(set<llvm::Function*>::iterator f = functions.begin(); f != functions.end(); ++f) {
+		(*f)->dropAllReferences();
+	}
+	long dropped = 0;
+	for(set<llvm::Function*>::iterator f = functions.begin(); f != functions.end(); ++f) {
+		(*f)->eraseFromParent();
+		dropped++;
+	}
+	for(size_t i = 0; i < globals.size(); i++) {
+		if(globals[i]->use_empty()) {
+			globals[i]->eraseFromParent();
+			dropped++;
+		}
+	}
+
+	// math built-ins only the dropped bodies called would still be linked
+	for(llvm::Module::iterator f = mod->begin(); f != mod->end(); ) {
+		llvm::Function *unused = &*f++;
+		if(unused->isDeclaration() && unused->use_empty() && unused->getName().startswith(MathPrefix)) {
+			unused->eraseFromParent();
+		}
+	}
+	return dropped;
+}
+
 llvm::Value* Program::Emit() {
 	//IRGenerator irgen;
 	llvm::Module *mod = irgen->GetOrCreateModule("Program_Module.bc");
@@ -41,17 +216,74 @@ llvm::Value* Program::Emit() {
 	//irgen->SetBasicBlock(llvm::BasicBlock::Create(*irgen->GetContext(), "Global"));
 
 	if ( decls->NumElements() > 0 ) {
-
+		PhaseTimer timer("emit");
+
+		// every declaration is emitted, since that is where it is
+		// checked, but unless -fkeep-unused is given the body of a
+		// function no entry point reaches is deleted as soon as it is
+		// built, and what is left of the unreached ones after that
+		bool dropUnused = !IsOptionOn("keep-unused");
+		set<Decl*> reachable;
+		if(dropUnused) {
+			reachable = ReachableDecls(decls);
+		}
 		for(int i = 0; i < decls->NumElements(); ++i) {
 			Decl *d = decls->Nth(i);
-			d->Emit();
+			llvm::Value *v = d->Emit();
+			if(dropUnused && reachable.count(d) == 0 && dynamic_cast<FnDecl*>(d) != NULL) {
+				llvm::cast<llvm::Function>(v)->deleteBody();
+			}
+		}
+		if(dropUnused) {
+			PhaseTimer::SetCounter("unused decls", DropUnreached(mod, decls, reachable));
 		}
 
+		// until now the math built-ins are calls to library declarations
+		{
+			PhaseTimer timer("math library");
+			LinkMathLibrary(mod);
+		}
+		irgen->FinishFunctions();
+	}
+
+	if (PhaseTimer::IsEnabled()) {
+		long numBlocks = 0, numInsts = 0;
+		for (llvm::Module::iterator f = mod->begin(); f != mod->end(); ++f) {
+			for (llvm::Function::iterator bb = f->begin(); bb != f->end(); ++bb) {
+				numBlocks++;
+				numInsts += bb->size();
+			}
+		}
+		PhaseTimer::SetCounter("blocks", numBlocks);
+		PhaseTimer::SetCounter("instructions", numInsts);
+		PhaseTimer::SetCounter("calls", CountCalls(mod));
 	}
 
 	symtab->pop_scope();
 
+	if (IsOptionOn("stop-after") && strcmp(GetOptionValue("stop-after"), "emit") == 0)
+		return NULL;
+
+	int optLevel = IsOptionOn("opt-level") ? atoi(GetOptionValue("opt-level")) : 0;
+	if (IsOptionOn("inline") || optLevel > 0) {
+		PhaseTimer timer("inline");
+		int threshold = DefaultInlineThreshold;
+		if (IsOptionOn("inline") && *GetOptionValue("inline"))
+			threshold = atoi(GetOptionValue("inline"));
+		PhaseTimer::SetCounter("calls after inline", InlineCalls(mod, threshold));
+	}
 
+	if (IsOptionOn("opt-level")) {
+		PhaseTimer timer("optimize");
+		OptimizeModule(mod, atoi(GetOptionValue("opt-level")));
+	}
+
+	if (IRGenerator::GetContraction() == IRGenerator::ContractFast) {
+		PhaseTimer timer("contract");
+		PhaseTimer::SetCounter("multiply-adds", ContractMultiplyAdds(mod));
+	}
+
+	PhaseTimer timer("write bitcode");
 	llvm::WriteBitcodeToFile(mod, llvm::outs());
 
 	return NULL;
@@ -115,27 +347,19 @@ llvm::Value* StmtBlock::Emit() {
 		for ( int i = 0; i < stmts->NumElements(); ++i ) {
 			Stmt *s = stmts->Nth(i);
 
-			s->Emit();
+			EmitStatement(s);
 		}
 	}
 
 	symtab->pop_scope();
 
-	if(irgen->GetBasicBlock()->empty() && symtab->currentScope == 1) {
-		//if ( footerStack.size() > 1 ) {
-		//	llvm::BasicBlock* topBlock = footerBlock.top();
-		//	footerBlock.pop();
-		//	llvm::BranchInst::Create(footerBlock.top(), topBlock);
-		//}
-		//else {
-		new llvm::UnreachableInst(*context, irgen->GetBasicBlock());
-		//	if ( footerStack.size() == 
-		//}
-	}
-
-	else if(irgen->GetBasicBlock()->getTerminator() == NULL && symtab->currentScope == 1) {
+	// falling off the end of the function body
+	if(irgen->GetBasicBlock()->getTerminator() == NULL && symtab->currentScope == 1) {
 		if(irgen->GetFunction()->getReturnType() == llvm::Type::getVoidTy(*context)) {
-			llvm::ReturnInst::Create(*context, irgen->GetBasicBlock());
+			irgen->GetBuilder()->CreateRetVoid();
+		}
+		else {
+			irgen->GetBuilder()->CreateUnreachable();
 		}
 	}
 
@@ -148,6 +372,11 @@ void StmtBlock::PrintChildren(int indentLevel) {
 	stmts->PrintAll(indentLevel+1);
 }
 
+void StmtBlock::GetChildren(vector<Node*> *children) {
+	decls->AppendAllTo(children);
+	stmts->AppendAllTo(children);
+}
+
 DeclStmt::DeclStmt(Decl *d) {
 	Assert(d != NULL);
 	(decl=d)->SetParent(this);
@@ -157,6 +386,10 @@ void DeclStmt::PrintChildren(int indentLevel) {
 	decl->Print(indentLevel+1);
 }
 
+void DeclStmt::GetChildren(vector<Node*> *children) {
+	children->push_back(decl);
+}
+
 ConditionalStmt::ConditionalStmt(Expr *t, Stmt *b) { 
 	Assert(t != NULL && b != NULL);
 	(test=t)->SetParent(this); 
@@ -165,53 +398,34 @@ ConditionalStmt::ConditionalStmt(Expr *t, Stmt *b) {
 
 llvm::Value* IfStmt::Emit() {
 	llvm::LLVMContext *context = irgen->GetContext();
-	llvm::BasicBlock *eb;
+	llvm::Function *f = irgen->GetFunction();
+	llvm::BasicBlock *eb = NULL;
 
 	llvm::Value* testVal = test->Emit();
 
-	llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context, "Footer block",irgen->GetFunction());
-
-	//irgen->footerStack.push(fb);
-
-	if(elseBody != NULL) {
-		eb = llvm::BasicBlock::Create(*context, "Else block",irgen->GetFunction());
-	}
-
-	llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context, "Then block",irgen->GetFunction());
+	llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context, "Then block", f);
+	llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context, "Footer block");
 
 	if(elseBody != NULL) {
-		llvm::BranchInst::Create(bb, eb, testVal, irgen->GetBasicBlock());
+		eb = llvm::BasicBlock::Create(*context, "Else block");
+		irgen->GetBuilder()->CreateCondBr(testVal, bb, eb);
 	}
-
 	else {
-		llvm::BranchInst::Create(bb, fb, testVal, irgen->GetBasicBlock());
+		irgen->GetBuilder()->CreateCondBr(testVal, bb, fb);
 	}
 
 	irgen->SetBasicBlock(bb);
-	llvm::Value* bodyVal = body->Emit();
-
-	if(!irgen->GetBasicBlock()->getTerminator()) {
-		llvm::BranchInst::Create(fb, irgen->GetBasicBlock());
-	}
+	EmitStatement(body);
+	BranchIfOpen(fb);
 
 	if(elseBody != NULL) {
+		eb->insertInto(f);
 		irgen->SetBasicBlock(eb);
-		llvm::Value* bodyVal = elseBody->Emit();
-
-		if( !irgen->GetBasicBlock()->getTerminator() ) {
-			llvm::BranchInst::Create(fb, irgen->GetBasicBlock());
-		}
+		EmitStatement(elseBody);
+		BranchIfOpen(fb);
 	}
 
-	irgen->SetBasicBlock(fb);
-
-	if(elseBody != NULL) {
-		eb->moveAfter(bb);
-		fb->moveAfter(eb);
-	}
-	else {
-		fb->moveAfter(bb);
-	}
+	ContinueAt(fb);
 
 	return NULL;
 }
@@ -232,68 +446,302 @@ void ForStmt::PrintChildren(int indentLevel) {
 	body->Print(indentLevel+1, "(body) ");
 }
 
+void ForStmt::GetChildren(vector<Node*> *children) {
+	children->push_back(init);
+	children->push_back(test);
+	if(step != NULL) {
+		children->push_back(step);
+	}
+	children->push_back(body);
+}
+
+/* Function: LoopProperty()
+ * -------------------------
+ * One entry of a loop's llvm.loop metadata: a name and an optional value.
+ */
+static llvm::MDNode* LoopProperty(llvm::LLVMContext &context, const char *name, llvm::Constant *value) {
+	vector<llvm::Metadata*> ops;
+	ops.push_back(llvm::MDString::get(context, name));
+	if(value != NULL) {
+		ops.push_back(llvm::ConstantAsMetadata::get(value));
+	}
+	return llvm::MDNode::get(context, ops);
+}
+
+/* Function: AttachHints()
+ * -----------------------
+ * Hands the loop's pragmas to the LLVM unroller and vectorizer as
+ * llvm.loop metadata on every branch back to the header.  Branches from
+ * entry, the block ahead of the loop, are the way in rather than back.
+ */
+void LoopStmt::AttachHints(llvm::BasicBlock *header, llvm::BasicBlock *entry) {
+	llvm::LLVMContext &context = *irgen->GetContext();
+	llvm::IRBuilder<> *builder = irgen->GetBuilder();
+	vector<llvm::Metadata*> ops;
+
+	ops.push_back(NULL);	// the loop's own id, filled in below
+	if(hints.unroll == LoopHints::UnrollFull) {
+		ops.push_back(LoopProperty(context, "llvm.loop.unroll.full", NULL));
+	}
+	else if(hints.unroll == 1) {
+		ops.push_back(LoopProperty(context, "llvm.loop.unroll.disable", NULL));
+	}
+	else if(hints.unroll > 1) {
+		ops.push_back(LoopProperty(context, "llvm.loop.unroll.count", builder->getInt32(hints.unroll)));
+	}
+	if(hints.vectorize > 0) {
+		ops.push_back(LoopProperty(context, "llvm.loop.vectorize.width", builder->getInt32(hints.vectorize)));
+		ops.push_back(LoopProperty(context, "llvm.loop.vectorize.enable", builder->getInt1(hints.vectorize > 1)));
+	}
+	if(ops.size() == 1) {
+		return;
+	}
+
+	llvm::MDNode *loopId = llvm::MDNode::getDistinct(context, ops);
+	loopId->replaceOperandWith(0, loopId);
+
+	for(llvm::Value::user_iterator u = header->user_begin(); u != header->user_end(); u++) {
+		llvm::Instruction *branch = llvm::dyn_cast<llvm::Instruction>(*u);
+		if(branch != NULL && branch->getParent() != entry) {
+			branch->setMetadata("llvm.loop", loopId);
+		}
+	}
+}
+
+/* Constants: MaxUnrollTrips, MaxUnrolledSize
+ * ------------------------------------------
+ * Limits on unrolling a loop in the tree: how many times it may run, and
+ * how many nodes the copies of its body may add up to.
+ */
+static const int MaxUnrollTrips = 32;
+static const int MaxUnrolledSize = 2048;
+
+/* Function: IsVar()
+ * -----------------
+ * True if e is just the variable called name.
+ */
+static bool IsVar(Expr *e, const char *name) {
+	VarExpr *var = dynamic_cast<VarExpr*>(e);
+	return var != NULL && strcmp(var->GetIdentifier()->GetName(), name) == 0;
+}
+
+/* Function: Mentions()
+ * --------------------
+ * True if the variable called name appears anywhere under n.
+ */
+static bool Mentions(Node *n, const char *name) {
+	Expr *e = dynamic_cast<Expr*>(n);
+	if(e != NULL && IsVar(e, name)) {
+		return true;
+	}
+
+	vector<Node*> children;
+	n->GetChildren(&children);
+	for(size_t i = 0; i < children.size(); i++) {
+		if(Mentions(children[i], name)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Struct: UnrollScan
+ * ------------------
+ * What ScanBody() found in a loop body: its size in nodes, whether it
+ * blocks unrolling (a break or continue, or a write to the loop
+ * variable), and whether the loop variable is used as an array index.
+ */
+struct UnrollScan {
+	int size;
+	bool blocked;
+	bool indexes;
+};
+
+static void ScanBody(Node *n, const char *var, UnrollScan *scan) {
+	scan->size++;
+
+	if(dynamic_cast<BreakStmt*>(n) != NULL || dynamic_cast<ContinueStmt*>(n) != NULL) {
+		scan->blocked = true;
+	}
+
+	CompoundExpr *c = dynamic_cast<CompoundExpr*>(n);
+	if(c != NULL) {
+		bool increments = c->GetOp()->IsOp("++") || c->GetOp()->IsOp("--");
+		if((dynamic_cast<AssignExpr*>(c) != NULL || dynamic_cast<PostfixExpr*>(c) != NULL) && IsVar(c->GetLeft(), var)) {
+			scan->blocked = true;
+		}
+		if(increments && c->GetLeft() == NULL && IsVar(c->GetRight(), var)) {
+			scan->blocked = true;
+		}
+	}
+
+	ArrayAccess *a = dynamic_cast<ArrayAccess*>(n);
+	if(a != NULL && Mentions(a->subscript, var)) {
+		scan->indexes = true;
+	}
+
+	vector<Node*> children;
+	n->GetChildren(&children);
+	for(size_t i = 0; i < children.size(); i++) {
+		ScanBody(children[i], var, scan);
+	}
+}
+
+/* Function: LoopStride()
+ * ----------------------
+ * How much a for loop's step adds to var: i++, ++i, i--, --i, i += c
+ * and i -= c are understood.  Returns false for any other step.
+ */
+static bool LoopStride(Expr *step, const char *var, int64_t *stride) {
+	CompoundExpr *c = dynamic_cast<CompoundExpr*>(step);
+	if(c == NULL) {
+		return false;
+	}
+
+	Operator *op = c->GetOp();
+	if(op->IsOp("++") || op->IsOp("--")) {
+		Expr *target = c->GetLeft() ? c->GetLeft() : c->GetRight();
+		*stride = op->IsOp("++") ? 1 : -1;
+		return (dynamic_cast<PostfixExpr*>(c) != NULL || dynamic_cast<ArithmeticExpr*>(c) != NULL) && IsVar(target, var);
+	}
+	if(dynamic_cast<AssignExpr*>(c) != NULL && (op->IsOp("+=") || op->IsOp("-=")) && IsVar(c->GetLeft(), var)) {
+		llvm::ConstantInt *amount = llvm::dyn_cast_or_null<llvm::ConstantInt>(c->GetRight()->Fold());
+		if(amount == NULL) {
+			return false;
+		}
+		*stride = op->IsOp("+=") ? amount->getSExtValue() : -amount->getSExtValue();
+		return *stride != 0;
+	}
+	return false;
+}
+
+/* Function: EmitUnrolled()
+ * ------------------------
+ * A for loop with a constant trip count, over a local int variable the
+ * body does not write, can be emitted as one copy of the body per trip.
+ * (A global could be written by a function the body calls.)  In
+ * each copy the loop variable is bound to its value for that trip, the
+ * way a const variable is, so array elements indexed by it get constant
+ * addresses and can be kept in registers.  That is the reason to do it
+ * here rather than leave it to LLVM, so it is only done when the body
+ * indexes an array with the variable, or when "#pragma unroll" asks for
+ * a full unroll; a "#pragma unroll N" for fewer trips than the loop
+ * takes is left to LLVM through the loop's metadata.  Returns false,
+ * having emitted nothing, otherwise.
+ */
+bool ForStmt::EmitUnrolled() {
+	AssignExpr *start = dynamic_cast<AssignExpr*>(init);
+	RelationalExpr *cond = dynamic_cast<RelationalExpr*>(test);
+	if(hints.unroll == 1 || hints.vectorize > 1 || start == NULL || cond == NULL || start->GetStoredValue() == NULL) {
+		return false;
+	}
+
+	VarExpr *var = dynamic_cast<VarExpr*>(start->GetTarget());
+	if(var == NULL || !IsVar(cond->GetLeft(), var->GetIdentifier()->GetName())) {
+		return false;
+	}
+	const char *name = var->GetIdentifier()->GetName();
+	VarDecl *decl = dynamic_cast<VarDecl*>(symtab->search_scope(string(name)));
+	if(decl == NULL || decl->IsConst() || decl->GetType() != Type::intType ||
+	   !llvm::isa<llvm::AllocaInst>(symtab->val_search(string(name)))) {
+		return false;
+	}
+
+	llvm::ConstantInt *first = llvm::dyn_cast_or_null<llvm::ConstantInt>(start->GetStoredValue()->Fold());
+	llvm::ConstantInt *bound = llvm::dyn_cast_or_null<llvm::ConstantInt>(cond->GetRight()->Fold());
+	int64_t stride;
+	if(first == NULL || bound == NULL || step == NULL || !LoopStride(step, name, &stride)) {
+		return false;
+	}
+
+	// run the loop on the values alone to find the trips it takes
+	vector<int64_t> trips;
+	int64_t value = first->getSExtValue(), limit = bound->getSExtValue();
+	Operator *op = cond->GetOp();
+	while((op->IsOp("<") && value < limit) || (op->IsOp("<=") && value <= limit) ||
+	      (op->IsOp(">") && value > limit) || (op->IsOp(">=") && value >= limit)) {
+		if((int)trips.size() == MaxUnrollTrips || value != (int32_t)value) {
+			return false;
+		}
+		trips.push_back(value);
+		value += stride;
+	}
+
+	if(hints.unroll > 1 && hints.unroll < (int)trips.size()) {
+		return false;
+	}
+
+	UnrollScan scan = {0, false, false};
+	ScanBody(body, name, &scan);
+	bool asked = hints.unroll == LoopHints::UnrollFull || hints.unroll > 1;
+	if(scan.blocked || scan.size * (int)trips.size() > MaxUnrolledSize || !(asked || scan.indexes)) {
+		return false;
+	}
+	PrintDebug("unroll", "unrolling the loop at line %d %d times\n", GetLocation()->first_line, (int)trips.size());
+
+	for(size_t i = 0; i < trips.size(); i++) {
+		symtab->push_scope(SymbolTable::Block);
+		symtab->add_decl(string(name), decl, irgen->GetBuilder()->getInt32(trips[i]));
+		EmitStatement(body);
+		symtab->pop_scope();
+	}
+
+	// the variable is left holding the value that ended the loop
+	if(irgen->GetBasicBlock()->getTerminator() == NULL) {
+		irgen->GetBuilder()->CreateStore(irgen->GetBuilder()->getInt32(value), symtab->val_search(string(name)));
+	}
+	return true;
+}
+
 llvm::Value* ForStmt::Emit() {
 	llvm::LLVMContext *context = irgen->GetContext();
+	llvm::Function *f = irgen->GetFunction();
 
-	if(step != NULL) {
-		llvm::BasicBlock *hb = llvm::BasicBlock::Create(*context, "Header block", irgen->GetFunction());
-		llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context, "Step block", irgen->GetFunction());
-		llvm::BasicBlock *sb = llvm::BasicBlock::Create(*context, "Footer block", irgen->GetFunction());
-		llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context, "Body block", irgen->GetFunction());
-
-		irgen->breakBlockStack.push(sb);
-		irgen->continueBlockStack.push(fb);
-
-		init->Emit();
-		llvm::BranchInst::Create(hb, irgen->GetBasicBlock());
-
-		irgen->SetBasicBlock(hb);
-		llvm::Value* testVal = test->Emit();
-		llvm::BranchInst::Create(bb, sb, testVal, hb);
-
-		irgen->SetBasicBlock(bb);
-		body->Emit();
-		llvm::BranchInst::Create(fb, irgen->GetBasicBlock());
-		irgen->SetBasicBlock(fb);
-		step->Emit();
-		llvm::BranchInst::Create(hb, fb);
-
-		irgen->breakBlockStack.pop();
-		irgen->continueBlockStack.pop();
-		// TODO need to set basic block to footer
-		irgen->SetBasicBlock(sb);
+	if(EmitUnrolled()) {
 		return NULL;
 	}
-	else if(step == NULL) {
-		llvm::BasicBlock *hb = llvm::BasicBlock::Create(*context, "Header block", irgen->GetFunction());
-		//llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context, "Step block", irgen->GetFunction());
-		llvm::BasicBlock *sb = llvm::BasicBlock::Create(*context, "Footer block", irgen->GetFunction());
-		llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context, "Body block", irgen->GetFunction());
 
-		irgen->breakBlockStack.push(sb);
-		irgen->continueBlockStack.push(hb);
+	EmitStatement(init);
+	llvm::BasicBlock *entry = irgen->GetBasicBlock();
 
-		init->Emit();
-		llvm::BranchInst::Create(hb, irgen->GetBasicBlock());
+	llvm::BasicBlock *hb = llvm::BasicBlock::Create(*context, "Header block", f);
+	irgen->GetBuilder()->CreateBr(hb);
+	irgen->SetBasicBlock(hb);
+	llvm::Value* testVal = test->Emit();
 
-		irgen->SetBasicBlock(hb);
-		llvm::Value* testVal = test->Emit();
-		llvm::BranchInst::Create(bb, sb, testVal, hb);
+	// without a step, continue goes straight back to the test
+	llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context, "Body block", f);
+	llvm::BasicBlock *stepBlock = hb;
+	if(step != NULL) {
+		stepBlock = llvm::BasicBlock::Create(*context, "Step block");
+	}
+	llvm::BasicBlock *sb = llvm::BasicBlock::Create(*context, "Footer block");
+	irgen->GetBuilder()->CreateCondBr(testVal, bb, sb);
 
-		irgen->SetBasicBlock(bb);
-		body->Emit();
-		llvm::BranchInst::Create(hb, irgen->GetBasicBlock());
-		//irgen->SetBasicBlock(fb);
-		//step->Emit();
-		//llvm::BranchInst::Create(hb, fb);
+	irgen->breakBlockStack.push(sb);
+	irgen->continueBlockStack.push(stepBlock);
 
-		irgen->breakBlockStack.pop();
-		irgen->continueBlockStack.pop();
+	irgen->SetBasicBlock(bb);
+	EmitStatement(body);
+	BranchIfOpen(stepBlock);
 
-		irgen->SetBasicBlock(sb);
+	irgen->breakBlockStack.pop();
+	irgen->continueBlockStack.pop();
 
-		return NULL;
+	// the step is unreachable if every path through the body leaves the
+	// loop or the function
+	if(stepBlock != hb && stepBlock->use_empty()) {
+		delete stepBlock;
 	}
+	else if(stepBlock != hb) {
+		stepBlock->insertInto(f);
+		irgen->SetBasicBlock(stepBlock);
+		EmitStatement(step);
+		irgen->GetBuilder()->CreateBr(hb);
+	}
+
+	AttachHints(hb, entry);
+	ContinueAt(sb);
 
 	return NULL;
 }
@@ -303,32 +751,39 @@ void WhileStmt::PrintChildren(int indentLevel) {
 	body->Print(indentLevel+1, "(body) ");
 }
 
+void WhileStmt::GetChildren(vector<Node*> *children) {
+	children->push_back(test);
+	children->push_back(body);
+}
+
 llvm::Value* WhileStmt::Emit() {
 	llvm::LLVMContext *context = irgen->GetContext();
-	llvm::BasicBlock *hb = llvm::BasicBlock::Create(*context, "Header block", irgen->GetFunction());
-	llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context, "Body block", irgen->GetFunction());
-	llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context, "Footer block", irgen->GetFunction());
-
-	irgen->breakBlockStack.push(bb);
-	irgen->continueBlockStack.push(hb);
-
-	llvm::BranchInst::Create(hb, irgen->GetBasicBlock());
+	llvm::Function *f = irgen->GetFunction();
+	llvm::BasicBlock *entry = irgen->GetBasicBlock();
 
+	llvm::BasicBlock *hb = llvm::BasicBlock::Create(*context, "Header block", f);
+	irgen->GetBuilder()->CreateBr(hb);
 	irgen->SetBasicBlock(hb);
 	llvm::Value* testVal = test->Emit();
-	llvm::BranchInst::Create(fb, bb, testVal, hb);
+
+	llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context, "Body block", f);
+	llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context, "Footer block");
+	irgen->GetBuilder()->CreateCondBr(testVal, bb, fb);
+
+	irgen->breakBlockStack.push(fb);
+	irgen->continueBlockStack.push(hb);
 
 	irgen->SetBasicBlock(bb);
-	body->Emit();
-	llvm::BranchInst::Create(hb, irgen->GetBasicBlock());
+	EmitStatement(body);
+	BranchIfOpen(hb);
 
 	irgen->breakBlockStack.pop();
 	irgen->continueBlockStack.pop();
 
-	irgen->SetBasicBlock(bb);
+	AttachHints(hb, entry);
+	ContinueAt(fb);
 
 	return NULL;
-
 }
 
 IfStmt::IfStmt(Expr *t, Stmt *tb, Stmt *eb): ConditionalStmt(t, tb) { 
@@ -343,6 +798,14 @@ void IfStmt::PrintChildren(int indentLevel) {
 	if (elseBody) elseBody->Print(indentLevel+1, "(else) ");
 }
 
+void IfStmt::GetChildren(vector<Node*> *children) {
+	children->push_back(test);
+	children->push_back(body);
+	if(elseBody != NULL) {
+		children->push_back(elseBody);
+	}
+}
+
 
 ReturnStmt::ReturnStmt(yyltype loc, Expr *e) : Stmt(loc) { 
 	expr = e;
@@ -354,17 +817,29 @@ void ReturnStmt::PrintChildren(int indentLevel) {
 		expr->Print(indentLevel+1);
 }
 
+void ReturnStmt::GetChildren(vector<Node*> *children) {
+	if(expr != NULL) {
+		children->push_back(expr);
+	}
+}
+
 llvm::Value* ReturnStmt::Emit() {
 	llvm::LLVMContext *context = irgen->GetContext();
 
 	if ( expr == NULL ) {
-		llvm::ReturnInst::Create(*context, irgen->GetBasicBlock());
+		irgen->GetBuilder()->CreateRetVoid();
 	}
 
 	else if ( expr != NULL ) {
 		// llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context, "Return Statement");
 		llvm::Value* retVal = expr->Emit();
-		llvm::ReturnInst::Create(*context, retVal, irgen->GetBasicBlock());
+		if(retVal == NULL) {
+			// the error is already reported; the block still needs an end
+			irgen->GetBuilder()->CreateUnreachable();
+		}
+		else {
+			irgen->GetBuilder()->CreateRet(retVal);
+		}
 	}
 
 	return NULL;
@@ -387,6 +862,15 @@ void SwitchLabel::PrintChildren(int indentLevel) {
 	if (stmt)  stmt->Print(indentLevel+1);
 }
 
+void SwitchLabel::GetChildren(vector<Node*> *children) {
+	if(label != NULL) {
+		children->push_back(label);
+	}
+	if(stmt != NULL) {
+		children->push_back(stmt);
+	}
+}
+
 SwitchStmt::SwitchStmt(Expr *e, List<Stmt *> *c, Default *d) {
 	Assert(e != NULL && c != NULL && c->NumElements() != 0 );
 	(expr=e)->SetParent(this);
@@ -401,150 +885,266 @@ void SwitchStmt::PrintChildren(int indentLevel) {
 	if (def) def->Print(indentLevel+1);
 }
 
-llvm::Value* SwitchStmt::Emit() {
-	//TODO Same branching issue as in if, for, while, etc
-	//Basically branching from something other than GetBasicBlock()
-	llvm::LLVMContext *context = irgen->GetContext();
-
-
-	llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context, "Footer Block", irgen->GetFunction());	//Creating Footer
-	//llvm::BasicBlock *bb = llvm::BasicBlock::Create(*context, "Switch Statement", irgen->GetFunction()); //CREATE BASIC BLOCK FOR SWITCH STATEMENT?
-	llvm::BasicBlock *deflt = NULL;
-
-	std::vector<llvm::BasicBlock*> caseList;
+void SwitchStmt::GetChildren(vector<Node*> *children) {
+	children->push_back(expr);
+	cases->AppendAllTo(children);
+	if(def != NULL) {
+		children->push_back(def);
+	}
+}
 
+/* Struct: SwitchArm
+ * ----------------
+ * The case and default labels in front of one statement of a switch
+ * body.  They share a block, which runs the body from that statement on
+ * (falling through into later arms) until a break.
+ */
+struct SwitchArm {
+	vector<Case*> labels;
+	vector<llvm::ConstantInt*> values;
+	bool isDefault;
+	int first, end;             // the arm's own statements in the body
+	llvm::BasicBlock *block;
+};
+
+/* Function: CollectArms()
+ * -----------------------
+ * The parser attaches a label to the one statement after it, so
+ * "case 1: case 2: a; b;" arrives as Case(1, Case(2, a)) followed by b.
+ * One pass over the list peels the labels off into arms and leaves the
+ * statements, in order, in body.
+ */
+static void CollectArms(List<Stmt*> *cases, vector<Stmt*> *body, vector<SwitchArm> *arms) {
 	for(int i = 0; i < cases->NumElements(); i++) {
-		Case* indivCase1 = dynamic_cast<Case*>(cases->Nth(i));
-
-		if ( indivCase1 == NULL ) {
-			continue;
-		}
-
-		else {
-			Case* nested = dynamic_cast<Case*>(indivCase1->stmt);
-			Default* nestedDeflt = dynamic_cast<Default*>(indivCase1->stmt);
-
-			if ( nested != NULL ) {
-				cases->InsertAt(nested, i+1);
-				indivCase1->stmt = NULL;
+		Stmt *s = cases->Nth(i);
+		SwitchLabel *label;
+
+		while((label = dynamic_cast<SwitchLabel*>(s)) != NULL) {
+			if(arms->empty() || arms->back().first != (int)body->size()) {
+				SwitchArm arm;
+				arm.isDefault = false;
+				arm.first = body->size();
+				arm.block = NULL;
+				arms->push_back(arm);
 			}
-
-			if ( nestedDeflt != NULL ) {
-				cases->InsertAt(nestedDeflt, i+1);
-				indivCase1->stmt = NULL;
+			Case *c = dynamic_cast<Case*>(label);
+			if(c != NULL) {
+				arms->back().labels.push_back(c);
+			}
+			else {
+				arms->back().isDefault = true;
 			}
+			s = label->stmt;
+		}
+		if(s != NULL) {
+			body->push_back(s);
 		}
-
 	}
 
-	for(int i = cases->NumElements()-1; i >= 0; i--) {
+	for(size_t i = 0; i < arms->size(); i++) {
+		(*arms)[i].end = (i + 1 < arms->size()) ? (*arms)[i+1].first : body->size();
+	}
+}
 
-		Case* indivCase1 = dynamic_cast<Case*>(cases->Nth(i));
-		//Default* defaultmaybe = dynamic_cast<Default*>(cases->Nth(i));
+/* Function: ArmResult()
+ * ---------------------
+ * Returns the constant an arm stores if the arm is just "name = constant;"
+ * followed by a break (or by the end of the switch), else NULL.  Every arm
+ * must store to the same name, which is returned through target.
+ */
+static llvm::Constant* ArmResult(const vector<Stmt*> &body, const SwitchArm &arm, VarExpr **target) {
+	int count = arm.end - arm.first;
+	if(count == 2 && dynamic_cast<BreakStmt*>(body[arm.first+1]) == NULL) {
+		return NULL;
+	}
+	if(count == 1 && arm.end != (int)body.size()) {
+		return NULL;
+	}
+	if(count != 1 && count != 2) {
+		return NULL;
+	}
 
+	AssignExpr *assign = dynamic_cast<AssignExpr*>(body[arm.first]);
+	if(assign == NULL || assign->GetStoredValue() == NULL) {
+		return NULL;
+	}
+	VarExpr *var = dynamic_cast<VarExpr*>(assign->GetTarget());
+	if(var == NULL) {
+		return NULL;
+	}
+	if(*target != NULL && strcmp((*target)->GetIdentifier()->GetName(), var->GetIdentifier()->GetName()) != 0) {
+		return NULL;
+	}
+	*target = var;
+	return assign->GetStoredValue()->Fold();
+}
 
-		//if ( defaultmaybe != NULL ) {
-		//}
-		
-		if ( indivCase1 != NULL ) {
-			llvm::BasicBlock *curr = llvm::BasicBlock::Create(*context, "Case", irgen->GetFunction());
-			caseList.push_back(curr);
+/* Constants: MinTableCases, MaxTableSize
+ * --------------------------------------
+ * A switch only becomes a lookup table with enough cases to beat a few
+ * compares, and when at least half of the table holds case values.
+ */
+static const int MinTableCases = 4;
+static const int MaxTableSize = 4096;
+
+/* Function: EmitSwitchTable()
+ * ---------------------------
+ * A switch whose every arm stores a constant to the same variable, over
+ * case values dense enough, is emitted as a load from a constant table
+ * indexed by the switch value, with no branches at all.  A value outside
+ * the table picks the default's constant, or leaves the variable as it
+ * was when there is no default.  Returns false, having emitted nothing,
+ * if the switch does not have that shape.
+ */
+static bool EmitSwitchTable(llvm::Value *test, const vector<Stmt*> &body, const vector<SwitchArm> &arms) {
+	llvm::IRBuilder<> *builder = Node::irgen->GetBuilder();
+	VarExpr *target = NULL;
+	llvm::Constant *defaultVal = NULL;
+	vector<llvm::Constant*> results;
+	int numCases = 0;
+	int64_t lo = 0, hi = 0;
+
+	if(!test->getType()->isIntegerTy(32)) {
+		return false;
+	}
 
+	for(size_t i = 0; i < arms.size(); i++) {
+		llvm::Constant *result = ArmResult(body, arms[i], &target);
+		if(result == NULL || (!results.empty() && result->getType() != results[0]->getType())) {
+			return false;
+		}
+		results.push_back(result);
+		if(arms[i].isDefault) {
+			defaultVal = result;
+		}
+		for(size_t k = 0; k < arms[i].values.size(); k++) {
+			int64_t v = arms[i].values[k]->getSExtValue();
+			lo = (numCases == 0 || v < lo) ? v : lo;
+			hi = (numCases == 0 || v > hi) ? v : hi;
+			numCases++;
 		}
-
 	}
 
-	deflt = llvm::BasicBlock::Create(*context, "Default Statement", irgen->GetFunction());
-	caseList.push_back(deflt);
-	fb->moveAfter(deflt);
-
-	
-
-	llvm::SwitchInst* thisSwitch = NULL;
-
-	llvm::Value* testVal = expr->Emit();
-
-	if ( deflt != NULL ) {
-		thisSwitch = llvm::SwitchInst::Create(testVal, deflt, cases->NumElements(), irgen->GetBasicBlock()); //bb?
+	int64_t size = hi - lo + 1;
+	if(numCases < MinTableCases || size > MaxTableSize || size > 2 * numCases) {
+		return false;
 	}
-	else {
-		thisSwitch = llvm::SwitchInst::Create(testVal, fb, cases->NumElements(), irgen->GetBasicBlock()); //bb?
+	// without a default, a gap in the table would have to store nothing
+	if(defaultVal == NULL && size != numCases) {
+		return false;
 	}
 
+	LValueRef ref;
+	if(dynamic_cast<VarDecl*>(Node::symtab->search_scope(string(target->GetIdentifier()->GetName()))) == NULL ||
+	   !target->EmitLValue(&ref) || ref.readOnly ||
+	   ref.addr->getType()->getPointerElementType() != results[0]->getType()) {
+		return false;
+	}
 
-	irgen->breakBlockStack.push(fb);
-
-	int j = 0;
-
-	for(int i = 0; i < cases->NumElements(); i++) {
-
-
-		Case* indivCase = dynamic_cast<Case*>(cases->Nth(i));
-
-		BreakStmt* isBreak = dynamic_cast<BreakStmt*>(cases->Nth(i));
-
-		if ( isBreak != NULL ) {
-			isBreak->Emit();
-			continue;
+	vector<llvm::Constant*> entries(size, defaultVal);
+	for(size_t i = 0; i < arms.size(); i++) {
+		for(size_t k = 0; k < arms[i].values.size(); k++) {
+			entries[arms[i].values[k]->getSExtValue() - lo] = results[i];
 		}
+	}
 
-		if ( (indivCase == NULL) && (isBreak == NULL) ) {
-			Default* defltCase = dynamic_cast<Default*>(cases->Nth(i));
+	llvm::ArrayType *tableTy = llvm::ArrayType::get(results[0]->getType(), size);
+	llvm::GlobalVariable *table = new llvm::GlobalVariable(*Node::irgen->GetOrCreateModule("Program_Module.bc"), tableTy, true, llvm::GlobalValue::InternalLinkage, llvm::ConstantArray::get(tableTy, entries), "Switch Table");
+	table->setUnnamedAddr(true);
+
+	// an index outside the table is clamped to 0 so the load stays in
+	// bounds, and its result is replaced by the fallback
+	llvm::Value *index = builder->CreateSub(test, builder->getInt32(lo), "Switch Index");
+	llvm::Value *inRange = builder->CreateICmpULT(index, builder->getInt32(size), "Switch In Range");
+	index = builder->CreateSelect(inRange, index, builder->getInt32(0));
+
+	llvm::Value *idx[] = {builder->getInt32(0), index};
+	llvm::Value *val = builder->CreateLoad(builder->CreateInBoundsGEP(table, idx, "Switch Entry"), "Switch Result");
+	llvm::Value *fallback = defaultVal ? (llvm::Value*)defaultVal : ref.Load();
+	ref.Store(builder->CreateSelect(inRange, val, fallback, "Switch Result"));
+	return true;
+}
 
-			if ( defltCase != NULL ) {
-				irgen->SetBasicBlock(deflt);
-				defltCase->stmt->Emit();
-				//llvm::BranchInst::Create(fb, deflt);
+llvm::Value* SwitchStmt::Emit() {
+	llvm::LLVMContext *context = irgen->GetContext();
+	llvm::Function *f = irgen->GetFunction();
+
+	vector<Stmt*> body;
+	vector<SwitchArm> arms;
+	CollectArms(cases, &body, &arms);
+
+	// labels may name const variables as well as literals
+	std::set<int64_t> seen;
+	SwitchArm *deflt = NULL;
+	for(size_t i = 0; i < arms.size(); i++) {
+		for(size_t k = 0; k < arms[i].labels.size(); k++) {
+			Expr *label = arms[i].labels[k]->label;
+			llvm::ConstantInt *value = llvm::dyn_cast_or_null<llvm::ConstantInt>(label->Fold());
+			if(value == NULL) {
+				ReportError::Formatted(label->GetLocation(), "case label is not a constant integer expression");
+			}
+			else if(!seen.insert(value->getSExtValue()).second) {
+				ReportError::Formatted(label->GetLocation(), "duplicate case value %d", (int)value->getSExtValue());
+			}
+			else {
+				arms[i].values.push_back(value);
 			}
-			continue;
 		}
-		else {
-
-			irgen->SetBasicBlock(caseList[j]);
-			llvm::Value* labelVal = indivCase->label->Emit();
-			llvm::ConstantInt *constLabelVal = llvm::cast<llvm::ConstantInt>(labelVal);
-			thisSwitch->llvm::SwitchInst::addCase(constLabelVal, caseList[j]);
+		if(arms[i].isDefault) {
+			deflt = &arms[i];
+		}
+	}
 
-			if( indivCase->stmt != NULL ) {
-				indivCase->stmt->Emit();
-			}
+	llvm::Value* testVal = expr->Emit();
 
+	if(EmitSwitchTable(testVal, body, arms)) {
+		return NULL;
+	}
 
-			j++;
+	// without a default, a value no case matches goes straight past the
+	// switch; the backend turns dense cases into a jump table
+	llvm::BasicBlock *fb = llvm::BasicBlock::Create(*context, "Footer Block");	//Creating Footer, added by ContinueAt()
+	for(size_t i = 0; i < arms.size(); i++) {
+		arms[i].block = llvm::BasicBlock::Create(*context, arms[i].isDefault ? "Default Statement" : "Case");
+	}
 
+	llvm::SwitchInst* thisSwitch = irgen->GetBuilder()->CreateSwitch(testVal, deflt ? deflt->block : fb, seen.size());
+	for(size_t i = 0; i < arms.size(); i++) {
+		for(size_t k = 0; k < arms[i].values.size(); k++) {
+			thisSwitch->addCase(arms[i].values[k], arms[i].block);
 		}
-
 	}
 
-	for( int y = 0; y < caseList.size(); y++) {
-		if( (caseList[y]->getTerminator()) == NULL) {
-			if( y == caseList.size()-1 ) {
-				llvm::BranchInst::Create( fb, caseList[y]);
-			}
-			else {
-				llvm::BranchInst::Create(caseList[y+1], caseList[y]);
-			}
+	// statements ahead of the first label can never run, and each arm
+	// falls through into the next unless it ends in a break
+	irgen->breakBlockStack.push(fb);
+	for(size_t i = 0; i < arms.size(); i++) {
+		if(i > 0) {
+			BranchIfOpen(arms[i].block);
 		}
+		arms[i].block->insertInto(f);
+		irgen->SetBasicBlock(arms[i].block);
 
+		for(int k = arms[i].first; k < arms[i].end; k++) {
+			EmitStatement(body[k]);
+		}
 	}
+	BranchIfOpen(fb);
+	irgen->breakBlockStack.pop();
 
-	if( deflt != NULL && deflt->getTerminator()== NULL) {
-		llvm::BranchInst::Create(fb, deflt);
-	}
-
-	irgen->SetBasicBlock(fb);
+	ContinueAt(fb);
 
 	return NULL;
 }
 
 llvm::Value* BreakStmt::Emit() {
-	llvm::BranchInst::Create(irgen->breakBlockStack.top(), irgen->GetBasicBlock());
+	irgen->GetBuilder()->CreateBr(irgen->breakBlockStack.top());
 
 	return NULL;
 }
 
 llvm::Value* ContinueStmt::Emit() {
-	llvm::BranchInst::Create(irgen->continueBlockStack.top(), irgen->GetBasicBlock());
+	irgen->GetBuilder()->CreateBr(irgen->continueBlockStack.top());
 
 	return NULL;
 }
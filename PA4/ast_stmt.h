@@ -37,6 +37,7 @@ class Program : public Node
 		Program(List<Decl*> *declList);
 		const char *GetPrintNameForNode() { return "Program"; }
 		void PrintChildren(int indentLevel);
+		void GetChildren(vector<Node*> *children);
 		virtual llvm::Value* Emit();
 };
 
@@ -57,6 +58,7 @@ class StmtBlock : public Stmt
 		StmtBlock(List<VarDecl*> *variableDeclarations, List<Stmt*> *statements);
 		const char *GetPrintNameForNode() { return "StmtBlock"; }
 		void PrintChildren(int indentLevel);
+		void GetChildren(vector<Node*> *children);
 		virtual llvm::Value* Emit();
 };
 
@@ -69,6 +71,7 @@ class DeclStmt: public Stmt
 		DeclStmt(Decl *d);
 		const char *GetPrintNameForNode() { return "DeclStmt"; }
 		void PrintChildren(int indentLevel);
+		void GetChildren(vector<Node*> *children);
 		virtual llvm::Value* Emit();
 
 };
@@ -85,11 +88,33 @@ class ConditionalStmt : public Stmt
 
 };
 
+/* LoopHints
+ * ---------
+ * What the #pragma lines in front of a loop ask for.  unroll is the
+ * unroll count: 0 if not given, UnrollFull for a bare "#pragma unroll"
+ * and 1 for "#pragma nounroll".  vectorize is the vector width, or 0 if
+ * not given; a width of 1 turns vectorization off.
+ */
+class LoopHints
+{
+	public:
+		static const int UnrollFull = -1;
+		int unroll;
+		int vectorize;
+		LoopHints() : unroll(0), vectorize(0) {}
+};
+
 class LoopStmt : public ConditionalStmt 
 {
+	protected:
+		LoopHints hints;
+
+		void AttachHints(llvm::BasicBlock *header, llvm::BasicBlock *entry);
+
 	public:
 		LoopStmt(Expr *testExpr, Stmt *body)
 			: ConditionalStmt(testExpr, body) {}
+		void SetHints(const LoopHints &h) { hints = h; }
 };
 
 class ForStmt : public LoopStmt 
@@ -101,8 +126,12 @@ class ForStmt : public LoopStmt
 		ForStmt(Expr *init, Expr *test, Expr *step, Stmt *body);
 		const char *GetPrintNameForNode() { return "ForStmt"; }
 		void PrintChildren(int indentLevel);
+		void GetChildren(vector<Node*> *children);
 		virtual llvm::Value* Emit();
 
+	private:
+		bool EmitUnrolled();
+
 };
 
 class WhileStmt : public LoopStmt 
@@ -111,6 +140,7 @@ class WhileStmt : public LoopStmt
 		WhileStmt(Expr *test, Stmt *body) : LoopStmt(test, body) {}
 		const char *GetPrintNameForNode() { return "WhileStmt"; }
 		void PrintChildren(int indentLevel);
+		void GetChildren(vector<Node*> *children);
 		virtual llvm::Value* Emit();
 
 };
@@ -125,6 +155,7 @@ class IfStmt : public ConditionalStmt
 		IfStmt(Expr *test, Stmt *thenBody, Stmt *elseBody);
 		const char *GetPrintNameForNode() { return "IfStmt"; }
 		void PrintChildren(int indentLevel);
+		void GetChildren(vector<Node*> *children);
 		virtual llvm::Value* Emit();
 
 };
@@ -162,6 +193,7 @@ class ReturnStmt : public Stmt
 		ReturnStmt(yyltype loc, Expr *expr = NULL);
 		const char *GetPrintNameForNode() { return "ReturnStmt"; }
 		void PrintChildren(int indentLevel);
+		void GetChildren(vector<Node*> *children);
 		virtual llvm::Value* Emit();
 
 };
@@ -177,6 +209,7 @@ class SwitchLabel : public Stmt
 		SwitchLabel(Expr *label, Stmt *stmt);
 		SwitchLabel(Stmt *stmt);
 		void PrintChildren(int indentLevel);
+		void GetChildren(vector<Node*> *children);
 		//virtual llvm::Value* Emit();
 
 };
@@ -208,6 +241,7 @@ class SwitchStmt : public Stmt
 		SwitchStmt(Expr *expr, List<Stmt*> *cases, Default *def);
 		virtual const char *GetPrintNameForNode() { return "SwitchStmt"; }
 		void PrintChildren(int indentLevel);
+		void GetChildren(vector<Node*> *children);
 		virtual llvm::Value* Emit();
 
 };
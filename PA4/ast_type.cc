@@ -41,6 +41,9 @@ TypeQualifier *TypeQualifier::inTypeQualifier  = new TypeQualifier("in");
 TypeQualifier *TypeQualifier::outTypeQualifier = new TypeQualifier("out");
 TypeQualifier *TypeQualifier::constTypeQualifier = new TypeQualifier("const");
 TypeQualifier *TypeQualifier::uniformTypeQualifier = new TypeQualifier("uniform");
+TypeQualifier *TypeQualifier::highpTypeQualifier = new TypeQualifier("highp");
+TypeQualifier *TypeQualifier::mediumpTypeQualifier = new TypeQualifier("mediump");
+TypeQualifier *TypeQualifier::lowpTypeQualifier = new TypeQualifier("lowp");
 
 Type::Type(const char *n) {
     Assert(n);
@@ -54,6 +57,17 @@ void Type::PrintChildren(int indentLevel) {
 TypeQualifier::TypeQualifier(const char *n) {
     Assert(n);
     typeQualifierName = strdup(n);
+    bool precision = !strcmp(n, "highp") || !strcmp(n, "mediump") || !strcmp(n, "lowp");
+    storage = precision ? NULL : this;
+    reducedPrecision = !strcmp(n, "mediump") || !strcmp(n, "lowp");
+}
+
+TypeQualifier::TypeQualifier(TypeQualifier *s, TypeQualifier *p) {
+    Assert(s && p);
+    string name = string(s->typeQualifierName) + " " + p->typeQualifierName;
+    typeQualifierName = strdup(name.c_str());
+    storage = s->storage;
+    reducedPrecision = p->reducedPrecision;
 }
 
 void TypeQualifier::PrintChildren(int indentLevel) {
@@ -22,12 +22,21 @@ class TypeQualifier : public Node
 {
   protected:
     char *typeQualifierName;
+    TypeQualifier *storage;     // in, out, const, uniform or NULL
+    bool reducedPrecision;      // mediump or lowp
 
   public :
     static TypeQualifier *inTypeQualifier, *outTypeQualifier, *constTypeQualifier, *uniformTypeQualifier;
+    static TypeQualifier *highpTypeQualifier, *mediumpTypeQualifier, *lowpTypeQualifier;
 
-    TypeQualifier(yyltype loc) : Node(loc) {}
+    TypeQualifier(yyltype loc) : Node(loc), storage(NULL), reducedPrecision(false) {}
     TypeQualifier(const char *str);
+    TypeQualifier(TypeQualifier *storage, TypeQualifier *precision);   // e.g. uniform mediump
+
+    TypeQualifier *GetStorage() { return storage; }
+
+    // A float variable of reduced precision may be stored as half
+    bool IsReducedPrecision() { return reducedPrecision; }
 
     const char *GetPrintNameForNode() { return "TypeQualifier"; }
     void PrintChildren(int indentLevel);
@@ -52,6 +61,7 @@ class Type : public Node
     
     const char *GetPrintNameForNode() { return "Type"; }
     void PrintChildren(int indentLevel);
+    const char *GetTypeName() { return typeName; }
 
     virtual void PrintType() {printf("%s\n", typeName);}
     virtual void PrintToStream(ostream& out) { out << typeName; }
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+#
+# File: builtin_bench.py
+#
+# Throughput of each built-in function (see EmitBuiltin in ast_expr.cc).
+# For every built-in a small kernel is generated that applies it once per
+# loop iteration to operands that change every iteration, so the call
+# cannot be hoisted; the kernel is compiled with glc and timed with
+# glbench, which prints ns and cycles per call of n iterations:
+#
+#   python3 bench/builtin_bench.py --n 1000
+#
+# --type picks the operand type (vec4 by default; cross always uses
+# vec3), and --only limits the run to some of the built-ins.  The math
+# library built-ins (sin, exp, pow and so on) can be timed in their fast
+# variant with --glc-flags=-fmath=fast.
+
+import os
+import sys
+import argparse
+import tempfile
+import subprocess
+
+# The expression timed for each built-in, in terms of x and y of the
+# operand type T and float s; it must evaluate to a T.
+EXPRESSIONS = [
+  ('abs', 'abs(x)'),
+  ('atan', 'atan(x)'),
+  ('atan2', 'atan(x, y)'),
+  ('clamp', 'clamp(x, -s, s)'),
+  ('cos', 'cos(x)'),
+  ('cross', None),
+  ('distance', 'T(distance(x, y))'),
+  ('dot', 'T(dot(x, y))'),
+  ('exp', 'exp(x)'),
+  ('exp2', 'exp2(x)'),
+  ('floor', 'floor(x)'),
+  ('fract', 'fract(x)'),
+  ('inversesqrt', 'inversesqrt(x)'),
+  ('length', 'T(length(x))'),
+  ('log', 'log(x)'),
+  ('log2', 'log2(x)'),
+  ('max', 'max(x, y)'),
+  ('min', 'min(x, y)'),
+  ('mix', 'mix(x, y, s)'),
+  ('normalize', 'normalize(x)'),
+  ('pow', 'pow(x, y)'),
+  ('reflect', 'reflect(x, y)'),
+  ('sin', 'sin(x)'),
+  ('sqrt', 'sqrt(x)'),
+  ('step', 'step(y, x)'),
+  ('tan', 'tan(x)'),
+]
+
+KERNEL = '''T a;
+T b;
+
+float kernel(int n)
+{
+   T x;
+   T y;
+   T acc;
+   float s;
+   int i;
+
+   x = a;
+   y = b;
+   s = 0.5;
+   acc = T(0.0);
+   for (i = 0; i < n; i++) {
+      acc += EXPR;
+      x += y;
+   }
+   return SUM;
+}
+'''
+
+CROSS = 'vec4(cross(x.xyz, y.xyz), 0.0)'
+
+LANES = {'vec2': 2, 'vec3': 3, 'vec4': 4}
+
+
+def Kernel(name, expr, ty):
+  if name == 'cross':
+    expr, ty = CROSS, 'vec4'
+  # every lane is used, so none of the work can be dropped
+  total = ' + '.join(['acc.' + lane for lane in 'xyzw'[:LANES[ty]]])
+  return KERNEL.replace('EXPR', expr).replace('SUM', total).replace('T(', ty + '(').replace('T ', ty + ' ')
+
+
+def Spec(ty, n):
+  lanes = LANES[ty]
+  a = ', '.join(['%.2f' % (0.25 + 0.5 * i) for i in range(lanes)])
+  b = ', '.join(['%.4f' % (0.001 * (i + 1)) for i in range(lanes)])
+  return 'funct: kernel\nparam: int, %d\ngin: a, %s, %s\ngin: b, %s, %s\n' % (n, ty, a, ty, b)
+
+
+def main():
+  parser = argparse.ArgumentParser(description = 'Time each built-in function.')
+  parser.add_argument('--glc', default = './glc', help = 'compiler to run (default ./glc)')
+  parser.add_argument('--glbench', default = './glbench', help = 'benchmark tool (default ./glbench)')
+  parser.add_argument('--type', default = 'vec4', choices = sorted(LANES), help = 'operand type')
+  parser.add_argument('--n', type = int, default = 1000, help = 'iterations per call')
+  parser.add_argument('--only', default = '', help = 'comma separated built-ins to run')
+  parser.add_argument('--flags', default = '', help = 'extra glbench options, separated by spaces')
+  parser.add_argument('--glc-flags', default = '', help = 'extra glc options, separated by spaces')
+  args = parser.parse_args()
+
+  only = [name for name in args.only.split(',') if name]
+  work = tempfile.mkdtemp(prefix = 'glc-builtins-')
+  status = 0
+  for name, expr in EXPRESSIONS:
+    if only and name not in only:
+      continue
+    base = os.path.join(work, name)
+    with open(base + '.glsl', 'w') as f:
+      f.write(Kernel(name, expr, args.type))
+    with open(base + '.dat', 'w') as f:
+      f.write(Spec('vec4' if name == 'cross' else args.type, args.n))
+
+    print('== %s' % name)
+    sys.stdout.flush()
+    with open(base + '.glsl') as source:
+      with open(base + '.bc', 'w') as out:
+        if subprocess.call([args.glc, '-fentry=kernel'] + args.glc_flags.split(), stdin = source, stdout = out) != 0:
+          print('   (does not compile)')
+          status = 1
+          continue
+    if subprocess.call([args.glbench, '-O2'] + args.flags.split() + [base + '.bc', base + '.dat']) != 0:
+      status = 1
+
+  for name in os.listdir(work):
+    os.remove(os.path.join(work, name))
+  os.rmdir(work)
+  sys.exit(status)
+
+
+if __name__ == '__main__':
+  main()
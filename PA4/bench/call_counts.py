@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+#
+# File: call_counts.py
+#
+# Counts the calls left in each shader after glc's inliner (see inline.h).
+# Every shader is compiled once with -finline and the "calls" and "calls
+# after inline" counters are read back from the -ftime-trace file:
+#
+#   python3 bench/call_counts.py cse131_testcases/*.glsl bench/shaders/*.glsl
+#
+# --flags passes extra options, e.g. --flags=-finline=80 to try another
+# threshold.
+
+import os
+import sys
+import json
+import argparse
+import tempfile
+import subprocess
+
+
+def Counts(glc, shader, flags, trace):
+  with open(shader) as source:
+    with open(os.devnull, 'w') as sink:
+      status = subprocess.call([glc, '-ftime-trace=' + trace, '-finline'] + flags,
+                               stdin = source, stdout = sink)
+  if status != 0:
+    return None
+  with open(trace) as f:
+    counts = json.load(f).get('otherData', {})
+  return counts.get('calls', 0), counts.get('calls after inline', 0)
+
+
+def main():
+  parser = argparse.ArgumentParser(description = 'Count calls before and after inlining.')
+  parser.add_argument('shaders', nargs = '+')
+  parser.add_argument('--glc', default = './glc', help = 'compiler to run (default ./glc)')
+  parser.add_argument('--flags', default = '', help = 'extra glc options, separated by spaces')
+  args = parser.parse_args()
+
+  trace = os.path.join(tempfile.mkdtemp(prefix = 'glc-calls-'), 'trace.json')
+  before = after = 0
+  print('%-30s %8s %8s' % ('shader', 'before', 'after'))
+  for shader in args.shaders:
+    counts = Counts(args.glc, shader, args.flags.split(), trace)
+    if counts is None:
+      print('%-30s   (does not compile)' % os.path.basename(shader))
+      continue
+    before, after = before + counts[0], after + counts[1]
+    if counts[0]:
+      print('%-30s %8d %8d' % (os.path.basename(shader), counts[0], counts[1]))
+  print('%-30s %8d %8d' % ('total', before, after))
+  if os.path.exists(trace):
+    os.remove(trace)
+  os.rmdir(os.path.dirname(trace))
+
+
+if __name__ == '__main__':
+  main()
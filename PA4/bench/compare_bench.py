@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+#
+# File: compare_bench.py
+#
+# Compares two result files written by run_bench.py, typically one from
+# the previous commit and one from the current one:
+#
+#   python3 bench/compare_bench.py base.json new.json [--threshold 0.10]
+#
+# Prints the change in compile time of every workload and pipeline found
+# in both files, and in the number of instructions emitted, and exits with
+# status 1 if any of them got slower by more than the threshold (a
+# fraction; the default allows 10%).  Instruction counts are reported but
+# never fail the comparison.
+
+import sys
+import json
+import argparse
+
+
+def Load(fileName):
+  with open(fileName) as f:
+    data = json.load(f)
+  return dict(((r['workload'], r['pipeline']), r) for r in data['results'])
+
+
+def main():
+  parser = argparse.ArgumentParser(description = 'Compare two glc benchmark result files.')
+  parser.add_argument('base')
+  parser.add_argument('new')
+  parser.add_argument('--threshold', type = float, default = 0.10,
+                      help = 'largest allowed slowdown, as a fraction (default 0.10)')
+  args = parser.parse_args()
+
+  base, new = Load(args.base), Load(args.new)
+  regressions = 0
+
+  print('%-10s %-6s %10s %10s %8s %10s %8s' %
+        ('workload', 'pipe', 'base (s)', 'new (s)', 'change', 'insts', 'change'))
+  for key in sorted(set(base) & set(new)):
+    before, after = base[key]['seconds'], new[key]['seconds']
+    change = (after - before) / before if before > 0 else 0.0
+    flag = ''
+    if change > args.threshold:
+      flag = '  REGRESSION'
+      regressions += 1
+    insts = ''
+    baseInsts, newInsts = base[key].get('instructions', 0), new[key].get('instructions', 0)
+    if baseInsts > 0 and newInsts > 0:
+      insts = '%10d %+7.1f%%' % (newInsts, (newInsts - baseInsts) * 100.0 / baseInsts)
+    print('%-10s %-6s %10.4f %10.4f %+7.1f%% %s%s' %
+          (key[0], key[1], before, after, change * 100, insts, flag))
+
+  for key in sorted(set(base) ^ set(new)):
+    print('%-10s %-6s only in %s' % (key[0], key[1], args.base if key in base else args.new))
+
+  if regressions:
+    print('%d measurement(s) slower by more than %.0f%%' % (regressions, args.threshold * 100))
+    sys.exit(1)
+
+
+if __name__ == '__main__':
+  main()
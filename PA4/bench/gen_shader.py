@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+#
+# File: gen_shader.py
+#
+# Generates large synthetic shaders for timing glc.  Every shape is
+# controlled by a parameter so one construct can be scaled on its own:
+#
+#   --functions N   number of generated functions
+#   --depth N       nesting depth of if/for/while statements in each function
+#   --chain N       number of operands in each long arithmetic expression
+#   --switch N      number of cases in each function's switch statement
+#   --globals N     number of global variables (read by the functions)
+#   --swizzles N    number of vec4 swizzle statements in each function
+#
+# The shader is written to stdout.  It only uses constructs glc accepts,
+# and the generated code is deterministic for a given set of parameters.
+
+import sys
+import argparse
+
+DEFAULTS = {
+  'functions': 16,
+  'depth': 3,
+  'chain': 16,
+  'switch': 8,
+  'globals': 16,
+  'swizzles': 8,
+}
+
+SWIZZLES = ['xyzw', 'wzyx', 'yxwz', 'zwxy', 'xxyy', 'zzww', 'xy', 'zw', 'yx', 'x', 'w']
+STORE_SWIZZLES = ['xy', 'zw', 'yx', 'wz', 'xz', 'yw', 'x', 'y', 'z', 'w']
+OPS = ['+', '-', '*', '+', '-']
+
+
+def GlobalName(i, params):
+  return 'g%d' % (i % params['globals'])
+
+
+def EmitChain(out, indent, fn, params):
+  # x = x + a * 1.25 - g3 * 0.5 + ...  (a long left-leaning expression)
+  terms = []
+  for i in range(params['chain']):
+    if params['globals'] and i % 3 == 2:
+      terms.append(GlobalName(fn + i, params))
+    elif i % 2 == 0:
+      terms.append('a')
+    else:
+      terms.append('%d.%d' % (i % 7 + 1, (fn + i) % 10))
+  expr = 'x'
+  for i, term in enumerate(terms):
+    expr += ' %s %s' % (OPS[i % len(OPS)], term)
+  out.append('%sx = %s;' % (indent, expr))
+
+
+def EmitNest(out, indent, level, fn, params):
+  if level == params['depth']:
+    EmitChain(out, indent, fn + level, params)
+    return
+  kind = level % 3
+  if kind == 0:
+    out.append('%sif (x > %d.0) {' % (indent, level))
+    EmitNest(out, indent + '  ', level + 1, fn, params)
+    out.append('%s} else {' % indent)
+    out.append('%s  x = x - a;' % indent)
+    out.append('%s}' % indent)
+  elif kind == 1:
+    out.append('%sfor (i%d = 0; i%d < 4; i%d++) {' % (indent, level, level, level))
+    EmitNest(out, indent + '  ', level + 1, fn, params)
+    out.append('%s}' % indent)
+  else:
+    out.append('%swhile (x < %d.0) {' % (indent, level * 10))
+    EmitNest(out, indent + '  ', level + 1, fn, params)
+    out.append('%s  x = x + 1.0;' % indent)
+    out.append('%s}' % indent)
+
+
+def EmitSwitch(out, indent, params):
+  out.append('%sswitch (n) {' % indent)
+  for i in range(params['switch']):
+    out.append('%scase %d:' % (indent, i))
+    out.append('%s  x = x + %d.0;' % (indent, i))
+    out.append('%s  break;' % indent)
+  out.append('%sdefault:' % indent)
+  out.append('%s  x = 0.0;' % indent)
+  out.append('%s}' % indent)
+
+
+def EmitSwizzles(out, indent, fn, params):
+  for i in range(params['swizzles']):
+    k = fn + i
+    load = SWIZZLES[k % len(SWIZZLES)]
+    store = STORE_SWIZZLES[k % len(STORE_SWIZZLES)]
+    if len(load) == 4:
+      out.append('%sv = v.%s * 0.5 + v;' % (indent, load))
+    else:
+      out.append('%sx = x + v.%s * v.%s;' % (indent, load[0], 'xyzw'[k % 4]))
+    out.append('%sv.%s = v.%s;' % (indent, store, store[::-1]))
+
+
+def EmitFunction(out, fn, params):
+  out.append('float f%d(float a, int n, vec4 v) {' % fn)
+  out.append('  float x;')
+  for level in range(params['depth']):
+    if level % 3 == 1:
+      out.append('  int i%d;' % level)
+  out.append('  x = a;')
+  EmitNest(out, '  ', 0, fn, params)
+  if params['switch']:
+    EmitSwitch(out, '  ', params)
+  EmitSwizzles(out, '  ', fn, params)
+  if fn > 0:
+    out.append('  x = x + f%d(x, n, v);' % (fn - 1))
+  out.append('  return x + v.x + v.y + v.z + v.w;')
+  out.append('}')
+  out.append('')
+
+
+def Generate(params):
+  out = []
+  for i in range(params['globals']):
+    out.append('float g%d;' % i)
+  out.append('')
+  for fn in range(params['functions']):
+    EmitFunction(out, fn, params)
+  return '\n'.join(out) + '\n'
+
+
+def main():
+  parser = argparse.ArgumentParser(description = 'Generate a large shader for timing glc.')
+  for name in sorted(DEFAULTS):
+    parser.add_argument('--' + name, type = int, default = DEFAULTS[name])
+  args = parser.parse_args()
+  sys.stdout.write(Generate(vars(args)))
+
+
+if __name__ == '__main__':
+  main()
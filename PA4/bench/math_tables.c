@@ -0,0 +1,152 @@
+/* File: math_tables.c
+ * -------------------
+ * Accuracy and throughput of the bundled math library (glmath.c) next to
+ * libm.  Each function is evaluated on evenly spaced points of a range
+ * and compared with the double precision libm result; the tables give
+ * the worst error in ulp and the time per float over many passes:
+ *
+ *   make mathtables
+ *
+ * Built natively against glmath.c rather than through glc, so it times
+ * the same code glc inlines without needing a shader around it.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef float vfloat __attribute__((vector_size(16)));
+
+#define GLMATH(name) \
+    vfloat glmath_##name(vfloat); \
+    vfloat glmath_##name##_fast(vfloat);
+
+GLMATH(sin) GLMATH(cos) GLMATH(tan) GLMATH(exp) GLMATH(exp2)
+GLMATH(log) GLMATH(log2) GLMATH(atan)
+
+vfloat glmath_pow(vfloat, vfloat);
+vfloat glmath_pow_fast(vfloat, vfloat);
+
+/* pow is timed and measured with a fixed exponent */
+static const float PowExponent = 2.4f;
+
+static vfloat PowPrecise(vfloat x) { vfloat y = { PowExponent, PowExponent, PowExponent, PowExponent }; return glmath_pow(x, y); }
+static vfloat PowFast(vfloat x) { vfloat y = { PowExponent, PowExponent, PowExponent, PowExponent }; return glmath_pow_fast(x, y); }
+static double PowReference(double x) { return pow(x, PowExponent); }
+static float PowLibm(float x) { return powf(x, PowExponent); }
+
+typedef struct {
+    const char *name;
+    float low, high;
+    vfloat (*precise)(vfloat);
+    vfloat (*fast)(vfloat);
+    double (*reference)(double);
+    float (*libm)(float);
+} Function;
+
+static const Function functions[] = {
+    { "sin", -100.0f, 100.0f, glmath_sin, glmath_sin_fast, sin, sinf },
+    { "sin", -8192.0f, 8192.0f, glmath_sin, glmath_sin_fast, sin, sinf },
+    { "sin", -1e30f, 1e30f, glmath_sin, glmath_sin_fast, sin, sinf },
+    { "cos", -100.0f, 100.0f, glmath_cos, glmath_cos_fast, cos, cosf },
+    { "tan", -1.5f, 1.5f, glmath_tan, glmath_tan_fast, tan, tanf },
+    { "exp", -87.0f, 88.0f, glmath_exp, glmath_exp_fast, exp, expf },
+    { "exp2", -126.0f, 127.0f, glmath_exp2, glmath_exp2_fast, exp2, exp2f },
+    { "log", 1e-30f, 1e30f, glmath_log, glmath_log_fast, log, logf },
+    { "log2", 1e-30f, 1e30f, glmath_log2, glmath_log2_fast, log2, log2f },
+    { "pow", 0.001f, 1000.0f, PowPrecise, PowFast, PowReference, PowLibm },
+    { "atan", -100.0f, 100.0f, glmath_atan, glmath_atan_fast, atan, atanf },
+};
+
+enum { NumPoints = 1 << 20, NumPasses = 50 };
+
+static float points[NumPoints] __attribute__((aligned(16)));
+static float results[NumPoints] __attribute__((aligned(16)));
+
+/* The error of f in units of the last place of the float nearest ref. */
+static double Ulps(float f, double ref) {
+    float nearest = (float)ref;
+    if (isnan(ref) || isinf(nearest))
+        return (f == nearest || (isnan(f) && isnan(ref))) ? 0.0 : INFINITY;
+    float ulp = nextafterf(fabsf(nearest), INFINITY) - fabsf(nearest);
+    return fabs(f - ref) / ulp;
+}
+
+static double Seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static void RunVector(vfloat (*f)(vfloat)) {
+    for (int i = 0; i < NumPoints; i += 4)
+        *(vfloat *)&results[i] = f(*(vfloat *)&points[i]);
+}
+
+static void RunScalar(float (*f)(float)) {
+    for (int i = 0; i < NumPoints; i++)
+        results[i] = f(points[i]);
+}
+
+static double MaxUlps(const Function *fn) {
+    double worst = 0;
+    for (int i = 0; i < NumPoints; i++) {
+        double error = Ulps(results[i], fn->reference(points[i]));
+        if (error > worst)
+            worst = error;
+    }
+    return worst;
+}
+
+/* sin and cos near their zeros are only good to an absolute error in the
+ * fast variant, which the ulp column cannot show. */
+static double MaxAbsolute(const Function *fn) {
+    double worst = 0;
+    for (int i = 0; i < NumPoints; i++) {
+        double error = fabs(results[i] - fn->reference(points[i]));
+        if (error > worst)
+            worst = error;
+    }
+    return worst;
+}
+
+/* Nanoseconds per float; run is RunVector or RunScalar on f. */
+#define TIME(run, f) ({ \
+    double start = Seconds(); \
+    for (int pass = 0; pass < NumPasses; pass++) \
+        run(f); \
+    (Seconds() - start) * 1e9 / ((double)NumPasses * NumPoints); })
+
+int main(void) {
+    printf("%-6s %-18s %10s %10s %10s %10s %10s %10s %10s\n", "", "range",
+           "precise", "fast", "fast", "libm", "precise", "fast", "libm");
+    printf("%-6s %-18s %10s %10s %10s %10s %10s %10s %10s\n", "", "",
+           "ulp", "ulp", "abs", "ulp", "ns", "ns", "ns");
+
+    for (size_t n = 0; n < sizeof(functions) / sizeof(functions[0]); n++) {
+        const Function *fn = &functions[n];
+        // log and pow span many binades, so their points are spaced
+        // evenly in the exponent instead
+        int logarithmic = fn->low > 0;
+        for (int i = 0; i < NumPoints; i++) {
+            double t = (double)i / (NumPoints - 1);
+            points[i] = logarithmic ? fn->low * pow((double)fn->high / fn->low, t)
+                                    : fn->low + (fn->high - fn->low) * t;
+        }
+
+        double nsPrecise = TIME(RunVector, fn->precise);
+        double ulpPrecise = MaxUlps(fn);
+        double nsFast = TIME(RunVector, fn->fast);
+        double ulpFast = MaxUlps(fn);
+        double absFast = MaxAbsolute(fn);
+        double nsLibm = TIME(RunScalar, fn->libm);
+        double ulpLibm = MaxUlps(fn);
+
+        char range[32];
+        snprintf(range, sizeof(range), "[%g, %g]", fn->low, fn->high);
+        printf("%-6s %-18s %10.2f %10.2f %10.1e %10.2f %10.2f %10.2f %10.2f\n", fn->name, range,
+               ulpPrecise, ulpFast, absFast, ulpLibm, nsPrecise, nsFast, nsLibm);
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+#
+# File: run_bench.py
+#
+# Compile-throughput benchmark for glc.  Generates one large shader per
+# workload with gen_shader.py and compiles each of them through four
+# pipelines:
+#
+#   scan    scanner only                      (-fstop-after=scan)
+#   parse   scanner and parser                (-fstop-after=parse)
+#   check   parse and IR construction, which  (-fstop-after=emit)
+#           is where glc resolves and checks
+#           types; no bitcode is written
+#   full    the whole compile, bitcode included
+#
+# Each compile is repeated and the fastest run is kept.  Lines and tokens,
+# and the number of blocks and instructions emitted, come from the
+# -ftime-trace file glc writes, along with the time spent in each phase.
+# Results are written as JSON (see compare_bench.py):
+#
+#   python3 bench/run_bench.py --out bench-results.json
+#
+# --flags passes extra options to every compile, so the effect of an
+# option can be measured by comparing a run with it against one without:
+#
+#   python3 bench/run_bench.py --flags=-flean-ir --out lean.json
+
+import os
+import sys
+import json
+import time
+import shutil
+import argparse
+import tempfile
+import subprocess
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import gen_shader
+
+# Each workload scales one construct (the second field, which --scale
+# multiplies) well past what the test cases use and leaves the others at
+# small values.
+WORKLOADS = [
+  ('functions', 'functions', {'functions': 2000, 'depth': 1, 'chain': 4, 'switch': 2, 'globals': 4, 'swizzles': 1}),
+  ('nesting', 'depth', {'functions': 20, 'depth': 60, 'chain': 4, 'switch': 0, 'globals': 4, 'swizzles': 0}),
+  ('chains', 'chain', {'functions': 20, 'depth': 1, 'chain': 2000, 'switch': 0, 'globals': 16, 'swizzles': 0}),
+  ('switch', 'switch', {'functions': 20, 'depth': 1, 'chain': 4, 'switch': 1000, 'globals': 4, 'swizzles': 0}),
+  ('globals', 'globals', {'functions': 200, 'depth': 1, 'chain': 30, 'switch': 0, 'globals': 5000, 'swizzles': 0}),
+  ('swizzle', 'swizzles', {'functions': 50, 'depth': 1, 'chain': 4, 'switch': 0, 'globals': 4, 'swizzles': 400}),
+  ('mixed', 'functions', {'functions': 200, 'depth': 6, 'chain': 40, 'switch': 40, 'globals': 200, 'swizzles': 40}),
+]
+
+PIPELINES = [
+  ('scan', ['-fstop-after=scan']),
+  ('parse', ['-fstop-after=parse']),
+  ('check', ['-fstop-after=emit']),
+  ('full', []),
+]
+
+
+def Compile(glc, shader, flags, trace):
+  # Returns the wall time of one compile and the trace it wrote.
+  with open(shader) as source:
+    with open(os.devnull, 'w') as sink:
+      start = time.time()
+      status = subprocess.call([glc, '-ftime-trace=' + trace] + flags,
+                               stdin = source, stdout = sink)
+      elapsed = time.time() - start
+  if status != 0:
+    raise RuntimeError('%s failed on %s (exit status %d)' % (glc, shader, status))
+  with open(trace) as f:
+    return elapsed, json.load(f)
+
+
+def PhaseTimes(trace):
+  # Sums the trace spans by category, so all the per-function emission
+  # spans add up under "function".
+  phases = {}
+  for event in trace['traceEvents']:
+    phases[event['cat']] = phases.get(event['cat'], 0.0) + event['dur'] * 1e-6
+  return phases
+
+
+def Measure(glc, shader, flags, trace, reps):
+  best = None
+  for _ in range(reps):
+    elapsed, data = Compile(glc, shader, flags, trace)
+    if best is None or elapsed < best[0]:
+      best = (elapsed, data)
+  return best
+
+
+def GitRevision():
+  try:
+    rev = subprocess.check_output(['git', 'rev-parse', 'HEAD'], stderr = subprocess.STDOUT)
+    return rev.decode('ascii').strip()
+  except Exception:
+    return None
+
+
+def main():
+  parser = argparse.ArgumentParser(description = 'Measure glc compile throughput.')
+  parser.add_argument('--glc', default = './glc', help = 'compiler to run (default ./glc)')
+  parser.add_argument('--out', default = 'bench-results.json', help = 'results file')
+  parser.add_argument('--reps', type = int, default = 5, help = 'runs per measurement')
+  parser.add_argument('--scale', type = float, default = 1.0,
+                      help = 'multiplies the size parameter each workload scales')
+  parser.add_argument('--workload', action = 'append',
+                      help = 'only run the named workload (may be repeated)')
+  parser.add_argument('--flags', default = '', help = 'extra glc options, separated by spaces')
+  args = parser.parse_args()
+
+  workdir = tempfile.mkdtemp(prefix = 'glc-bench-')
+  trace = os.path.join(workdir, 'trace.json')
+  results = []
+
+  for name, scaled, params in WORKLOADS:
+    if args.workload and name not in args.workload:
+      continue
+    params = dict(params)
+    params[scaled] = max(1, int(params[scaled] * args.scale))
+    shader = os.path.join(workdir, name + '.glsl')
+    with open(shader, 'w') as f:
+      f.write(gen_shader.Generate(params))
+
+    for pipeline, flags in PIPELINES:
+      elapsed, data = Measure(args.glc, shader, flags + args.flags.split(), trace, args.reps)
+      counts = data.get('otherData', {})
+      lines, tokens = counts.get('lines', 0), counts.get('tokens', 0)
+      results.append({
+        'workload': name,
+        'params': params,
+        'pipeline': pipeline,
+        'lines': lines,
+        'tokens': tokens,
+        'blocks': counts.get('blocks', 0),
+        'instructions': counts.get('instructions', 0),
+        'seconds': elapsed,
+        'lines_per_sec': lines / elapsed if elapsed > 0 else 0,
+        'tokens_per_sec': tokens / elapsed if elapsed > 0 else 0,
+        'phases': PhaseTimes(data),
+      })
+      print('%-10s %-6s %8d lines %9d tokens %9.4f s %12.0f lines/s %12.0f tokens/s' %
+            (name, pipeline, lines, tokens, elapsed,
+             results[-1]['lines_per_sec'], results[-1]['tokens_per_sec']))
+
+  with open(args.out, 'w') as f:
+    json.dump({'glc': args.glc, 'flags': args.flags, 'revision': GitRevision(), 'reps': args.reps,
+               'scale': args.scale, 'results': results}, f, indent = 1, sort_keys = True)
+  shutil.rmtree(workdir)
+  print('wrote %s' % args.out)
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+#
+# File: scaling.py
+#
+# Guards glc against superlinear compile time.  For each construct below,
+# a shader is generated at sizes N, 2N, 4N and 8N (using gen_shader.py)
+# and compiled with -ftime-trace.  The growth exponent k of each phase's
+# time, t ~ N^k, is fitted by least squares on log t against log N.  A
+# phase fails when k exceeds the exponent N log N shows over the same
+# range, plus a tolerance for timing noise:
+#
+#   python3 bench/scaling.py [--tolerance 0.25] [--construct switch ...]
+#
+# Exits with status 1 if any phase fails.  Phases too fast to time
+# reliably (see --min-time) are reported but not judged.
+
+import os
+import sys
+import math
+import json
+import shutil
+import argparse
+import tempfile
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import gen_shader
+import run_bench
+
+# construct name, the generator parameter scaled, its base size N, and the
+# other parameters.  Each targets one of the hot paths: switch flattening,
+# symbol table scope walks, recursive emission of long expressions,
+# swizzled vector stores, and lookups among many globals.
+CONSTRUCTS = [
+  ('switch', 'switch', 250, {'functions': 2, 'depth': 1, 'chain': 2, 'globals': 1, 'swizzles': 0}),
+  ('nesting', 'depth', 40, {'functions': 4, 'chain': 2, 'switch': 0, 'globals': 1, 'swizzles': 0}),
+  ('chain', 'chain', 1000, {'functions': 2, 'depth': 1, 'switch': 0, 'globals': 8, 'swizzles': 0}),
+  ('swizzle', 'swizzles', 250, {'functions': 2, 'depth': 1, 'chain': 2, 'switch': 0, 'globals': 1}),
+  ('globals', 'globals', 1000, {'functions': 50, 'depth': 1, 'chain': 40, 'switch': 0, 'swizzles': 0}),
+  ('functions', 'functions', 250, {'depth': 2, 'chain': 8, 'switch': 4, 'globals': 8, 'swizzles': 4}),
+]
+
+SCALES = [1, 2, 4, 8]
+
+
+def FitExponent(sizes, times):
+  xs = [math.log(n) for n in sizes]
+  ys = [math.log(t) for t in times]
+  mx, my = sum(xs) / len(xs), sum(ys) / len(ys)
+  sxy = sum((x - mx) * (y - my) for x, y in zip(xs, ys))
+  sxx = sum((x - mx) ** 2 for x in xs)
+  return sxy / sxx
+
+
+def NLogNExponent(sizes):
+  # The exponent a least-squares fit finds for t = N log N over these sizes.
+  return FitExponent(sizes, [n * math.log(n) for n in sizes])
+
+
+def Phases(elapsed, trace):
+  phases = run_bench.PhaseTimes(trace)
+  phases['total'] = elapsed
+  return phases
+
+
+def main():
+  parser = argparse.ArgumentParser(description = 'Check that glc compile time grows at most as N log N.')
+  parser.add_argument('--glc', default = './glc', help = 'compiler to run (default ./glc)')
+  parser.add_argument('--reps', type = int, default = 3, help = 'runs per size; the fastest is kept')
+  parser.add_argument('--tolerance', type = float, default = 0.25,
+                      help = 'allowed excess over the N log N exponent (default 0.25)')
+  parser.add_argument('--min-time', type = float, default = 0.005,
+                      help = 'phases faster than this at the largest size are not judged (seconds)')
+  parser.add_argument('--construct', action = 'append', help = 'only run the named construct')
+  args = parser.parse_args()
+
+  workdir = tempfile.mkdtemp(prefix = 'glc-scaling-')
+  trace = os.path.join(workdir, 'trace.json')
+  failures = []
+
+  for name, scaled, base, params in CONSTRUCTS:
+    if args.construct and name not in args.construct:
+      continue
+    sizes = [base * s for s in SCALES]
+    runs = []
+    for size in sizes:
+      p = dict(params)
+      p[scaled] = size
+      shader = os.path.join(workdir, '%s-%d.glsl' % (name, size))
+      with open(shader, 'w') as f:
+        f.write(gen_shader.Generate(p))
+      elapsed, data = run_bench.Measure(args.glc, shader, [], trace, args.reps)
+      runs.append(Phases(elapsed, data))
+
+    limit = NLogNExponent(sizes) + args.tolerance
+    for phase in sorted(runs[-1]):
+      times = [r.get(phase, 0.0) for r in runs]
+      if times[-1] < args.min_time or min(times) <= 0:
+        print('%-10s %-16s  too fast to judge (%.4f s at N=%d)' % (name, phase, times[-1], sizes[-1]))
+        continue
+      k = FitExponent(sizes, times)
+      status = 'ok'
+      if k > limit:
+        status = 'FAIL'
+        failures.append((name, phase, k))
+      print('%-10s %-16s  exponent %5.2f (limit %.2f)  %s  [%s]' %
+            (name, phase, k, limit, status, ' '.join('%.4f' % t for t in times)))
+
+  shutil.rmtree(workdir)
+  if failures:
+    print('%d phase(s) grow faster than N log N:' % len(failures))
+    for name, phase, k in failures:
+      print('  %s: %s ~ N^%.2f' % (name, phase, k))
+    sys.exit(1)
+
+
+if __name__ == '__main__':
+  main()
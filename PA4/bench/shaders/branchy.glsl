@@ -0,0 +1,30 @@
+vec4 acc;
+float lo;
+float hi;
+
+float branchy(int n)
+{
+   vec4 v;
+   float s;
+   int state;
+   int q;
+   bool bit;
+   int i;
+
+   v = acc;
+   s = 0.0;
+   state = 7;
+   for (i = 0; i < n; i++) {
+      state = state * 1103515245 + 12345;
+      q = state / 65536;
+      bit = q - (q / 2) * 2 == 0;
+
+      s += bit ? v.x : v.y;
+      v = bit && s > lo ? v * 0.5 : v + 1.0;
+      if (s < lo || s > hi) {
+         s = bit ? lo : hi;
+      }
+   }
+   acc = v;
+   return s + v.x + v.y + v.z + v.w;
+}
@@ -0,0 +1,574 @@
+// A library-style shader: many helpers, of which the entry point
+// "shade" uses a few.  The rest are still emitted to check them, so
+// compare the bitcode size of "glc -fentry=shade" with and without
+// -fkeep-unused to see what dropping them saves.
+
+vec4 color;
+vec3 normal;
+float gain;
+
+vec4 table0;
+vec4 table1;
+vec4 table2;
+vec4 table3;
+vec4 table4;
+vec4 table5;
+vec4 table6;
+vec4 table7;
+vec4 table8;
+vec4 table9;
+vec4 table10;
+vec4 table11;
+
+float helper0(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 0.5;
+   for (k = 0; k < 2; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper1(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 1.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table1.x;
+   }
+   return s;
+}
+
+float helper2(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 2.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper3(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 3.5;
+   s = s * s - t;
+   s += helper2(v.wzyx, s);
+   return s;
+}
+
+float helper4(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 4.5;
+   for (k = 0; k < 6; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper5(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 5.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table5.x;
+   }
+   return s;
+}
+
+float helper6(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 6.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper7(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 7.5;
+   s = s * s - t;
+   s += helper6(v.wzyx, s);
+   return s;
+}
+
+float helper8(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 8.5;
+   for (k = 0; k < 5; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper9(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 0.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table9.x;
+   }
+   return s;
+}
+
+float helper10(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 1.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper11(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 2.5;
+   s = s * s - t;
+   s += helper10(v.wzyx, s);
+   return s;
+}
+
+float helper12(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 3.5;
+   for (k = 0; k < 4; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper13(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 4.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table1.x;
+   }
+   return s;
+}
+
+float helper14(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 5.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper15(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 6.5;
+   s = s * s - t;
+   s += helper14(v.wzyx, s);
+   return s;
+}
+
+float helper16(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 7.5;
+   for (k = 0; k < 3; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper17(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 8.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table5.x;
+   }
+   return s;
+}
+
+float helper18(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 0.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper19(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 1.5;
+   s = s * s - t;
+   s += helper18(v.wzyx, s);
+   return s;
+}
+
+float helper20(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 2.5;
+   for (k = 0; k < 2; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper21(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 3.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table9.x;
+   }
+   return s;
+}
+
+float helper22(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 4.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper23(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 5.5;
+   s = s * s - t;
+   s += helper22(v.wzyx, s);
+   return s;
+}
+
+float helper24(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 6.5;
+   for (k = 0; k < 6; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper25(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 7.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table1.x;
+   }
+   return s;
+}
+
+float helper26(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 8.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper27(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 0.5;
+   s = s * s - t;
+   s += helper26(v.wzyx, s);
+   return s;
+}
+
+float helper28(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 1.5;
+   for (k = 0; k < 5; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper29(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 2.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table5.x;
+   }
+   return s;
+}
+
+float helper30(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 3.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper31(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 4.5;
+   s = s * s - t;
+   s += helper30(v.wzyx, s);
+   return s;
+}
+
+float helper32(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 5.5;
+   for (k = 0; k < 4; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper33(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 6.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table9.x;
+   }
+   return s;
+}
+
+float helper34(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 7.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper35(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 8.5;
+   s = s * s - t;
+   s += helper34(v.wzyx, s);
+   return s;
+}
+
+float helper36(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 0.5;
+   for (k = 0; k < 3; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper37(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 1.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table1.x;
+   }
+   return s;
+}
+
+float helper38(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 2.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper39(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 3.5;
+   s = s * s - t;
+   s += helper38(v.wzyx, s);
+   return s;
+}
+
+float helper40(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 4.5;
+   for (k = 0; k < 2; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper41(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 5.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table5.x;
+   }
+   return s;
+}
+
+float helper42(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 6.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper43(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 7.5;
+   s = s * s - t;
+   s += helper42(v.wzyx, s);
+   return s;
+}
+
+float helper44(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 8.5;
+   for (k = 0; k < 6; k++) {
+      s += v.x * v.y - s * 0.25;
+   }
+   return s;
+}
+
+float helper45(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 0.5;
+   if (s > v.z) {
+      s = s - v.w;
+   } else {
+      s = s + table9.x;
+   }
+   return s;
+}
+
+float helper46(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 1.5;
+   v.xy = v.yx * t;
+   v.zw += v.xy;
+   s += v.x + v.y + v.z + v.w;
+   return s;
+}
+
+float helper47(vec4 v, float t)
+{
+   float s;
+   int k;
+   s = t * 2.5;
+   s = s * s - t;
+   s += helper46(v.wzyx, s);
+   return s;
+}
+
+float shade(int n)
+{
+   float s;
+   int i;
+
+   s = gain;
+   for (i = 0; i < n; i++) {
+      s += helper3(color, s) * 0.125;
+      s -= helper10(color.wzyx, 0.5) * 0.0625;
+   }
+   return s;
+}
@@ -0,0 +1,733 @@
+vec4 acc;
+
+float switch_jump(int n)
+{
+   vec4 v;
+   float s;
+   int state;
+   int q;
+   int k;
+   int i;
+
+   v = acc;
+   s = 0.0;
+   state = 11;
+   for (i = 0; i < n; i++) {
+      state = state * 1103515245 + 12345;
+      q = state / 65536;
+      if (q < 0) {
+         q = 0 - q;
+      }
+      k = q - (q / 256) * 256;
+      switch (k) {
+      case 0:
+         s += v.x;
+         break;
+      case 1:
+         s -= v.y;
+         break;
+      case 2:
+         v.x += s * 0.25;
+         break;
+      case 3:
+         s += v.z * 4.0;
+      case 4:
+         v.yz *= 0.5;
+         break;
+      case 5:
+         s += 1.0;
+         break;
+      case 6:
+         s += v.x;
+         break;
+      case 7:
+         s -= v.y;
+      case 8:
+         v.x += s * 0.25;
+         break;
+      case 9:
+         s += v.z * 5.0;
+         break;
+      case 10:
+         v.yz *= 0.5;
+         break;
+      case 11:
+         s += 1.0;
+      case 12:
+         s += v.x;
+         break;
+      case 13:
+         s -= v.y;
+         break;
+      case 14:
+         v.x += s * 0.25;
+         break;
+      case 15:
+         s += v.z * 1.0;
+      case 16:
+         v.yz *= 0.5;
+         break;
+      case 17:
+         s += 1.0;
+         break;
+      case 18:
+         s += v.x;
+         break;
+      case 19:
+         s -= v.y;
+      case 20:
+         v.x += s * 0.25;
+         break;
+      case 21:
+         s += v.z * 2.0;
+         break;
+      case 22:
+         v.yz *= 0.5;
+         break;
+      case 23:
+         s += 1.0;
+      case 24:
+         s += v.x;
+         break;
+      case 25:
+         s -= v.y;
+         break;
+      case 26:
+         v.x += s * 0.25;
+         break;
+      case 27:
+         s += v.z * 3.0;
+      case 28:
+         v.yz *= 0.5;
+         break;
+      case 29:
+         s += 1.0;
+         break;
+      case 30:
+         s += v.x;
+         break;
+      case 31:
+         s -= v.y;
+      case 32:
+         v.x += s * 0.25;
+         break;
+      case 33:
+         s += v.z * 4.0;
+         break;
+      case 34:
+         v.yz *= 0.5;
+         break;
+      case 35:
+         s += 1.0;
+      case 36:
+         s += v.x;
+         break;
+      case 37:
+         s -= v.y;
+         break;
+      case 38:
+         v.x += s * 0.25;
+         break;
+      case 39:
+         s += v.z * 5.0;
+      case 40:
+         v.yz *= 0.5;
+         break;
+      case 41:
+         s += 1.0;
+         break;
+      case 42:
+         s += v.x;
+         break;
+      case 43:
+         s -= v.y;
+      case 44:
+         v.x += s * 0.25;
+         break;
+      case 45:
+         s += v.z * 1.0;
+         break;
+      case 46:
+         v.yz *= 0.5;
+         break;
+      case 47:
+         s += 1.0;
+      case 48:
+         s += v.x;
+         break;
+      case 49:
+         s -= v.y;
+         break;
+      case 50:
+         v.x += s * 0.25;
+         break;
+      case 51:
+         s += v.z * 2.0;
+      case 52:
+         v.yz *= 0.5;
+         break;
+      case 53:
+         s += 1.0;
+         break;
+      case 54:
+         s += v.x;
+         break;
+      case 55:
+         s -= v.y;
+      case 56:
+         v.x += s * 0.25;
+         break;
+      case 57:
+         s += v.z * 3.0;
+         break;
+      case 58:
+         v.yz *= 0.5;
+         break;
+      case 59:
+         s += 1.0;
+      case 60:
+         s += v.x;
+         break;
+      case 61:
+         s -= v.y;
+         break;
+      case 62:
+         v.x += s * 0.25;
+         break;
+      case 63:
+         s += v.z * 4.0;
+      case 64:
+         v.yz *= 0.5;
+         break;
+      case 65:
+         s += 1.0;
+         break;
+      case 66:
+         s += v.x;
+         break;
+      case 67:
+         s -= v.y;
+      case 68:
+         v.x += s * 0.25;
+         break;
+      case 69:
+         s += v.z * 5.0;
+         break;
+      case 70:
+         v.yz *= 0.5;
+         break;
+      case 71:
+         s += 1.0;
+      case 72:
+         s += v.x;
+         break;
+      case 73:
+         s -= v.y;
+         break;
+      case 74:
+         v.x += s * 0.25;
+         break;
+      case 75:
+         s += v.z * 1.0;
+      case 76:
+         v.yz *= 0.5;
+         break;
+      case 77:
+         s += 1.0;
+         break;
+      case 78:
+         s += v.x;
+         break;
+      case 79:
+         s -= v.y;
+      case 80:
+         v.x += s * 0.25;
+         break;
+      case 81:
+         s += v.z * 2.0;
+         break;
+      case 82:
+         v.yz *= 0.5;
+         break;
+      case 83:
+         s += 1.0;
+      case 84:
+         s += v.x;
+         break;
+      case 85:
+         s -= v.y;
+         break;
+      case 86:
+         v.x += s * 0.25;
+         break;
+      case 87:
+         s += v.z * 3.0;
+      case 88:
+         v.yz *= 0.5;
+         break;
+      case 89:
+         s += 1.0;
+         break;
+      case 90:
+         s += v.x;
+         break;
+      case 91:
+         s -= v.y;
+      case 92:
+         v.x += s * 0.25;
+         break;
+      case 93:
+         s += v.z * 4.0;
+         break;
+      case 94:
+         v.yz *= 0.5;
+         break;
+      case 95:
+         s += 1.0;
+      case 96:
+         s += v.x;
+         break;
+      case 97:
+         s -= v.y;
+         break;
+      case 98:
+         v.x += s * 0.25;
+         break;
+      case 99:
+         s += v.z * 5.0;
+      case 100:
+         v.yz *= 0.5;
+         break;
+      case 101:
+         s += 1.0;
+         break;
+      case 102:
+         s += v.x;
+         break;
+      case 103:
+         s -= v.y;
+      case 104:
+         v.x += s * 0.25;
+         break;
+      case 105:
+         s += v.z * 1.0;
+         break;
+      case 106:
+         v.yz *= 0.5;
+         break;
+      case 107:
+         s += 1.0;
+      case 108:
+         s += v.x;
+         break;
+      case 109:
+         s -= v.y;
+         break;
+      case 110:
+         v.x += s * 0.25;
+         break;
+      case 111:
+         s += v.z * 2.0;
+      case 112:
+         v.yz *= 0.5;
+         break;
+      case 113:
+         s += 1.0;
+         break;
+      case 114:
+         s += v.x;
+         break;
+      case 115:
+         s -= v.y;
+      case 116:
+         v.x += s * 0.25;
+         break;
+      case 117:
+         s += v.z * 3.0;
+         break;
+      case 118:
+         v.yz *= 0.5;
+         break;
+      case 119:
+         s += 1.0;
+      case 120:
+         s += v.x;
+         break;
+      case 121:
+         s -= v.y;
+         break;
+      case 122:
+         v.x += s * 0.25;
+         break;
+      case 123:
+         s += v.z * 4.0;
+      case 124:
+         v.yz *= 0.5;
+         break;
+      case 125:
+         s += 1.0;
+         break;
+      case 126:
+         s += v.x;
+         break;
+      case 127:
+         s -= v.y;
+      case 128:
+         v.x += s * 0.25;
+         break;
+      case 129:
+         s += v.z * 5.0;
+         break;
+      case 130:
+         v.yz *= 0.5;
+         break;
+      case 131:
+         s += 1.0;
+      case 132:
+         s += v.x;
+         break;
+      case 133:
+         s -= v.y;
+         break;
+      case 134:
+         v.x += s * 0.25;
+         break;
+      case 135:
+         s += v.z * 1.0;
+      case 136:
+         v.yz *= 0.5;
+         break;
+      case 137:
+         s += 1.0;
+         break;
+      case 138:
+         s += v.x;
+         break;
+      case 139:
+         s -= v.y;
+      case 140:
+         v.x += s * 0.25;
+         break;
+      case 141:
+         s += v.z * 2.0;
+         break;
+      case 142:
+         v.yz *= 0.5;
+         break;
+      case 143:
+         s += 1.0;
+      case 144:
+         s += v.x;
+         break;
+      case 145:
+         s -= v.y;
+         break;
+      case 146:
+         v.x += s * 0.25;
+         break;
+      case 147:
+         s += v.z * 3.0;
+      case 148:
+         v.yz *= 0.5;
+         break;
+      case 149:
+         s += 1.0;
+         break;
+      case 150:
+         s += v.x;
+         break;
+      case 151:
+         s -= v.y;
+      case 152:
+         v.x += s * 0.25;
+         break;
+      case 153:
+         s += v.z * 4.0;
+         break;
+      case 154:
+         v.yz *= 0.5;
+         break;
+      case 155:
+         s += 1.0;
+      case 156:
+         s += v.x;
+         break;
+      case 157:
+         s -= v.y;
+         break;
+      case 158:
+         v.x += s * 0.25;
+         break;
+      case 159:
+         s += v.z * 5.0;
+      case 160:
+         v.yz *= 0.5;
+         break;
+      case 161:
+         s += 1.0;
+         break;
+      case 162:
+         s += v.x;
+         break;
+      case 163:
+         s -= v.y;
+      case 164:
+         v.x += s * 0.25;
+         break;
+      case 165:
+         s += v.z * 1.0;
+         break;
+      case 166:
+         v.yz *= 0.5;
+         break;
+      case 167:
+         s += 1.0;
+      case 168:
+         s += v.x;
+         break;
+      case 169:
+         s -= v.y;
+         break;
+      case 170:
+         v.x += s * 0.25;
+         break;
+      case 171:
+         s += v.z * 2.0;
+      case 172:
+         v.yz *= 0.5;
+         break;
+      case 173:
+         s += 1.0;
+         break;
+      case 174:
+         s += v.x;
+         break;
+      case 175:
+         s -= v.y;
+      case 176:
+         v.x += s * 0.25;
+         break;
+      case 177:
+         s += v.z * 3.0;
+         break;
+      case 178:
+         v.yz *= 0.5;
+         break;
+      case 179:
+         s += 1.0;
+      case 180:
+         s += v.x;
+         break;
+      case 181:
+         s -= v.y;
+         break;
+      case 182:
+         v.x += s * 0.25;
+         break;
+      case 183:
+         s += v.z * 4.0;
+      case 184:
+         v.yz *= 0.5;
+         break;
+      case 185:
+         s += 1.0;
+         break;
+      case 186:
+         s += v.x;
+         break;
+      case 187:
+         s -= v.y;
+      case 188:
+         v.x += s * 0.25;
+         break;
+      case 189:
+         s += v.z * 5.0;
+         break;
+      case 190:
+         v.yz *= 0.5;
+         break;
+      case 191:
+         s += 1.0;
+      case 192:
+         s += v.x;
+         break;
+      case 193:
+         s -= v.y;
+         break;
+      case 194:
+         v.x += s * 0.25;
+         break;
+      case 195:
+         s += v.z * 1.0;
+      case 196:
+         v.yz *= 0.5;
+         break;
+      case 197:
+         s += 1.0;
+         break;
+      case 198:
+         s += v.x;
+         break;
+      case 199:
+         s -= v.y;
+      case 200:
+         v.x += s * 0.25;
+         break;
+      case 201:
+         s += v.z * 2.0;
+         break;
+      case 202:
+         v.yz *= 0.5;
+         break;
+      case 203:
+         s += 1.0;
+      case 204:
+         s += v.x;
+         break;
+      case 205:
+         s -= v.y;
+         break;
+      case 206:
+         v.x += s * 0.25;
+         break;
+      case 207:
+         s += v.z * 3.0;
+      case 208:
+         v.yz *= 0.5;
+         break;
+      case 209:
+         s += 1.0;
+         break;
+      case 210:
+         s += v.x;
+         break;
+      case 211:
+         s -= v.y;
+      case 212:
+         v.x += s * 0.25;
+         break;
+      case 213:
+         s += v.z * 4.0;
+         break;
+      case 214:
+         v.yz *= 0.5;
+         break;
+      case 215:
+         s += 1.0;
+      case 216:
+         s += v.x;
+         break;
+      case 217:
+         s -= v.y;
+         break;
+      case 218:
+         v.x += s * 0.25;
+         break;
+      case 219:
+         s += v.z * 5.0;
+      case 220:
+         v.yz *= 0.5;
+         break;
+      case 221:
+         s += 1.0;
+         break;
+      case 222:
+         s += v.x;
+         break;
+      case 223:
+         s -= v.y;
+      case 224:
+         v.x += s * 0.25;
+         break;
+      case 225:
+         s += v.z * 1.0;
+         break;
+      case 226:
+         v.yz *= 0.5;
+         break;
+      case 227:
+         s += 1.0;
+      case 228:
+         s += v.x;
+         break;
+      case 229:
+         s -= v.y;
+         break;
+      case 230:
+         v.x += s * 0.25;
+         break;
+      case 231:
+         s += v.z * 2.0;
+      case 232:
+         v.yz *= 0.5;
+         break;
+      case 233:
+         s += 1.0;
+         break;
+      case 234:
+         s += v.x;
+         break;
+      case 235:
+         s -= v.y;
+      case 236:
+         v.x += s * 0.25;
+         break;
+      case 237:
+         s += v.z * 3.0;
+         break;
+      case 238:
+         v.yz *= 0.5;
+         break;
+      case 239:
+         s += 1.0;
+      case 240:
+         s += v.x;
+         break;
+      case 241:
+         s -= v.y;
+         break;
+      case 242:
+         v.x += s * 0.25;
+         break;
+      case 243:
+         s += v.z * 4.0;
+      case 244:
+         v.yz *= 0.5;
+         break;
+      case 245:
+         s += 1.0;
+         break;
+      case 246:
+         s += v.x;
+         break;
+      case 247:
+         s -= v.y;
+      case 248:
+         v.x += s * 0.25;
+         break;
+      case 249:
+         s += v.z * 5.0;
+         break;
+      case 250:
+         v.yz *= 0.5;
+         break;
+      case 251:
+         s += 1.0;
+      case 252:
+         s += v.x;
+         break;
+      case 253:
+         s -= v.y;
+         break;
+      case 254:
+         v.x += s * 0.25;
+         break;
+      case 255:
+         s += v.z * 1.0;
+      default:
+         s -= 1.0;
+      }
+   }
+   acc = v;
+   return s + v.x + v.y + v.z + v.w;
+}
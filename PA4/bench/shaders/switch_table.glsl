@@ -0,0 +1,799 @@
+vec4 acc;
+
+float switch_table(int n)
+{
+   vec4 v;
+   float s;
+   float f;
+   int state;
+   int q;
+   int k;
+   int i;
+
+   v = acc;
+   s = 0.0;
+   state = 11;
+   for (i = 0; i < n; i++) {
+      state = state * 1103515245 + 12345;
+      q = state / 65536;
+      if (q < 0) {
+         q = 0 - q;
+      }
+      k = q - (q / 256) * 256;
+      switch (k) {
+      case 0:
+         f = 0.0;
+         break;
+      case 1:
+         f = 1.7;
+         break;
+      case 2:
+         f = 2.4;
+         break;
+      case 3:
+         f = 3.1;
+         break;
+      case 4:
+         f = 4.8;
+         break;
+      case 5:
+         f = 5.5;
+         break;
+      case 6:
+         f = 6.2;
+         break;
+      case 7:
+         f = 7.9;
+         break;
+      case 8:
+         f = 8.6;
+         break;
+      case 9:
+         f = 9.3;
+         break;
+      case 10:
+         f = 10.0;
+         break;
+      case 11:
+         f = 11.7;
+         break;
+      case 12:
+         f = 12.4;
+         break;
+      case 13:
+         f = 13.1;
+         break;
+      case 14:
+         f = 14.8;
+         break;
+      case 15:
+         f = 15.5;
+         break;
+      case 16:
+         f = 16.2;
+         break;
+      case 17:
+         f = 0.9;
+         break;
+      case 18:
+         f = 1.6;
+         break;
+      case 19:
+         f = 2.3;
+         break;
+      case 20:
+         f = 3.0;
+         break;
+      case 21:
+         f = 4.7;
+         break;
+      case 22:
+         f = 5.4;
+         break;
+      case 23:
+         f = 6.1;
+         break;
+      case 24:
+         f = 7.8;
+         break;
+      case 25:
+         f = 8.5;
+         break;
+      case 26:
+         f = 9.2;
+         break;
+      case 27:
+         f = 10.9;
+         break;
+      case 28:
+         f = 11.6;
+         break;
+      case 29:
+         f = 12.3;
+         break;
+      case 30:
+         f = 13.0;
+         break;
+      case 31:
+         f = 14.7;
+         break;
+      case 32:
+         f = 15.4;
+         break;
+      case 33:
+         f = 16.1;
+         break;
+      case 34:
+         f = 0.8;
+         break;
+      case 35:
+         f = 1.5;
+         break;
+      case 36:
+         f = 2.2;
+         break;
+      case 37:
+         f = 3.9;
+         break;
+      case 38:
+         f = 4.6;
+         break;
+      case 39:
+         f = 5.3;
+         break;
+      case 40:
+         f = 6.0;
+         break;
+      case 41:
+         f = 7.7;
+         break;
+      case 42:
+         f = 8.4;
+         break;
+      case 43:
+         f = 9.1;
+         break;
+      case 44:
+         f = 10.8;
+         break;
+      case 45:
+         f = 11.5;
+         break;
+      case 46:
+         f = 12.2;
+         break;
+      case 47:
+         f = 13.9;
+         break;
+      case 48:
+         f = 14.6;
+         break;
+      case 49:
+         f = 15.3;
+         break;
+      case 50:
+         f = 16.0;
+         break;
+      case 51:
+         f = 0.7;
+         break;
+      case 52:
+         f = 1.4;
+         break;
+      case 53:
+         f = 2.1;
+         break;
+      case 54:
+         f = 3.8;
+         break;
+      case 55:
+         f = 4.5;
+         break;
+      case 56:
+         f = 5.2;
+         break;
+      case 57:
+         f = 6.9;
+         break;
+      case 58:
+         f = 7.6;
+         break;
+      case 59:
+         f = 8.3;
+         break;
+      case 60:
+         f = 9.0;
+         break;
+      case 61:
+         f = 10.7;
+         break;
+      case 62:
+         f = 11.4;
+         break;
+      case 63:
+         f = 12.1;
+         break;
+      case 64:
+         f = 13.8;
+         break;
+      case 65:
+         f = 14.5;
+         break;
+      case 66:
+         f = 15.2;
+         break;
+      case 67:
+         f = 16.9;
+         break;
+      case 68:
+         f = 0.6;
+         break;
+      case 69:
+         f = 1.3;
+         break;
+      case 70:
+         f = 2.0;
+         break;
+      case 71:
+         f = 3.7;
+         break;
+      case 72:
+         f = 4.4;
+         break;
+      case 73:
+         f = 5.1;
+         break;
+      case 74:
+         f = 6.8;
+         break;
+      case 75:
+         f = 7.5;
+         break;
+      case 76:
+         f = 8.2;
+         break;
+      case 77:
+         f = 9.9;
+         break;
+      case 78:
+         f = 10.6;
+         break;
+      case 79:
+         f = 11.3;
+         break;
+      case 80:
+         f = 12.0;
+         break;
+      case 81:
+         f = 13.7;
+         break;
+      case 82:
+         f = 14.4;
+         break;
+      case 83:
+         f = 15.1;
+         break;
+      case 84:
+         f = 16.8;
+         break;
+      case 85:
+         f = 0.5;
+         break;
+      case 86:
+         f = 1.2;
+         break;
+      case 87:
+         f = 2.9;
+         break;
+      case 88:
+         f = 3.6;
+         break;
+      case 89:
+         f = 4.3;
+         break;
+      case 90:
+         f = 5.0;
+         break;
+      case 91:
+         f = 6.7;
+         break;
+      case 92:
+         f = 7.4;
+         break;
+      case 93:
+         f = 8.1;
+         break;
+      case 94:
+         f = 9.8;
+         break;
+      case 95:
+         f = 10.5;
+         break;
+      case 96:
+         f = 11.2;
+         break;
+      case 97:
+         f = 12.9;
+         break;
+      case 98:
+         f = 13.6;
+         break;
+      case 99:
+         f = 14.3;
+         break;
+      case 100:
+         f = 15.0;
+         break;
+      case 101:
+         f = 16.7;
+         break;
+      case 102:
+         f = 0.4;
+         break;
+      case 103:
+         f = 1.1;
+         break;
+      case 104:
+         f = 2.8;
+         break;
+      case 105:
+         f = 3.5;
+         break;
+      case 106:
+         f = 4.2;
+         break;
+      case 107:
+         f = 5.9;
+         break;
+      case 108:
+         f = 6.6;
+         break;
+      case 109:
+         f = 7.3;
+         break;
+      case 110:
+         f = 8.0;
+         break;
+      case 111:
+         f = 9.7;
+         break;
+      case 112:
+         f = 10.4;
+         break;
+      case 113:
+         f = 11.1;
+         break;
+      case 114:
+         f = 12.8;
+         break;
+      case 115:
+         f = 13.5;
+         break;
+      case 116:
+         f = 14.2;
+         break;
+      case 117:
+         f = 15.9;
+         break;
+      case 118:
+         f = 16.6;
+         break;
+      case 119:
+         f = 0.3;
+         break;
+      case 120:
+         f = 1.0;
+         break;
+      case 121:
+         f = 2.7;
+         break;
+      case 122:
+         f = 3.4;
+         break;
+      case 123:
+         f = 4.1;
+         break;
+      case 124:
+         f = 5.8;
+         break;
+      case 125:
+         f = 6.5;
+         break;
+      case 126:
+         f = 7.2;
+         break;
+      case 127:
+         f = 8.9;
+         break;
+      case 128:
+         f = 9.6;
+         break;
+      case 129:
+         f = 10.3;
+         break;
+      case 130:
+         f = 11.0;
+         break;
+      case 131:
+         f = 12.7;
+         break;
+      case 132:
+         f = 13.4;
+         break;
+      case 133:
+         f = 14.1;
+         break;
+      case 134:
+         f = 15.8;
+         break;
+      case 135:
+         f = 16.5;
+         break;
+      case 136:
+         f = 0.2;
+         break;
+      case 137:
+         f = 1.9;
+         break;
+      case 138:
+         f = 2.6;
+         break;
+      case 139:
+         f = 3.3;
+         break;
+      case 140:
+         f = 4.0;
+         break;
+      case 141:
+         f = 5.7;
+         break;
+      case 142:
+         f = 6.4;
+         break;
+      case 143:
+         f = 7.1;
+         break;
+      case 144:
+         f = 8.8;
+         break;
+      case 145:
+         f = 9.5;
+         break;
+      case 146:
+         f = 10.2;
+         break;
+      case 147:
+         f = 11.9;
+         break;
+      case 148:
+         f = 12.6;
+         break;
+      case 149:
+         f = 13.3;
+         break;
+      case 150:
+         f = 14.0;
+         break;
+      case 151:
+         f = 15.7;
+         break;
+      case 152:
+         f = 16.4;
+         break;
+      case 153:
+         f = 0.1;
+         break;
+      case 154:
+         f = 1.8;
+         break;
+      case 155:
+         f = 2.5;
+         break;
+      case 156:
+         f = 3.2;
+         break;
+      case 157:
+         f = 4.9;
+         break;
+      case 158:
+         f = 5.6;
+         break;
+      case 159:
+         f = 6.3;
+         break;
+      case 160:
+         f = 7.0;
+         break;
+      case 161:
+         f = 8.7;
+         break;
+      case 162:
+         f = 9.4;
+         break;
+      case 163:
+         f = 10.1;
+         break;
+      case 164:
+         f = 11.8;
+         break;
+      case 165:
+         f = 12.5;
+         break;
+      case 166:
+         f = 13.2;
+         break;
+      case 167:
+         f = 14.9;
+         break;
+      case 168:
+         f = 15.6;
+         break;
+      case 169:
+         f = 16.3;
+         break;
+      case 170:
+         f = 0.0;
+         break;
+      case 171:
+         f = 1.7;
+         break;
+      case 172:
+         f = 2.4;
+         break;
+      case 173:
+         f = 3.1;
+         break;
+      case 174:
+         f = 4.8;
+         break;
+      case 175:
+         f = 5.5;
+         break;
+      case 176:
+         f = 6.2;
+         break;
+      case 177:
+         f = 7.9;
+         break;
+      case 178:
+         f = 8.6;
+         break;
+      case 179:
+         f = 9.3;
+         break;
+      case 180:
+         f = 10.0;
+         break;
+      case 181:
+         f = 11.7;
+         break;
+      case 182:
+         f = 12.4;
+         break;
+      case 183:
+         f = 13.1;
+         break;
+      case 184:
+         f = 14.8;
+         break;
+      case 185:
+         f = 15.5;
+         break;
+      case 186:
+         f = 16.2;
+         break;
+      case 187:
+         f = 0.9;
+         break;
+      case 188:
+         f = 1.6;
+         break;
+      case 189:
+         f = 2.3;
+         break;
+      case 190:
+         f = 3.0;
+         break;
+      case 191:
+         f = 4.7;
+         break;
+      case 192:
+         f = 5.4;
+         break;
+      case 193:
+         f = 6.1;
+         break;
+      case 194:
+         f = 7.8;
+         break;
+      case 195:
+         f = 8.5;
+         break;
+      case 196:
+         f = 9.2;
+         break;
+      case 197:
+         f = 10.9;
+         break;
+      case 198:
+         f = 11.6;
+         break;
+      case 199:
+         f = 12.3;
+         break;
+      case 200:
+         f = 13.0;
+         break;
+      case 201:
+         f = 14.7;
+         break;
+      case 202:
+         f = 15.4;
+         break;
+      case 203:
+         f = 16.1;
+         break;
+      case 204:
+         f = 0.8;
+         break;
+      case 205:
+         f = 1.5;
+         break;
+      case 206:
+         f = 2.2;
+         break;
+      case 207:
+         f = 3.9;
+         break;
+      case 208:
+         f = 4.6;
+         break;
+      case 209:
+         f = 5.3;
+         break;
+      case 210:
+         f = 6.0;
+         break;
+      case 211:
+         f = 7.7;
+         break;
+      case 212:
+         f = 8.4;
+         break;
+      case 213:
+         f = 9.1;
+         break;
+      case 214:
+         f = 10.8;
+         break;
+      case 215:
+         f = 11.5;
+         break;
+      case 216:
+         f = 12.2;
+         break;
+      case 217:
+         f = 13.9;
+         break;
+      case 218:
+         f = 14.6;
+         break;
+      case 219:
+         f = 15.3;
+         break;
+      case 220:
+         f = 16.0;
+         break;
+      case 221:
+         f = 0.7;
+         break;
+      case 222:
+         f = 1.4;
+         break;
+      case 223:
+         f = 2.1;
+         break;
+      case 224:
+         f = 3.8;
+         break;
+      case 225:
+         f = 4.5;
+         break;
+      case 226:
+         f = 5.2;
+         break;
+      case 227:
+         f = 6.9;
+         break;
+      case 228:
+         f = 7.6;
+         break;
+      case 229:
+         f = 8.3;
+         break;
+      case 230:
+         f = 9.0;
+         break;
+      case 231:
+         f = 10.7;
+         break;
+      case 232:
+         f = 11.4;
+         break;
+      case 233:
+         f = 12.1;
+         break;
+      case 234:
+         f = 13.8;
+         break;
+      case 235:
+         f = 14.5;
+         break;
+      case 236:
+         f = 15.2;
+         break;
+      case 237:
+         f = 16.9;
+         break;
+      case 238:
+         f = 0.6;
+         break;
+      case 239:
+         f = 1.3;
+         break;
+      case 240:
+         f = 2.0;
+         break;
+      case 241:
+         f = 3.7;
+         break;
+      case 242:
+         f = 4.4;
+         break;
+      case 243:
+         f = 5.1;
+         break;
+      case 244:
+         f = 6.8;
+         break;
+      case 245:
+         f = 7.5;
+         break;
+      case 246:
+         f = 8.2;
+         break;
+      case 247:
+         f = 9.9;
+         break;
+      case 248:
+         f = 10.6;
+         break;
+      case 249:
+         f = 11.3;
+         break;
+      case 250:
+         f = 12.0;
+         break;
+      case 251:
+         f = 13.7;
+         break;
+      case 252:
+         f = 14.4;
+         break;
+      case 253:
+         f = 15.1;
+         break;
+      case 254:
+         f = 16.8;
+         break;
+      case 255:
+         f = 0.5;
+         break;
+      default:
+         f = 0.0;
+         break;
+      }
+      s += f * v.x;
+   }
+   return s;
+}
@@ -0,0 +1,21 @@
+vec4 acc;
+vec3 dir;
+
+float update(int n)
+{
+   vec4 v;
+   vec3 d;
+   int i;
+
+   v = acc;
+   d = dir;
+   for (i = 0; i < n; i++) {
+      v.xyz += d;
+      v.wx = v.xw * 0.5;
+      d.zy -= v.yz;
+      v.yw *= d.xx;
+      v.z++;
+   }
+   acc = v;
+   return v.x + v.y + v.z + v.w;
+}
@@ -0,0 +1,18 @@
+mat4 xf;
+vec4 origin;
+vec4 step;
+
+float transform(int n)
+{
+   vec4 p;
+   vec4 sum;
+   int i;
+
+   p = origin;
+   sum = origin * 0.0;
+   for (i = 0; i < n; i++) {
+      sum += xf * p;
+      p += step;
+   }
+   return sum.x + sum.y + sum.z + sum.w;
+}
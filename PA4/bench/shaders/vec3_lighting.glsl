@@ -0,0 +1,32 @@
+vec3 positions[16384];
+vec3 normals[16384];
+vec3 colors[16384];
+vec3 lightPos;
+vec3 lightColor;
+vec3 ambient;
+int next;
+
+float light(int n)
+{
+   vec3 l;
+   vec3 c;
+   float d;
+   float total;
+   int i;
+   int end;
+
+   total = 0.0;
+   end = next + n;
+   for (i = next; i < end; i++) {
+      l = normalize(lightPos - positions[i]);
+      d = max(dot(normals[i], l), 0.0);
+      c = ambient + lightColor * d;
+      colors[i] = c;
+      total += c.y;
+   }
+   next = end;
+   if (next >= 16384) {
+      next = 0;
+   }
+   return total;
+}
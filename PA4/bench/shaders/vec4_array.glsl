@@ -0,0 +1,21 @@
+vec4 colors[262144];
+vec4 weight;
+int next;
+
+float shade(int n)
+{
+   vec4 sum;
+   int i;
+   int end;
+
+   sum = vec4(0.0);
+   end = next + n;
+   for (i = next; i < end; i++) {
+      sum += colors[i] * weight;
+   }
+   next = end;
+   if (next >= 262144) {
+      next = 0;
+   }
+   return sum.x + sum.y + sum.z + sum.w;
+}
@@ -0,0 +1,10 @@
+vec4 grid[2][3];
+
+float gridtest(int i)
+{
+  int j;
+
+  j = i + 1;
+  grid[i][j].x = grid[i][j].y + grid[j][i].z;
+  return grid[i][j].x + grid[1][0].w;
+}
@@ -0,0 +1,4 @@
+float quarter(int i)
+{
+  return float(i) / 4.0;
+}
@@ -0,0 +1,10 @@
+vec3 v;
+
+float diagonal(float s)
+{
+  mat3 m;
+  vec3 r;
+  m = mat3(s);
+  r = m * v;
+  return r.x + 10.0 * r.y + 100.0 * r.z;
+}
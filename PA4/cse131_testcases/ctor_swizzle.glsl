@@ -0,0 +1,8 @@
+vec3 v;
+
+float build(float s)
+{
+  vec4 c;
+  c = vec4(v.xy, 0.0, 1.0) * s;
+  return c.x + 2.0 * c.y + 3.0 * c.z + 4.0 * c.w;
+}
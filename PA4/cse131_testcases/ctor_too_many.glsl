@@ -0,0 +1,4 @@
+vec2 pair(float a, float b, float c)
+{
+  return vec2(a, b, c);
+}
@@ -0,0 +1,9 @@
+mat4 m;
+vec4 v;
+
+float transform()
+{
+  vec4 a;
+  a = m * v;
+  return a.x + 10.0 * a.y + 100.0 * a.z + 1000.0 * a.w;
+}
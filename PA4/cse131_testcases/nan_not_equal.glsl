@@ -0,0 +1,22 @@
+vec2 v;
+
+int nantest(float z)
+{
+  float n;
+  vec2 w;
+  int r;
+
+  n = z / z;
+  w = v * n;
+  r = 0;
+  if (n != n) {
+    r = r + 1;
+  }
+  if (w != w) {
+    r = r + 10;
+  }
+  if (n == n) {
+    r = r + 100;
+  }
+  return r;
+}
@@ -0,0 +1,6 @@
+int shift(int x)
+{
+  uint s;
+  s = 2u;
+  return x >> s;
+}
@@ -0,0 +1,7 @@
+int half(int x)
+{
+  uint u;
+  u = uint(x);
+  u = u / 2u;
+  return int(u);
+}
@@ -0,0 +1,21 @@
+vec3 a;
+vec3 b;
+
+int compare(float x)
+{
+  vec3 c;
+  int r;
+
+  c = a * x;
+  r = 0;
+  if (c == b) {
+    r = r + 1;
+  }
+  if (c != a) {
+    r = r + 10;
+  }
+  if (c != b) {
+    r = r + 100;
+  }
+  return r;
+}
@@ -0,0 +1,9 @@
+mat4 m;
+vec4 v;
+
+float transform()
+{
+  vec4 b;
+  b = v * m;
+  return b.x + 10.0 * b.y + 100.0 * b.z + 1000.0 * b.w;
+}
@@ -0,0 +1,584 @@
+/* File: glbench.cc
+ * ----------------
+ * Micro-benchmark for the code glc generates.  The bitcode glc wrote is
+ * JIT-compiled and one of its functions is called in a tight loop, with
+ * its arguments and the globals it reads taken from a test case's .dat
+ * file:
+ *
+ *    ./glc < test.glsl > test.bc
+ *    ./glbench [options] test.bc test.dat
+ *
+ * Options:
+ *    -O<level>          optimization level to measure (0-3); may be given
+ *                       several times to compare levels (default -O0)
+ *    -mcpu=<cpu>        target CPU; may be repeated (default: the host)
+ *    -mattr=<features>  comma separated target features such as +avx2;
+ *                       may be repeated to compare feature sets
+ *    -n <calls>         calls per timed batch (default 1000000)
+ *    -warmup <calls>    untimed calls made first (default 100000)
+ *    -baseline <file>   compare against the ns/call recorded in file
+ *    -update-baseline   record this run's results in the baseline file
+ *    -threshold <pct>   slowdown over the baseline that counts as a
+ *                       regression (default 10)
+ *
+ * One row is printed per configuration with ns/call, calls/s and, on
+ * x86, timestamp counter cycles/call.  The exit status is 1 if any row
+ * regressed against the baseline.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <map>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "optimize.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/Bitcode/ReaderWriter.h"
+#include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/MCJIT.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Target/TargetMachine.h"
+using namespace std;
+
+static const int Batches = 5;   // timed batches per configuration; the fastest is kept
+
+struct BenchValue {
+    string name;                // global name, empty for parameters
+    string type;
+    vector<string> values;
+};
+
+struct BenchSpec {
+    string function;
+    vector<BenchValue> params;
+    vector<BenchValue> globals;
+};
+
+struct BenchConfig {
+    int level;
+    string cpu, attrs;
+};
+
+struct BenchResult {
+    double ns, cycles;
+};
+
+static string Trim(const string &s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return b == string::npos ? "" : s.substr(b, e - b + 1);
+}
+
+static vector<string> Split(const string &s, char sep) {
+    vector<string> parts;
+    size_t start = 0, end;
+    while ((end = s.find(sep, start)) != string::npos) {
+        parts.push_back(Trim(s.substr(start, end - start)));
+        start = end + 1;
+    }
+    parts.push_back(Trim(s.substr(start)));
+    return parts;
+}
+
+/* Function: ReadSpec()
+ * --------------------
+ * Reads a test case's .dat file:
+ *    funct: <name>
+ *    param: <type>, <value>...            one per argument, in order
+ *    gin: <global>, <type>, <value>...    one per global the function reads
+ * A global given fewer values than it holds, such as a large array,
+ * takes them over and over until it is filled.
+ */
+static bool ReadSpec(const char *fileName, BenchSpec &spec) {
+    FILE *in = fopen(fileName, "r");
+    if (in == NULL)
+        return false;
+
+    char line[1024];
+    while (fgets(line, sizeof(line), in) != NULL) {
+        string s = Trim(line);
+        size_t colon = s.find(':');
+        if (colon == string::npos)
+            continue;
+        string key = Trim(s.substr(0, colon));
+        vector<string> fields = Split(s.substr(colon + 1), ',');
+        BenchValue v;
+        if (key == "funct") {
+            spec.function = fields[0];
+        } else if (key == "param" && fields.size() >= 2) {
+            v.type = fields[0];
+            v.values.assign(fields.begin() + 1, fields.end());
+            spec.params.push_back(v);
+        } else if (key == "gin" && fields.size() >= 3) {
+            v.name = fields[0];
+            v.type = fields[1];
+            v.values.assign(fields.begin() + 2, fields.end());
+            spec.globals.push_back(v);
+        }
+    }
+    fclose(in);
+    return !spec.function.empty();
+}
+
+static llvm::Constant *MakeConstant(llvm::Type *type, const vector<string> &values, unsigned int &next) {
+    if (type->isVectorTy()) {
+        vector<llvm::Constant*> lanes;
+        for (unsigned int i = 0; i < type->getVectorNumElements(); i++) {
+            llvm::Constant *lane = MakeConstant(type->getVectorElementType(), values, next);
+            if (lane == NULL)
+                return NULL;
+            lanes.push_back(lane);
+        }
+        return llvm::ConstantVector::get(lanes);
+    }
+
+    if (next >= values.size())
+        return NULL;
+    const string &v = values[next++];
+    if (type->isIntegerTy(1))
+        return llvm::ConstantInt::get(type, v == "true" || atoi(v.c_str()) != 0);
+    if (type->isIntegerTy())
+        return llvm::ConstantInt::get(type, atol(v.c_str()), true);
+    if (type->isFloatingPointTy())
+        return llvm::ConstantFP::get(type, atof(v.c_str()));
+    return NULL;
+}
+
+/* Function: BuildLoop()
+ * ---------------------
+ * Adds "void glbench.loop(i64 n)" to the module, which calls the function
+ * under test n times with the constant arguments from the spec and stores
+ * each result to a volatile sink so the calls cannot be dropped.  It is
+ * added after the module has been optimized so the calls are never
+ * inlined into the loop or hoisted out of it.
+ */
+static llvm::Function *BuildLoop(llvm::Module *mod, llvm::Function *target, const BenchSpec &spec) {
+    llvm::LLVMContext &context = mod->getContext();
+    llvm::FunctionType *targetType = target->getFunctionType();
+    if (targetType->getNumParams() != spec.params.size()) {
+        fprintf(stderr, "glbench: %s takes %d arguments but the spec gives %d\n",
+                spec.function.c_str(), targetType->getNumParams(), (int)spec.params.size());
+        return NULL;
+    }
+
+    vector<llvm::Value*> args;
+    for (unsigned int i = 0; i < spec.params.size(); i++) {
+        unsigned int next = 0;
+        llvm::Constant *arg = MakeConstant(targetType->getParamType(i), spec.params[i].values, next);
+        if (arg == NULL) {
+            fprintf(stderr, "glbench: bad value for argument %d of %s\n", i + 1, spec.function.c_str());
+            return NULL;
+        }
+        args.push_back(arg);
+    }
+
+    llvm::Type *i64 = llvm::Type::getInt64Ty(context);
+    llvm::FunctionType *loopType = llvm::FunctionType::get(llvm::Type::getVoidTy(context), i64, false);
+    llvm::Function *loop = llvm::Function::Create(loopType, llvm::GlobalValue::ExternalLinkage,
+                                                  "glbench.loop", mod);
+    llvm::BasicBlock *entry = llvm::BasicBlock::Create(context, "entry", loop);
+    llvm::BasicBlock *body = llvm::BasicBlock::Create(context, "body", loop);
+    llvm::BasicBlock *exit = llvm::BasicBlock::Create(context, "exit", loop);
+    llvm::Value *n = &*loop->arg_begin();
+
+    llvm::GlobalVariable *sink = NULL;
+    llvm::Type *retType = targetType->getReturnType();
+    if (!retType->isVoidTy())
+        sink = new llvm::GlobalVariable(*mod, retType, false, llvm::GlobalValue::InternalLinkage,
+                                        llvm::Constant::getNullValue(retType), "glbench.sink");
+
+    llvm::IRBuilder<> builder(entry);
+    builder.CreateCondBr(builder.CreateICmpEQ(n, llvm::ConstantInt::get(i64, 0)), exit, body);
+
+    builder.SetInsertPoint(body);
+    llvm::PHINode *i = builder.CreatePHI(i64, 2);
+    i->addIncoming(llvm::ConstantInt::get(i64, 0), entry);
+    llvm::CallInst *call = builder.CreateCall(target, args);
+    call->setCallingConv(target->getCallingConv());
+    call->addAttribute(llvm::AttributeSet::FunctionIndex, llvm::Attribute::NoInline);
+    if (sink != NULL)
+        builder.CreateStore(call, sink, true);
+    llvm::Value *next = builder.CreateAdd(i, llvm::ConstantInt::get(i64, 1));
+    i->addIncoming(next, body);
+    builder.CreateCondBr(builder.CreateICmpEQ(next, n), exit, body);
+
+    builder.SetInsertPoint(exit);
+    builder.CreateRetVoid();
+    return loop;
+}
+
+/* Function: FloatToHalf()
+ * ------------------------
+ * The IEEE half nearest f, rounding ties to even, as glc's mediump and
+ * lowp globals store it.
+ */
+static uint16_t FloatToHalf(float f) {
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    uint16_t sign = (x >> 16) & 0x8000;
+    uint32_t abs = x & 0x7fffffff;
+
+    if (abs >= 0x7f800000)                      // infinity or NaN
+        return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+    if (abs >= 0x477ff000)                      // rounds past the largest half
+        return sign | 0x7c00;
+    if (abs < 0x38800000) {                     // a half denormal, or zero
+        if (abs < 0x33000000)
+            return sign;
+        uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+        int shift = 126 - (abs >> 23);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1), midway = 1u << (shift - 1);
+        if (rest > midway || (rest == midway && (half & 1)))
+            half++;
+        return sign | half;
+    }
+    // rebias the exponent and round off the 13 low mantissa bits; a carry
+    // out of the mantissa correctly bumps the exponent
+    uint32_t half = (abs - 0x38000000) >> 13;
+    uint32_t rest = abs & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        half++;
+    return sign | half;
+}
+
+static float HalfToFloat(uint16_t h) {
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1f, mantissa = h & 0x3ff;
+    uint32_t x;
+    if (exponent == 0x1f)
+        x = sign | 0x7f800000 | (mantissa << 13);
+    else if (exponent != 0)
+        x = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    else if (mantissa == 0)
+        x = sign;
+    else {
+        // a denormal half is a normal float
+        exponent = 113;
+        while (!(mantissa & 0x400)) {
+            mantissa <<= 1;
+            exponent--;
+        }
+        x = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+/* Without F16C the backend converts half and float with calls to these,
+ * which the runtime library does not always provide, so the JIT is
+ * given its own. */
+extern "C" uint16_t __gnu_f2h_ieee(float f) { return FloatToHalf(f); }
+extern "C" float __gnu_h2f_ieee(uint16_t h) { return HalfToFloat(h); }
+
+static bool SetGlobal(llvm::ExecutionEngine *engine, llvm::Module *mod, const BenchValue &gin) {
+    llvm::GlobalVariable *global = mod->getNamedGlobal(gin.name);
+    if (global == NULL) {
+        fprintf(stderr, "glbench: no global named %s\n", gin.name.c_str());
+        return false;
+    }
+    // a matrix is an array of column vectors; the values are given one
+    // column after another, and each column starts on its own alignment.
+    // Arrays, of arrays or of matrices, are laid out the same way once
+    // flattened down to their vectors or scalars.
+    llvm::Type *type = global->getValueType();
+    unsigned int columns = 1;
+    llvm::Type *elem = type;
+    while (elem->isArrayTy()) {
+        columns *= elem->getArrayNumElements();
+        elem = elem->getArrayElementType();
+    }
+    llvm::Type *lane = elem->isVectorTy() ? elem->getVectorElementType() : elem;
+    unsigned int count = elem->isVectorTy() ? elem->getVectorNumElements() : 1;
+    // a vec3 (or mat3 column) glc padded to 4 lanes takes 3 values
+    unsigned int given = count;
+    if (count == 4 && !gin.type.empty() && gin.type[gin.type.size() - 1] == '3')
+        given = 3;
+    uint64_t stride = mod->getDataLayout().getTypeAllocSize(elem);
+    if (gin.values.empty()) {
+        fprintf(stderr, "glbench: no values for global %s\n", gin.name.c_str());
+        return false;
+    }
+
+    char *base = (char*)engine->getGlobalValueAddress(gin.name);
+    for (unsigned int c = 0; c < columns; c++) {
+        char *addr = base + c * stride;
+        for (unsigned int i = 0; i < given; i++) {
+            const char *v = gin.values[(c * given + i) % gin.values.size()].c_str();
+            if (lane->isFloatTy())
+                ((float*)addr)[i] = atof(v);
+            else if (lane->isHalfTy())
+                ((uint16_t*)addr)[i] = FloatToHalf(atof(v));
+            else if (lane->isIntegerTy(1) && elem->isVectorTy()) {
+                // a bvec is stored as a bit mask, one bit per lane
+                if (!strcmp(v, "true") || atoi(v) != 0)
+                    ((uint8_t*)addr)[i / 8] |= 1 << (i % 8);
+                else
+                    ((uint8_t*)addr)[i / 8] &= ~(1 << (i % 8));
+            }
+            else if (lane->isIntegerTy(1))
+                ((uint8_t*)addr)[i] = !strcmp(v, "true") || atoi(v) != 0;
+            else if (lane->isIntegerTy(32))
+                ((int32_t*)addr)[i] = strtol(v, NULL, 10);
+            else {
+                fprintf(stderr, "glbench: cannot set global %s of this type\n", gin.name.c_str());
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static double Now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t Cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/* Function: RunConfig()
+ * ---------------------
+ * Loads a fresh copy of the module, optimizes it for one configuration,
+ * JIT-compiles it with the loop added and times the loop.
+ */
+static bool RunConfig(const char *bcFile, const BenchSpec &spec, const BenchConfig &config,
+                      long calls, long warmup, BenchResult &result) {
+    llvm::LLVMContext context;
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer> > buffer = llvm::MemoryBuffer::getFile(bcFile);
+    if (!buffer) {
+        fprintf(stderr, "glbench: cannot read %s\n", bcFile);
+        return false;
+    }
+    llvm::ErrorOr<std::unique_ptr<llvm::Module> > parsed =
+        llvm::parseBitcodeFile(buffer.get()->getMemBufferRef(), context);
+    if (!parsed) {
+        fprintf(stderr, "glbench: %s is not a bitcode file\n", bcFile);
+        return false;
+    }
+    std::unique_ptr<llvm::Module> owner = std::move(parsed.get());
+    llvm::Module *mod = owner.get();
+
+    llvm::Function *target = mod->getFunction(spec.function);
+    if (target == NULL || target->isDeclaration()) {
+        fprintf(stderr, "glbench: %s does not define %s\n", bcFile, spec.function.c_str());
+        return false;
+    }
+
+    string error;
+    vector<string> attrs;
+    if (!config.attrs.empty())
+        attrs = Split(config.attrs, ',');
+    mod->setTargetTriple(llvm::sys::getProcessTriple());
+    llvm::EngineBuilder builder(std::move(owner));
+    builder.setEngineKind(llvm::EngineKind::JIT)
+           .setErrorStr(&error)
+           .setOptLevel(config.level == 0 ? llvm::CodeGenOpt::None :
+                        config.level == 1 ? llvm::CodeGenOpt::Less :
+                        config.level == 2 ? llvm::CodeGenOpt::Default : llvm::CodeGenOpt::Aggressive)
+           .setMCPU(config.cpu)
+           .setMAttrs(attrs);
+    llvm::TargetMachine *tm = builder.selectTarget();
+    if (tm == NULL) {
+        fprintf(stderr, "glbench: %s\n", error.c_str());
+        return false;
+    }
+    mod->setDataLayout(tm->createDataLayout());
+
+    OptimizeModule(mod, config.level, tm);
+    target = mod->getFunction(spec.function);
+    llvm::Function *loop = BuildLoop(mod, target, spec);
+    if (loop == NULL)
+        return false;
+
+    llvm::ExecutionEngine *engine = builder.create(tm);
+    if (engine == NULL) {
+        fprintf(stderr, "glbench: %s\n", error.c_str());
+        return false;
+    }
+    engine->finalizeObject();
+
+    for (unsigned int i = 0; i < spec.globals.size(); i++) {
+        if (!SetGlobal(engine, mod, spec.globals[i])) {
+            delete engine;
+            return false;
+        }
+    }
+
+    void (*run)(int64_t) = (void (*)(int64_t))engine->getFunctionAddress("glbench.loop");
+    run(warmup);
+
+    result.ns = result.cycles = -1;
+    for (int b = 0; b < Batches; b++) {
+        double start = Now();
+        uint64_t startCycles = Cycles();
+        run(calls);
+        uint64_t cycles = Cycles() - startCycles;
+        double ns = Now() - start;
+        if (result.ns < 0 || ns / calls < result.ns) {
+            result.ns = ns / calls;
+            result.cycles = (double)cycles / calls;
+        }
+    }
+    delete engine;
+    return true;
+}
+
+static string ConfigKey(const char *bcFile, const BenchSpec &spec, const BenchConfig &config) {
+    const char *base = strrchr(bcFile, '/');
+    char level[16];
+    snprintf(level, sizeof(level), "O%d", config.level);
+    return string(base ? base + 1 : bcFile) + ":" + spec.function + ":" + level + ":" +
+           config.cpu + ":" + (config.attrs.empty() ? "-" : config.attrs);
+}
+
+/* Baseline files hold one "<key> <ns/call>" line per configuration. */
+static map<string, double> ReadBaseline(const char *fileName) {
+    map<string, double> baseline;
+    FILE *in = fopen(fileName, "r");
+    if (in == NULL)
+        return baseline;
+
+    char key[1024];
+    double ns;
+    while (fscanf(in, "%1023s %lf", key, &ns) == 2)
+        baseline[key] = ns;
+    fclose(in);
+    return baseline;
+}
+
+static bool WriteBaseline(const char *fileName, const map<string, double> &baseline) {
+    FILE *out = fopen(fileName, "w");
+    if (out == NULL)
+        return false;
+    for (map<string, double>::const_iterator it = baseline.begin(); it != baseline.end(); ++it)
+        fprintf(out, "%s %.3f\n", it->first.c_str(), it->second);
+    return fclose(out) == 0;
+}
+
+static void Usage() {
+    fprintf(stderr, "Usage: glbench [-O<level> ...] [-mcpu=<cpu> ...] [-mattr=<features> ...]\n"
+                    "               [-n <calls>] [-warmup <calls>] [-baseline <file>]\n"
+                    "               [-update-baseline] [-threshold <pct>] <file.bc> <spec.dat>\n");
+    exit(2);
+}
+
+int main(int argc, char *argv[]) {
+    vector<int> levels;
+    vector<string> cpus, attrSets;
+    long calls = 1000000, warmup = 100000;
+    const char *baselineFile = NULL;
+    bool updateBaseline = false;
+    double threshold = 10;
+    vector<const char*> files;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strncmp(arg, "-O", 2) && arg[2] >= '0' && arg[2] <= '3' && arg[3] == '\0')
+            levels.push_back(arg[2] - '0');
+        else if (!strncmp(arg, "-mcpu=", 6))
+            cpus.push_back(arg + 6);
+        else if (!strncmp(arg, "-mattr=", 7))
+            attrSets.push_back(arg + 7);
+        else if (!strcmp(arg, "-n") && hasValue)
+            calls = atol(argv[++i]);
+        else if (!strcmp(arg, "-warmup") && hasValue)
+            warmup = atol(argv[++i]);
+        else if (!strcmp(arg, "-baseline") && hasValue)
+            baselineFile = argv[++i];
+        else if (!strcmp(arg, "-update-baseline"))
+            updateBaseline = true;
+        else if (!strcmp(arg, "-threshold") && hasValue)
+            threshold = atof(argv[++i]);
+        else if (arg[0] != '-')
+            files.push_back(arg);
+        else
+            Usage();
+    }
+    if (files.size() != 2 || calls <= 0 || (updateBaseline && baselineFile == NULL))
+        Usage();
+
+    BenchSpec spec;
+    if (!ReadSpec(files[1], spec)) {
+        fprintf(stderr, "glbench: cannot read a function spec from %s\n", files[1]);
+        return 2;
+    }
+
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::sys::DynamicLibrary::AddSymbol("__gnu_f2h_ieee", (void*)__gnu_f2h_ieee);
+    llvm::sys::DynamicLibrary::AddSymbol("__gnu_h2f_ieee", (void*)__gnu_h2f_ieee);
+    if (levels.empty())
+        levels.push_back(0);
+    if (cpus.empty())
+        cpus.push_back(llvm::sys::getHostCPUName());
+    if (attrSets.empty())
+        attrSets.push_back("");
+
+    map<string, double> baseline;
+    if (baselineFile != NULL)
+        baseline = ReadBaseline(baselineFile);
+
+    int regressions = 0;
+    printf("%-32s %-4s %-14s %-16s %10s %14s %12s %10s\n", "function", "opt", "cpu", "attrs",
+           "ns/call", "calls/s", "cycles/call", "baseline");
+    for (unsigned int l = 0; l < levels.size(); l++) {
+        for (unsigned int c = 0; c < cpus.size(); c++) {
+            for (unsigned int a = 0; a < attrSets.size(); a++) {
+                BenchConfig config;
+                config.level = levels[l];
+                config.cpu = cpus[c];
+                config.attrs = attrSets[a];
+
+                BenchResult result;
+                if (!RunConfig(files[0], spec, config, calls, warmup, result))
+                    return 2;
+
+                string key = ConfigKey(files[0], spec, config);
+                char versus[32] = "-";
+                if (baseline.count(key)) {
+                    double change = (result.ns - baseline[key]) / baseline[key] * 100;
+                    snprintf(versus, sizeof(versus), "%+.1f%%%s", change, change > threshold ? "!" : "");
+                    if (change > threshold)
+                        regressions++;
+                }
+                printf("%-32s O%-3d %-14s %-16s %10.3f %14.0f %12.1f %10s\n", spec.function.c_str(),
+                       config.level, config.cpu.c_str(), config.attrs.empty() ? "-" : config.attrs.c_str(),
+                       result.ns, 1e9 / result.ns, result.cycles, versus);
+                if (updateBaseline)
+                    baseline[key] = result.ns;
+            }
+        }
+    }
+
+    if (updateBaseline && !WriteBaseline(baselineFile, baseline)) {
+        fprintf(stderr, "glbench: cannot write baseline to %s\n", baselineFile);
+        return 2;
+    }
+    if (regressions > 0) {
+        fprintf(stderr, "glbench: %d configuration(s) more than %.0f%% slower than the baseline\n",
+                regressions, threshold);
+        return 1;
+    }
+    return 0;
+}
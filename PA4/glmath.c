@@ -0,0 +1,518 @@
+/* File: glmath.c
+ * --------------
+ * The math library bundled with glc: the transcendental built-ins (sin,
+ * cos, tan, exp, exp2, log, log2, pow, atan) on four floats at a time.
+ * It is compiled to bitcode and embedded in glc (see mathlib.h), which
+ * links in the functions a shader calls and inlines them, so a vec4
+ * sin is a few dozen vector instructions instead of four calls to libm.
+ *
+ * Every function comes in two variants.  glmath_<f> is the precise one:
+ * within 1 ulp of the correctly rounded result for every finite input,
+ * with infinities, NaNs and denormals handled.  sin, cos, tan, log2,
+ * pow and atan get there by working in double and rounding once at the
+ * end; exp, exp2 and log are within 1 ulp in float.  glmath_<f>_fast
+ * stays in float, drops the special cases and shortens the range
+ * reduction, so sin and cos are only good to an absolute 1e-7 near their
+ * zeros (and lose it past |x| = 1e5), tan, log2 and atan are within 3
+ * ulp, and pow loses about |y log2 x| ulp.
+ *
+ * The float polynomials are the single precision minimax ones from
+ * Cephes; the double ones are Taylor series taken far enough that their
+ * error is well below half a float ulp.
+ * Only GCC vector extensions are used, so the file builds with clang
+ * (for the bitcode) and with gcc (for the accuracy tables).
+ */
+
+typedef float vfloat __attribute__((vector_size(16)));
+typedef int vint __attribute__((vector_size(16)));
+
+static inline vfloat vf(float c) {
+    vfloat v = { c, c, c, c };
+    return v;
+}
+
+static inline vint vi(int c) {
+    vint v = { c, c, c, c };
+    return v;
+}
+
+static inline vfloat AsFloat(vint x) {
+    return (vfloat)x;
+}
+
+static inline vint AsInt(vfloat x) {
+    return (vint)x;
+}
+
+static const int SignBit = (int)0x80000000u;
+
+/* Lanes of a where mask is set (all ones), of b elsewhere. */
+static inline vfloat Select(vint mask, vfloat a, vfloat b) {
+    return AsFloat((AsInt(a) & mask) | (AsInt(b) & ~mask));
+}
+
+static inline vfloat Abs(vfloat x) {
+    return AsFloat(AsInt(x) & vi(~SignBit));
+}
+
+/* x with its sign flipped where mask is set. */
+static inline vfloat FlipSign(vfloat x, vint mask) {
+    return AsFloat(AsInt(x) ^ (mask & vi(SignBit)));
+}
+
+/* Rounds to the nearest integer, halfway cases away from zero. */
+static inline vint RoundToInt(vfloat x) {
+    vfloat half = AsFloat((AsInt(x) & vi(SignBit)) | AsInt(vf(0.5f)));
+    return __builtin_convertvector(x + half, vint);
+}
+
+/* 2^n for n in [-126, 127], built directly from the exponent bits. */
+static inline vfloat Pow2(vint n) {
+    return AsFloat((n + vi(127)) << 23);
+}
+
+static inline vint IsFinite(vfloat x) {
+    return Abs(x) < vf(__builtin_inff());
+}
+
+static const float PIO2 = 1.57079632679489661923f;
+static const float PIO4 = 0.78539816339744830962f;
+static const float LOG2E = 1.44269504088896340736f;
+static const float LOG2EA = 0.44269504088896340736f;   /* log2(e) - 1 */
+static const float SQRTHF = 0.707106781186547524f;
+
+/* Function: Reduce()
+ * ------------------
+ * Writes x as r + j * pi/2 with r in [-pi/4, pi/4] and returns r; j mod
+ * 4 goes to quadrant.  This is the fast variant's: j * pi/2 is taken off
+ * in two parts, the first with an exact product by j (Cody and Waite),
+ * so r is off by about j * 1e-11.
+ */
+static inline vfloat Reduce(vfloat x, vint *quadrant) {
+    vint j = RoundToInt(x * vf(0.636619772367581343f));
+    vfloat fj = __builtin_convertvector(j, vfloat);
+    vfloat r = x - fj * vf(1.5703125f);
+    r = r - fj * vf(4.83826794897e-4f);
+    *quadrant = j & vi(3);
+    return r;
+}
+
+typedef double vdouble __attribute__((vector_size(32)));
+typedef long long vlong __attribute__((vector_size(32)));
+
+static inline vdouble vd(double c) {
+    vdouble v = { c, c, c, c };
+    return v;
+}
+
+static inline vdouble SelectDouble(vlong mask, vdouble a, vdouble b) {
+    return (vdouble)(((vlong)a & mask) | ((vlong)b & ~mask));
+}
+
+/* 2/pi in binary, 32 bits a word, from the point on. */
+static const unsigned InvPio2Bits[8] = {
+    0xa2f9836e, 0x4e441529, 0xfc2757d1, 0xf534ddc0,
+    0xdb629599, 0x3c439041, 0xfe5163ab, 0xdebbc561,
+};
+
+/* Function: ReduceLarge()
+ * -----------------------
+ * Reduce() for one float too large for j * pi/2 to be taken off exactly
+ * (Payne and Hanek).  With |x| = m 2^e and m a 24-bit integer, x 2/pi mod 4 is
+ * a 64-bit fixed point number with 62 bits of fraction: the words of
+ * 2/pi that would only add multiples of 4 are skipped, and the four
+ * after them are multiplied by m and added at their place.  Good to
+ * about 2^-60, far below the closest any float comes to a multiple of
+ * pi/2.
+ */
+static double ReduceLarge(float x, int *quadrant) {
+    unsigned bits;
+    __builtin_memcpy(&bits, &x, sizeof(bits));
+    int e = (int)((bits >> 23) & 0xff) - 150;
+    unsigned long long m = (bits & 0x007fffff) | 0x00800000;
+
+    // word k is worth m * word * 2^(e + 30 - 32k) units of 2^-62
+    int first = e < 34 ? 0 : (e - 34) / 32 + 1;
+    unsigned long long sum = 0;
+    for (int k = first; k < first + 4; k++) {
+        int shift = e + 30 - 32 * k;
+        unsigned long long term = m * InvPio2Bits[k];
+        if (shift >= 0)
+            sum += term << shift;
+        else if (shift > -64)
+            sum += term >> -shift;
+    }
+
+    // round to the nearest quadrant; what is left is r / (pi/2), and
+    // the constant is pi/2 * 2^-62
+    unsigned long long j = (sum + (1ull << 61)) >> 62;
+    double r = (long long)(sum - (j << 62)) * 3.4061215800865545e-19;
+    *quadrant = x < 0 ? -(int)j : (int)j;
+    return x < 0 ? -r : r;
+}
+
+/* Function: ReduceDouble()
+ * ------------------------
+ * Reduce() for the precise variants, with r in double.  Up to 2^18 the
+ * two parts of pi/2 are double, the first short enough that its product
+ * by j is exact, so r is good to 2^-67; past that each lane is reduced
+ * by ReduceLarge(), which shaders rarely need.
+ */
+static inline vdouble ReduceDouble(vfloat x, vint *quadrant) {
+    vint large = Abs(x) >= vf(262144.0f);
+    vfloat small = Select(large, vf(0.0f), x);
+
+    vint j = RoundToInt(small * vf(0.636619772367581343f));
+    vdouble fj = __builtin_convertvector(j, vdouble);
+    vdouble r = __builtin_convertvector(small, vdouble) - fj * 1.5707963267341256;
+    r = r - fj * 6.077100506506192e-11;
+
+    if (large[0] | large[1] | large[2] | large[3]) {
+        for (int i = 0; i < 4; i++) {
+            int lane;
+            if (large[i]) {
+                r[i] = ReduceLarge(x[i], &lane);
+                j[i] = lane;
+            }
+        }
+    }
+    *quadrant = j & vi(3);
+    return r;
+}
+
+/* sin and cos of r in [-pi/4, pi/4]. */
+static inline vfloat SinPoly(vfloat r) {
+    vfloat z = r * r;
+    return ((vf(-1.9515295891e-4f) * z + vf(8.3321608736e-3f)) * z + vf(-1.6666654611e-1f)) * z * r + r;
+}
+
+static inline vfloat CosPoly(vfloat r) {
+    vfloat z = r * r;
+    return ((vf(2.443315711809948e-5f) * z + vf(-1.388731625493765e-3f)) * z + vf(4.166664568298827e-2f)) * z * z
+           - vf(0.5f) * z + vf(1.0f);
+}
+
+/* The same in double: the first term left out is below 1e-11 of the sum. */
+static inline vdouble SinPolyDouble(vdouble r) {
+    vdouble z = r * r;
+    vdouble p = z * (-1.0 / 39916800) + 1.0 / 362880;
+    p = p * z - 1.0 / 5040;
+    p = p * z + 1.0 / 120;
+    p = p * z - 1.0 / 6;
+    return p * z * r + r;
+}
+
+static inline vdouble CosPolyDouble(vdouble r) {
+    vdouble z = r * r;
+    vdouble p = z * (1.0 / 479001600) - 1.0 / 3628800;
+    p = p * z + 1.0 / 40320;
+    p = p * z - 1.0 / 720;
+    p = p * z + 1.0 / 24;
+    p = p * z - 0.5;
+    return p * z + 1;
+}
+
+/* Function: SinCos()
+ * ------------------
+ * sin(x) with offset 0, cos(x) with offset 1: cos is sin a quadrant on.
+ */
+static inline vfloat SinCos(vfloat x, int offset, int precise) {
+    vint quadrant;
+    vfloat s, c;
+    if (precise) {
+        vdouble r = ReduceDouble(x, &quadrant);
+        s = __builtin_convertvector(SinPolyDouble(r), vfloat);
+        c = __builtin_convertvector(CosPolyDouble(r), vfloat);
+    } else {
+        vfloat r = Reduce(x, &quadrant);
+        s = SinPoly(r);
+        c = CosPoly(r);
+    }
+    quadrant = quadrant + vi(offset);
+
+    vint odd = (quadrant & vi(1)) != vi(0);
+    vint negative = (quadrant & vi(2)) != vi(0);
+    vfloat y = FlipSign(Select(odd, c, s), negative);
+    return precise ? Select(IsFinite(x), y, vf(__builtin_nanf(""))) : y;
+}
+
+static inline vfloat Tan(vfloat x, int precise) {
+    vint quadrant;
+    vfloat tangent, cotangent;
+    if (precise) {
+        vdouble r = ReduceDouble(x, &quadrant);
+        vdouble s = SinPolyDouble(r), c = CosPolyDouble(r);
+        tangent = __builtin_convertvector(s / c, vfloat);
+        cotangent = __builtin_convertvector(c / s, vfloat);
+    } else {
+        vfloat r = Reduce(x, &quadrant);
+        vfloat s = SinPoly(r), c = CosPoly(r);
+        tangent = s / c;
+        cotangent = c / s;
+    }
+
+    // tan has period pi, so only whether the quadrant is odd matters
+    vfloat y = Select((quadrant & vi(1)) != vi(0), -cotangent, tangent);
+    return precise ? Select(IsFinite(x), y, vf(__builtin_nanf(""))) : y;
+}
+
+/* Function: ExpPoly()
+ * -------------------
+ * e^r for r in [-ln(2)/2, ln(2)/2].
+ */
+static inline vfloat ExpPoly(vfloat r) {
+    vfloat z = r * r;
+    vfloat p = vf(1.9875691500e-4f);
+    p = p * r + vf(1.3981999507e-3f);
+    p = p * r + vf(8.3334519073e-3f);
+    p = p * r + vf(4.1665795894e-2f);
+    p = p * r + vf(1.6666665459e-1f);
+    p = p * r + vf(5.0000001201e-1f);
+    return p * z + r + vf(1.0f);
+}
+
+/* Function: Scale()
+ * -----------------
+ * y * 2^n.  The precise variant scales in two steps, so results that
+ * are denormal or close to overflow are still right.
+ */
+static inline vfloat Scale(vfloat y, vint n, int precise) {
+    if (!precise)
+        return y * Pow2(n);
+    vint half = n >> 1;
+    return y * Pow2(half) * Pow2(n - half);
+}
+
+static inline vfloat Exp(vfloat x, int precise) {
+    vfloat clamped = Select(x > vf(88.8f), vf(88.8f), Select(x < vf(-104.0f), vf(-104.0f), x));
+
+    vint j = RoundToInt(clamped * vf(LOG2E));
+    vfloat fj = __builtin_convertvector(j, vfloat);
+    vfloat r = clamped - fj * vf(0.693359375f) - fj * vf(-2.12194440e-4f);
+    vfloat y = Scale(ExpPoly(r), j, precise);
+    if (!precise)
+        return y;
+    y = Select(x > vf(88.72283905206835f), vf(__builtin_inff()), y);
+    return Select(x == x, y, x);
+}
+
+static inline vfloat Exp2(vfloat x, int precise) {
+    vfloat clamped = Select(x > vf(128.0f), vf(128.0f), Select(x < vf(-150.0f), vf(-150.0f), x));
+
+    // the integer part scales exactly, so exp2 of an integer is exact
+    vint j = RoundToInt(clamped);
+    vfloat r = (clamped - __builtin_convertvector(j, vfloat)) * vf(0.693147180559945309f);
+    vfloat y = Scale(ExpPoly(r), j, precise);
+    if (!precise)
+        return y;
+    y = Select(x >= vf(128.0f), vf(__builtin_inff()), y);
+    return Select(x == x, y, x);
+}
+
+/* Function: LogParts()
+ * --------------------
+ * Splits x into 2^e * (1 + m) with 1 + m in [sqrt(1/2), sqrt(2)) and
+ * returns m; *e gets the exponent and *tail the polynomial part of
+ * log(1 + m) past m.
+ */
+static inline vfloat LogParts(vfloat x, vfloat *e, vfloat *tail, int precise) {
+    vint bias = vi(0);
+    if (precise) {
+        // bring denormals into the normal range first
+        vint denormal = x < vf(1.17549435e-38f);
+        x = Select(denormal, x * vf(8388608.0f), x);
+        bias = denormal & vi(23);
+    }
+
+    vint bits = AsInt(x);
+    vint exponent = ((bits >> 23) & vi(0xff)) - vi(126) - bias;
+    vfloat m = AsFloat((bits & vi(0x007fffff)) | vi(0x3f000000));
+
+    vint small = m < vf(SQRTHF);
+    exponent = exponent + small;
+    m = Select(small, m + m, m) - vf(1.0f);
+
+    vfloat z = m * m;
+    vfloat p = vf(7.0376836292e-2f);
+    p = p * m + vf(-1.1514610310e-1f);
+    p = p * m + vf(1.1676998740e-1f);
+    p = p * m + vf(-1.2420140846e-1f);
+    p = p * m + vf(1.4249322787e-1f);
+    p = p * m + vf(-1.6668057665e-1f);
+    p = p * m + vf(2.0000714765e-1f);
+    p = p * m + vf(-2.4999993993e-1f);
+    p = p * m + vf(3.3333331174e-1f);
+
+    *e = __builtin_convertvector(exponent, vfloat);
+    *tail = p * m * z - vf(0.5f) * z;
+    return m;
+}
+
+/* log of 0 is -inf, of a negative number or NaN NaN, and of inf inf. */
+static inline vfloat LogSpecial(vfloat x, vfloat y) {
+    y = Select(x == vf(__builtin_inff()), x, y);
+    y = Select(x == vf(0.0f), vf(-__builtin_inff()), y);
+    return Select((x < vf(0.0f)) | (x != x), vf(__builtin_nanf("")), y);
+}
+
+static inline vfloat Log(vfloat x, int precise) {
+    vfloat e, tail;
+    vfloat m = LogParts(x, &e, &tail, precise);
+
+    // ln(2) in two parts, the first exact when multiplied by e
+    vfloat y = m + (tail + e * vf(-2.12194440e-4f)) + e * vf(0.693359375f);
+    return precise ? LogSpecial(x, y) : y;
+}
+
+/* Function: Log2Double()
+ * ----------------------
+ * log2(x) in double for finite positive x: m and e are exact, and
+ * log(1 + m) = 2 atanh(s) with s = m / (m + 2), |s| < 0.172.
+ */
+static inline vdouble Log2Double(vfloat x) {
+    vfloat e, tail;
+    vfloat m = LogParts(x, &e, &tail, 1);
+
+    vdouble dm = __builtin_convertvector(m, vdouble);
+    vdouble s = dm / (dm + 2.0);
+    vdouble z = s * s;
+    vdouble l = ((((((z / 13 + 1.0 / 11) * z + 1.0 / 9) * z + 1.0 / 7) * z + 1.0 / 5) * z + 1.0 / 3) * z + 1) * 2 * s;
+    return __builtin_convertvector(e, vdouble) + l * 1.44269504088896340736;
+}
+
+static inline vfloat Log2(vfloat x, int precise) {
+    if (precise)
+        return LogSpecial(x, __builtin_convertvector(Log2Double(x), vfloat));
+
+    // log2(e) = 1 + LOG2EA, so the large terms are added unscaled
+    vfloat e, tail;
+    vfloat m = LogParts(x, &e, &tail, 0);
+    return tail * vf(LOG2EA) + m * vf(LOG2EA) + tail + m + e;
+}
+
+/* Function: PowDouble()
+ * ---------------------
+ * 2^(y log2 x) in float loses about |y log2 x| ulp: the product is
+ * rounded before 2^ magnifies its error.  The precise pow computes the
+ * log and the 2^ of the fraction in double, and only the result, the
+ * exponent and the scaling stay in float.
+ */
+static inline vfloat PowDouble(vfloat x, vfloat y) {
+    vdouble w = __builtin_convertvector(y, vdouble) * Log2Double(x);
+    vfloat clamped = __builtin_convertvector(w, vfloat);
+    clamped = Select(clamped > vf(128.0f), vf(128.0f), Select(clamped < vf(-150.0f), vf(-150.0f), clamped));
+
+    // 2^w = 2^n e^t, t = (w - n) ln(2) in [-0.35, 0.35]
+    vint n = RoundToInt(clamped);
+    vdouble t = (w - __builtin_convertvector(n, vdouble)) * 0.693147180559945309;
+    vdouble p = t * (1.0 / 40320) + 1.0 / 5040;
+    p = p * t + 1.0 / 720;
+    p = p * t + 1.0 / 120;
+    p = p * t + 1.0 / 24;
+    p = p * t + 1.0 / 6;
+    p = p * t + 0.5;
+    p = (p * t + 1) * t + 1;
+    return Scale(__builtin_convertvector(p, vfloat), n, 1);
+}
+
+static inline vfloat Pow(vfloat x, vfloat y, int precise) {
+    if (!precise)
+        return Exp2(y * Log2(x, 0), 0);
+
+    // 0^y and inf^y are 0 or inf by the sign of y, x^0 is 1 for every x,
+    // and x^y with x < 0 is NaN
+    vfloat p = PowDouble(x, y);
+    vint positive = y > vf(0.0f);
+    p = Select(x == vf(0.0f), Select(positive, vf(0.0f), vf(__builtin_inff())), p);
+    p = Select(x == vf(__builtin_inff()), Select(positive, x, vf(0.0f)), p);
+    p = Select((x < vf(0.0f)) | (x != x) | (y != y), vf(__builtin_nanf("")), p);
+    return Select(y == vf(0.0f), vf(1.0f), p);
+}
+
+/* Function: AtanFloat()
+ * ---------------------
+ * Reduces |x| to [-tan(pi/8), tan(pi/8)] with atan(x) = pi/2 - atan(1/x)
+ * and atan(x) = pi/4 + atan((x - 1)/(x + 1)), then uses a polynomial.
+ */
+static inline vfloat AtanFloat(vfloat x) {
+    vfloat a = Abs(x);
+    vint big = a > vf(2.414213562373095f);
+    vint middle = (a > vf(0.4142135623730950f)) & ~big;
+
+    vfloat base = Select(big, vf(PIO2), Select(middle, vf(PIO4), vf(0.0f)));
+    vfloat r = Select(big, vf(-1.0f) / a, Select(middle, (a - vf(1.0f)) / (a + vf(1.0f)), a));
+    vfloat z = r * r;
+    vfloat p = ((vf(8.05374449538e-2f) * z + vf(-1.38776856032e-1f)) * z + vf(1.99777106478e-1f)) * z
+               + vf(-3.33329491539e-1f);
+    vfloat y = base + (p * z * r + r);
+    return FlipSign(y, x < vf(0.0f));
+}
+
+/* Function: AtanDouble()
+ * ----------------------
+ * AtanFloat() in double, with the series of atan for the polynomial:
+ * through z^11 it is good to 3e-11 on the reduced range.
+ */
+static inline vdouble AtanDouble(vdouble x) {
+    vlong negative = x < 0;
+    vdouble a = SelectDouble(negative, -x, x);
+    vlong big = a > 2.414213562373095;
+    vlong middle = (a > 0.4142135623730950) & ~big;
+
+    vdouble base = SelectDouble(big, vd(1.5707963267948966), SelectDouble(middle, vd(0.7853981633974483), vd(0)));
+    vdouble r = SelectDouble(big, vd(-1), SelectDouble(middle, a - 1, a))
+                / SelectDouble(big, a, SelectDouble(middle, a + 1, vd(1)));
+    vdouble z = r * r;
+    vdouble p = z * (-1.0 / 23) + 1.0 / 21;
+    p = p * z - 1.0 / 19;
+    p = p * z + 1.0 / 17;
+    p = p * z - 1.0 / 15;
+    p = p * z + 1.0 / 13;
+    p = p * z - 1.0 / 11;
+    p = p * z + 1.0 / 9;
+    p = p * z - 1.0 / 7;
+    p = p * z + 1.0 / 5;
+    p = p * z - 1.0 / 3;
+    vdouble y = base + (p * z * r + r);
+    return SelectDouble(negative, -y, y);
+}
+
+static inline vfloat Atan(vfloat x, int precise) {
+    if (!precise)
+        return AtanFloat(x);
+    return __builtin_convertvector(AtanDouble(__builtin_convertvector(x, vdouble)), vfloat);
+}
+
+/* atan(y / x) in the quadrant of (x, y). */
+static inline vfloat Atan2(vfloat y, vfloat x, int precise) {
+    if (precise) {
+        vdouble dy = __builtin_convertvector(y, vdouble), dx = __builtin_convertvector(x, vdouble);
+        vdouble a = AtanDouble(dy / dx);
+        vdouble pi = SelectDouble(dy < 0, vd(-3.141592653589793), vd(3.141592653589793));
+        return __builtin_convertvector(SelectDouble(dx < 0, a + pi, a), vfloat);
+    }
+    vfloat a = AtanFloat(y / x);
+    vfloat pi = FlipSign(vf(3.14159265358979323846f), y < vf(0.0f));
+    return Select(x < vf(0.0f), a + pi, a);
+}
+
+vfloat glmath_sin(vfloat x) { return SinCos(x, 0, 1); }
+vfloat glmath_sin_fast(vfloat x) { return SinCos(x, 0, 0); }
+vfloat glmath_cos(vfloat x) { return SinCos(x, 1, 1); }
+vfloat glmath_cos_fast(vfloat x) { return SinCos(x, 1, 0); }
+vfloat glmath_tan(vfloat x) { return Tan(x, 1); }
+vfloat glmath_tan_fast(vfloat x) { return Tan(x, 0); }
+vfloat glmath_exp(vfloat x) { return Exp(x, 1); }
+vfloat glmath_exp_fast(vfloat x) { return Exp(x, 0); }
+vfloat glmath_exp2(vfloat x) { return Exp2(x, 1); }
+vfloat glmath_exp2_fast(vfloat x) { return Exp2(x, 0); }
+vfloat glmath_log(vfloat x) { return Log(x, 1); }
+vfloat glmath_log_fast(vfloat x) { return Log(x, 0); }
+vfloat glmath_log2(vfloat x) { return Log2(x, 1); }
+vfloat glmath_log2_fast(vfloat x) { return Log2(x, 0); }
+vfloat glmath_pow(vfloat x, vfloat y) { return Pow(x, y, 1); }
+vfloat glmath_pow_fast(vfloat x, vfloat y) { return Pow(x, y, 0); }
+vfloat glmath_atan(vfloat x) { return Atan(x, 1); }
+vfloat glmath_atan_fast(vfloat x) { return Atan(x, 0); }
+vfloat glmath_atan2(vfloat y, vfloat x) { return Atan2(y, x, 1); }
+vfloat glmath_atan2_fast(vfloat y, vfloat x) { return Atan2(y, x, 0); }
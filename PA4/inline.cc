@@ -0,0 +1,218 @@
+/* File: inline.cc
+ * ---------------
+ * Implementation of the call specializer and inliner.
+ */
+
+#include "inline.h"
+#include "utility.h"
+#include <map>
+#include <vector>
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/ValueMapper.h"
+
+/* A specialized clone is only made of a function this many times the
+ * inline threshold in size, and at most this many clones per function,
+ * so specialization cannot blow up the module.
+ */
+static const int SpecializeFactor = 4;
+static const int MaxClones = 8;
+
+/* Function: CalleeSize()
+ * ----------------------
+ * The cost model: the number of instructions in f, leaving out the
+ * allocas and stores that spill parameters, which mem2reg removes.
+ */
+static int CalleeSize(llvm::Function *f) {
+    int size = 0;
+    for (llvm::Function::iterator bb = f->begin(); bb != f->end(); ++bb) {
+        for (llvm::BasicBlock::iterator i = bb->begin(); i != bb->end(); ++i) {
+            llvm::StoreInst *store = llvm::dyn_cast<llvm::StoreInst>(&*i);
+            if (llvm::isa<llvm::AllocaInst>(&*i) || (store && llvm::isa<llvm::Argument>(store->getValueOperand())))
+                continue;
+            size++;
+        }
+    }
+    return size;
+}
+
+static bool IsCandidate(llvm::CallInst *call) {
+    llvm::Function *callee = call->getCalledFunction();
+    return callee != NULL && !callee->isDeclaration() && !callee->isVarArg() &&
+           !llvm::isa<llvm::IntrinsicInst>(call) && callee != call->getParent()->getParent();
+}
+
+static void CollectCalls(llvm::Function *f, std::vector<llvm::CallInst*> *calls) {
+    for (llvm::Function::iterator bb = f->begin(); bb != f->end(); ++bb) {
+        for (llvm::BasicBlock::iterator i = bb->begin(); i != bb->end(); ++i) {
+            llvm::CallInst *call = llvm::dyn_cast<llvm::CallInst>(&*i);
+            if (call != NULL && IsCandidate(call))
+                calls->push_back(call);
+        }
+    }
+}
+
+long CountCalls(llvm::Module *mod) {
+    long count = 0;
+    for (llvm::Module::iterator f = mod->begin(); f != mod->end(); ++f) {
+        for (llvm::Function::iterator bb = f->begin(); bb != f->end(); ++bb) {
+            for (llvm::BasicBlock::iterator i = bb->begin(); i != bb->end(); ++i) {
+                if (llvm::isa<llvm::CallInst>(&*i) && !llvm::isa<llvm::IntrinsicInst>(&*i))
+                    count++;
+            }
+        }
+    }
+    return count;
+}
+
+/* The constant arguments a call passes, NULL for the others.  Calls that
+ * pass the same constants to the same function share one clone.
+ */
+typedef std::pair<llvm::Function*, std::vector<llvm::Constant*> > CloneKey;
+
+/* Function: Specialize()
+ * ----------------------
+ * Makes a copy of callee without the parameters that key fixes to a
+ * constant, using the constants in their place, and folds it: the
+ * parameters are promoted out of their allocas and the constants
+ * propagated, which often leaves only a few instructions.
+ */
+static llvm::Function* Specialize(llvm::Function *callee, const std::vector<llvm::Constant*> &consts) {
+    std::vector<llvm::Type*> params;
+    for (llvm::Function::arg_iterator a = callee->arg_begin(); a != callee->arg_end(); ++a) {
+        if (consts[a->getArgNo()] == NULL)
+            params.push_back(a->getType());
+    }
+    llvm::FunctionType *type = llvm::FunctionType::get(callee->getReturnType(), params, false);
+    llvm::Function *clone = llvm::Function::Create(type, llvm::GlobalValue::InternalLinkage,
+                                                   callee->getName() + ".spec", callee->getParent());
+
+    llvm::ValueToValueMapTy vmap;
+    llvm::Function::arg_iterator next = clone->arg_begin();
+    for (llvm::Function::arg_iterator a = callee->arg_begin(); a != callee->arg_end(); ++a) {
+        if (consts[a->getArgNo()] != NULL) {
+            vmap[&*a] = consts[a->getArgNo()];
+        } else {
+            next->setName(a->getName());
+            vmap[&*a] = &*next++;
+        }
+    }
+    llvm::SmallVector<llvm::ReturnInst*, 4> returns;
+    llvm::CloneFunctionInto(clone, callee, vmap, false, returns);
+
+    llvm::legacy::FunctionPassManager fpm(callee->getParent());
+    fpm.add(llvm::createPromoteMemoryToRegisterPass());
+    fpm.add(llvm::createInstructionCombiningPass());
+    fpm.add(llvm::createCFGSimplificationPass());
+    fpm.doInitialization();
+    fpm.run(*clone);
+    fpm.doFinalization();
+    return clone;
+}
+
+/* Function: SpecializeCall()
+ * --------------------------
+ * Points call at a clone of its callee specialized to the constants it
+ * passes, making the clone if there is none yet.  Returns false, leaving
+ * the call alone, if it passes no constants or the callee is too big.
+ */
+static bool SpecializeCall(llvm::CallInst *call, int threshold, std::map<CloneKey, llvm::Function*> *clones,
+                           std::map<llvm::Function*, int> *numClones) {
+    llvm::Function *callee = call->getCalledFunction();
+    std::vector<llvm::Constant*> consts;
+    std::vector<llvm::Value*> args;
+    bool any = false;
+
+    for (unsigned int i = 0; i < call->getNumArgOperands(); i++) {
+        llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(call->getArgOperand(i));
+        if (c != NULL && llvm::isa<llvm::GlobalValue>(c))
+            c = NULL;
+        consts.push_back(c);
+        if (c == NULL)
+            args.push_back(call->getArgOperand(i));
+        any = any || c != NULL;
+    }
+    if (!any)
+        return false;
+
+    // look up without inserting, so a callee refused below leaves no
+    // empty entry behind for the cleanup in InlineCalls
+    CloneKey key(callee, consts);
+    std::map<CloneKey, llvm::Function*>::iterator found = clones->find(key);
+    llvm::Function *clone;
+    if (found != clones->end()) {
+        clone = found->second;
+    } else {
+        if (CalleeSize(callee) > threshold * SpecializeFactor || (*numClones)[callee] == MaxClones)
+            return false;
+        clone = Specialize(callee, consts);
+        clones->insert(std::make_pair(key, clone));
+        (*numClones)[callee]++;
+    }
+
+    PrintDebug("inline", "specialized call to %s in %s\n", callee->getName().str().c_str(),
+               call->getParent()->getParent()->getName().str().c_str());
+    llvm::CallInst *replacement = llvm::CallInst::Create(clone, args, "", call);
+    replacement->setCallingConv(clone->getCallingConv());
+    replacement->takeName(call);
+    call->replaceAllUsesWith(replacement);
+    call->eraseFromParent();
+    return true;
+}
+
+long InlineCalls(llvm::Module *mod, int threshold) {
+    if (threshold <= 0)
+        return CountCalls(mod);
+
+    std::map<CloneKey, llvm::Function*> clones;
+    std::map<llvm::Function*, int> numClones;
+    std::vector<llvm::Function*> functions;
+    for (llvm::Module::iterator f = mod->begin(); f != mod->end(); ++f)
+        functions.push_back(&*f);
+
+    // functions are emitted before their callers, so going in module order
+    // inlines into a callee before the callee is inlined anywhere else
+    for (unsigned int i = 0; i < functions.size(); i++) {
+        std::vector<llvm::CallInst*> calls;
+        CollectCalls(functions[i], &calls);
+
+        for (unsigned int j = 0; j < calls.size(); j++) {
+            llvm::CallInst *call = calls[j];
+            if (SpecializeCall(call, threshold, &clones, &numClones))
+                continue;
+
+            llvm::Function *callee = call->getCalledFunction();
+            if (CalleeSize(callee) > threshold)
+                continue;
+            PrintDebug("inline", "inlined call to %s in %s\n", callee->getName().str().c_str(),
+                       functions[i]->getName().str().c_str());
+            llvm::InlineFunctionInfo info;
+            llvm::InlineFunction(call, info);
+        }
+    }
+
+    // a second pass picks up the calls to the new clones
+    for (unsigned int i = 0; i < functions.size(); i++) {
+        std::vector<llvm::CallInst*> calls;
+        CollectCalls(functions[i], &calls);
+        for (unsigned int j = 0; j < calls.size(); j++) {
+            llvm::Function *callee = calls[j]->getCalledFunction();
+            if (callee->hasInternalLinkage() && CalleeSize(callee) <= threshold) {
+                llvm::InlineFunctionInfo info;
+                llvm::InlineFunction(calls[j], info);
+            }
+        }
+    }
+
+    // clones whose every call was inlined are dead
+    for (std::map<CloneKey, llvm::Function*>::iterator c = clones.begin(); c != clones.end(); ++c) {
+        if (c->second->use_empty())
+            c->second->eraseFromParent();
+    }
+    return CountCalls(mod);
+}
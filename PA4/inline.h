@@ -0,0 +1,42 @@
+/**
+ * File: inline.h
+ * --------------
+ * The call inliner run on the emitted module, ahead of the -O<level>
+ * pipeline.
+ *
+ * glc runs it at -O1 and up, or on its own with -finline.  -finline=<n>
+ * sets the size threshold, in instructions, below which a function is
+ * inlined (-finline=0 turns inlining and specialization off).  Timed as
+ * the "inline" phase; -d inline prints each call it rewrites.
+ */
+
+#ifndef _H_inline
+#define _H_inline
+
+namespace llvm {
+  class Module;
+}
+
+/* The threshold when -finline gives none: about the size of a helper
+ * doing a few vector operations.
+ */
+static const int DefaultInlineThreshold = 40;
+
+/**
+ * Function: InlineCalls()
+ * -----------------------
+ * First gives calls that pass constant arguments a clone of the callee
+ * specialized to those constants, then inlines every call whose callee
+ * is at most threshold instructions long.  Returns the number of calls
+ * left in the module.
+ */
+long InlineCalls(llvm::Module *mod, int threshold);
+
+/**
+ * Function: CountCalls()
+ * ----------------------
+ * Returns the number of calls to functions (not intrinsics) in mod.
+ */
+long CountCalls(llvm::Module *mod);
+
+#endif
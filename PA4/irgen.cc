@@ -4,23 +4,75 @@
  */
 
 #include "irgen.h"
+#include "utility.h"
+#include <string.h>
+#include "llvm/Analysis/ValueTracking.h"
+
+/* Function: InList()
+ * -------------------
+ * Whether name is one of the entries of a comma separated list.
+ */
+static bool InList(const char *list, const char *name) {
+   size_t len = strlen(name);
+   for ( const char *p = list; p != NULL; p = strchr(p, ',') ) {
+     if ( *p == ',' )
+       p++;
+     if ( strncmp(p, name, len) == 0 && (p[len] == ',' || p[len] == '\0') )
+       return true;
+   }
+   return false;
+}
+
+/* Function: GetFastMathFlags()
+ * ----------------------------
+ * The flags -ffast-math gives every floating point operation: all of
+ * them without a value, else those in its comma separated list of nnan,
+ * ninf, nsz, arcp and reassoc.  LLVM has no flag for reassociation on
+ * its own, so reassoc turns on unsafe algebra, which implies the rest.
+ */
+static llvm::FastMathFlags GetFastMathFlags() {
+   llvm::FastMathFlags flags;
+   if ( !IsOptionOn("fast-math") )
+     return flags;
+
+   const char *list = GetOptionValue("fast-math");
+   if ( *list == '\0' || InList(list, "reassoc") ) {
+     flags.setUnsafeAlgebra();
+     return flags;
+   }
+   if ( InList(list, "nnan") )
+     flags.setNoNaNs();
+   if ( InList(list, "ninf") )
+     flags.setNoInfs();
+   if ( InList(list, "nsz") )
+     flags.setNoSignedZeros();
+   if ( InList(list, "arcp") )
+     flags.setAllowReciprocal();
+   return flags;
+}
 
 IRGenerator::IRGenerator() :
     context(NULL),
     module(NULL),
-    currentFunc(NULL),
-    currentBB(NULL)
+    builder(NULL),
+    currentFunc(NULL)
 {
 }
 
 IRGenerator::~IRGenerator() {
+    delete builder;
 }
 
 llvm::Module *IRGenerator::GetOrCreateModule(const char *moduleID)
 {
    if ( module == NULL ) {
      context = new llvm::LLVMContext();
+     // -flean-ir: names such as "Array Access" only help a human reading
+     // the IR, and cost a string and a symbol table entry per value
+     context->setDiscardValueNames(IsOptionOn("lean-ir"));
      module  = new llvm::Module(moduleID, *context);
+     builder = new llvm::IRBuilder<>(*context);
+     builder->SetFastMathFlags(GetFastMathFlags());
      module->setTargetTriple(TargetTriple);
      module->setDataLayout(TargetLayout);
    }
@@ -36,11 +88,206 @@ llvm::Function *IRGenerator::GetFunction() const {
 }
 
 void IRGenerator::SetBasicBlock(llvm::BasicBlock *bb) {
-   currentBB = bb;
+   if ( bb == NULL )
+     builder->ClearInsertionPoint();
+   else
+     builder->SetInsertPoint(bb);
 }
 
 llvm::BasicBlock *IRGenerator::GetBasicBlock() const {
-   return currentBB;
+   return builder->GetInsertBlock();
+}
+
+bool IRGenerator::IsEntryPoint(const char *name) const {
+   if ( strcmp(name, "main") == 0 )
+     return true;
+   if ( !IsOptionOn("entry") )
+     return false;
+
+   // -fentry takes a comma separated list of names
+   return InList(GetOptionValue("entry"), name);
+}
+
+IRGenerator::Contraction IRGenerator::GetContraction() {
+   const char *mode = "off";
+   if ( IsOptionOn("fp-contract") )
+     mode = GetOptionValue("fp-contract");
+   else if ( IsOptionOn("fast-math") && *GetOptionValue("fast-math") == '\0' )
+     mode = "fast";
+
+   if ( strcmp(mode, "fast") == 0 )
+     return ContractFast;
+   return strcmp(mode, "on") == 0 ? ContractOn : ContractOff;
+}
+
+/* Function: MemoryEffect()
+ * ------------------------
+ * What a function body does to memory outside its own allocas: returns
+ * ReadNone, ReadOnly, or None if it writes to it or calls a function
+ * that might.
+ */
+static llvm::Attribute::AttrKind MemoryEffect(llvm::Function *f) {
+   const llvm::DataLayout &layout = f->getParent()->getDataLayout();
+   bool reads = false;
+
+   for ( llvm::Function::iterator bb = f->begin(); bb != f->end(); ++bb ) {
+     for ( llvm::BasicBlock::iterator i = bb->begin(); i != bb->end(); ++i ) {
+       if ( llvm::LoadInst *load = llvm::dyn_cast<llvm::LoadInst>(&*i) ) {
+         if ( !llvm::isa<llvm::AllocaInst>(llvm::GetUnderlyingObject(load->getPointerOperand(), layout)) )
+           reads = true;
+       } else if ( llvm::StoreInst *store = llvm::dyn_cast<llvm::StoreInst>(&*i) ) {
+         if ( !llvm::isa<llvm::AllocaInst>(llvm::GetUnderlyingObject(store->getPointerOperand(), layout)) )
+           return llvm::Attribute::None;
+       } else if ( llvm::CallInst *call = llvm::dyn_cast<llvm::CallInst>(&*i) ) {
+         llvm::Function *callee = call->getCalledFunction();
+         if ( callee == NULL || !callee->onlyReadsMemory() )
+           return llvm::Attribute::None;
+         if ( !callee->doesNotAccessMemory() )
+           reads = true;
+       }
+     }
+   }
+   return reads ? llvm::Attribute::ReadOnly : llvm::Attribute::ReadNone;
+}
+
+void IRGenerator::FinishFunctions() {
+   bool hasEntry = false;
+   for ( llvm::Module::iterator f = module->begin(); f != module->end(); ++f )
+     hasEntry = hasEntry || (!f->isDeclaration() && IsEntryPoint(f->getName().str().c_str()));
+
+   // the backend takes its fast-math options from function attributes
+   llvm::FastMathFlags flags = builder->getFastMathFlags();
+   for ( llvm::Module::iterator f = module->begin(); f != module->end(); ++f ) {
+     if ( f->isDeclaration() )
+       continue;
+     f->addFnAttr(llvm::Attribute::NoUnwind);
+     if ( flags.noNaNs() )
+       f->addFnAttr("no-nans-fp-math", "true");
+     if ( flags.noInfs() )
+       f->addFnAttr("no-infs-fp-math", "true");
+     if ( flags.unsafeAlgebra() )
+       f->addFnAttr("unsafe-fp-math", "true");
+
+     // without an entry point every function might be called from
+     // outside, so they all keep the C calling convention
+     if ( !hasEntry || IsEntryPoint(f->getName().str().c_str()) )
+       continue;
+     f->setLinkage(llvm::GlobalValue::InternalLinkage);
+     f->setCallingConv(llvm::CallingConv::Fast);
+     for ( llvm::Value::user_iterator u = f->user_begin(); u != f->user_end(); ++u ) {
+       if ( llvm::CallInst *call = llvm::dyn_cast<llvm::CallInst>(*u) )
+         call->setCallingConv(llvm::CallingConv::Fast);
+     }
+   }
+
+   // functions are emitted before their callers, so one pass in module
+   // order usually settles this; repeat until nothing changes anyway
+   bool changed = true;
+   while ( changed ) {
+     changed = false;
+     for ( llvm::Module::iterator f = module->begin(); f != module->end(); ++f ) {
+       if ( f->isDeclaration() || f->doesNotAccessMemory() )
+         continue;
+       llvm::Attribute::AttrKind effect = MemoryEffect(&*f);
+       if ( effect == llvm::Attribute::ReadNone ) {
+         f->removeFnAttr(llvm::Attribute::ReadOnly);
+         f->addFnAttr(llvm::Attribute::ReadNone);
+         changed = true;
+       } else if ( effect == llvm::Attribute::ReadOnly && !f->onlyReadsMemory() ) {
+         f->addFnAttr(llvm::Attribute::ReadOnly);
+         changed = true;
+       }
+     }
+   }
+}
+
+llvm::Type *IRGenerator::HalfType(llvm::Type *ty) const {
+   if ( ty->isFloatTy() )
+     return llvm::Type::getHalfTy(*context);
+   if ( ty->isVectorTy() )
+     return llvm::VectorType::get(HalfType(ty->getVectorElementType()), ty->getVectorNumElements());
+   if ( ty->isArrayTy() )
+     return llvm::ArrayType::get(HalfType(ty->getArrayElementType()), ty->getArrayNumElements());
+   return ty;
+}
+
+llvm::Type *IRGenerator::PaddedType(llvm::Type *ty) const {
+   if ( !IsOptionOn("pad-vec3") )
+     return ty;
+   // a bvec is a bit mask, which padding would not make any faster
+   if ( ty->isVectorTy() && ty->getVectorNumElements() == 3 && !ty->getVectorElementType()->isIntegerTy(1) )
+     return llvm::VectorType::get(ty->getVectorElementType(), 4);
+   if ( ty->isArrayTy() )
+     return llvm::ArrayType::get(PaddedType(ty->getArrayElementType()), ty->getArrayNumElements());
+   return ty;
+}
+
+llvm::Value *IRGenerator::Convert(llvm::Value *val, llvm::Type *to) {
+   llvm::Type *from = val->getType();
+   if ( from == to )
+     return val;
+   if ( llvm::isa<llvm::ConstantAggregateZero>(val) )
+     return llvm::Constant::getNullValue(to);
+
+   // an array, a matrix's columns among them, is converted an element
+   // at a time; a constant one stays a constant
+   if ( from->isArrayTy() ) {
+     llvm::Type *elemTy = to->getArrayElementType();
+     unsigned count = from->getArrayNumElements();
+     if ( llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(val) ) {
+       std::vector<llvm::Constant*> elems;
+       for ( unsigned i = 0; i < count; i++ )
+         elems.push_back(llvm::cast<llvm::Constant>(Convert(c->getAggregateElement(i), elemTy)));
+       return llvm::ConstantArray::get(llvm::cast<llvm::ArrayType>(to), elems);
+     }
+     llvm::Value *result = llvm::UndefValue::get(to);
+     for ( unsigned i = 0; i < count; i++ ) {
+       llvm::Value *elem = Convert(builder->CreateExtractValue(val, i), elemTy);
+       result = builder->CreateInsertValue(result, elem, i);
+     }
+     return result;
+   }
+
+   // a padded vector drops its last lane, and one being padded gets an
+   // undefined one
+   if ( from->isVectorTy() && from->getVectorNumElements() != to->getVectorNumElements() ) {
+     std::vector<llvm::Constant*> mask;
+     for ( unsigned i = 0; i < to->getVectorNumElements(); i++ ) {
+       if ( i < from->getVectorNumElements() )
+         mask.push_back(builder->getInt32(i));
+       else
+         mask.push_back(llvm::UndefValue::get(builder->getInt32Ty()));
+     }
+     val = builder->CreateShuffleVector(val, llvm::UndefValue::get(from), llvm::ConstantVector::get(mask), "Resize");
+     return Convert(val, to);
+   }
+
+   if ( to->getScalarType()->isHalfTy() )
+     return builder->CreateFPTrunc(val, to, "Narrow");
+   return builder->CreateFPExt(val, to, "Widen");
+}
+
+/* Function: WideType()
+ * ---------------------
+ * The inverse of HalfType(): ty with half replaced by float.
+ */
+static llvm::Type *WideType(llvm::Type *ty) {
+   if ( ty->isHalfTy() )
+     return llvm::Type::getFloatTy(ty->getContext());
+   if ( ty->isVectorTy() )
+     return llvm::VectorType::get(WideType(ty->getVectorElementType()), ty->getVectorNumElements());
+   if ( ty->isArrayTy() )
+     return llvm::ArrayType::get(WideType(ty->getArrayElementType()), ty->getArrayNumElements());
+   return ty;
+}
+
+llvm::Value *IRGenerator::EmitLoad(llvm::Value *addr, llvm::Type *ty, const char *name) {
+   llvm::Value *val = builder->CreateLoad(addr, name);
+   return Convert(val, ty != NULL ? ty : WideType(val->getType()));
+}
+
+void IRGenerator::EmitStore(llvm::Value *val, llvm::Value *addr) {
+   builder->CreateStore(Convert(val, addr->getType()->getPointerElementType()), addr);
 }
 
 llvm::Type *IRGenerator::GetIntType() const {
@@ -74,6 +321,27 @@ llvm::Type* IRGenerator::ast_llvm(Type* astTy, llvm::LLVMContext *context) {
 		ty = llvm::VectorType::get(llvm::Type::getFloatTy(*context), 3);
 	} else if ( astTy == Type::vec4Type) {
 		ty = llvm::VectorType::get(llvm::Type::getFloatTy(*context), 4);
+	} else if ( astTy == Type::uintType ) {
+		// signedness lives in the AST type: the instructions pick it
+		ty = llvm::Type::getInt32Ty(*context);
+	} else if ( astTy == Type::ivec2Type || astTy == Type::uvec2Type ) {
+		ty = llvm::VectorType::get(llvm::Type::getInt32Ty(*context), 2);
+	} else if ( astTy == Type::ivec3Type || astTy == Type::uvec3Type ) {
+		ty = llvm::VectorType::get(llvm::Type::getInt32Ty(*context), 3);
+	} else if ( astTy == Type::ivec4Type || astTy == Type::uvec4Type ) {
+		ty = llvm::VectorType::get(llvm::Type::getInt32Ty(*context), 4);
+	} else if ( astTy == Type::bvec2Type ) {
+		// a bool vector is a compare mask, one i1 per lane
+		ty = llvm::VectorType::get(llvm::Type::getInt1Ty(*context), 2);
+	} else if ( astTy == Type::bvec3Type ) {
+		ty = llvm::VectorType::get(llvm::Type::getInt1Ty(*context), 3);
+	} else if ( astTy == Type::bvec4Type ) {
+		ty = llvm::VectorType::get(llvm::Type::getInt1Ty(*context), 4);
+	} else if ( astTy->IsMatrix() ) {
+		// column major: matN is N columns, each one a vecN, so a column
+		// is a single SIMD register and mat*vec is N vector multiply-adds
+		int n = astTy == Type::mat2Type ? 2 : astTy == Type::mat3Type ? 3 : 4;
+		ty = llvm::ArrayType::get(llvm::VectorType::get(llvm::Type::getFloatTy(*context), n), n);
 	} else if( dynamic_cast<ArrayType*>(astTy) != NULL) {
 		ArrayType* astArray = dynamic_cast<ArrayType*>(astTy);
 		llvm::Type* elemTy = ast_llvm( astArray->GetElemType(), context);
@@ -16,6 +16,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/IRBuilder.h"
 #include "ast_type.h"
 #include <stack>
 
@@ -24,6 +25,8 @@ class IRGenerator {
     IRGenerator();
     ~IRGenerator();
 
+    // Under -flean-ir the module's context discards the names of local
+    // values and blocks, so the IR only names globals and functions.
     llvm::Module   *GetOrCreateModule(const char *moduleID);
     llvm::LLVMContext *GetContext() const { return context; }
 
@@ -31,9 +34,51 @@ class IRGenerator {
     llvm::Function *GetFunction() const;
     void      SetFunction(llvm::Function *func);
 
+    // All instructions are created through the builder, which inserts
+    // them at the end of the current basic block.  The builder folds
+    // instructions whose operands are all constants into a constant
+    // instead of emitting them, and gives floating point operations its
+    // fast-math flags: none, for strict IEEE semantics, unless
+    // -ffast-math asks for some (see GetFastMathFlags in irgen.cc).
+    llvm::IRBuilder<> *GetBuilder() const { return builder; }
+
+    // Floating point contraction, from -ffp-contract=off|on|fast: off
+    // by default, fast under a bare -ffast-math.  On turns a*b+c within
+    // one expression into llvm.fmuladd, which the backend makes a fused
+    // multiply-add where the target has one; fast also fuses across
+    // statements once the module is optimized (see optimize.h).
+    enum Contraction { ContractOff, ContractOn, ContractFast };
+    static Contraction GetContraction();
+
     llvm::BasicBlock *GetBasicBlock() const;
     void        SetBasicBlock(llvm::BasicBlock *bb);
 
+    // Entry points are the functions called from outside the module:
+    // main, and those named by -fentry=<name>[,<name>...].  Once every
+    // function is emitted, FinishFunctions() marks all functions
+    // nounwind and readnone or readonly where their bodies allow, and
+    // with the fast-math attributes the backend reads, and, if the
+    // module has an entry point, makes every other function internal
+    // and fastcc.
+    bool IsEntryPoint(const char *name) const;
+    void FinishFunctions();
+
+    // A variable's storage may differ from the values computed on (see
+    // VarDecl::Emit): floats may be stored as half, and under -fpad-vec3
+    // a 3 lane vector is stored in 4 lanes so it is loaded and stored
+    // with one aligned move.  HalfType() and PaddedType() are ty with
+    // float replaced by half, or its 3 lane vectors widened, through
+    // vectors and arrays; Convert() takes a value between the storage
+    // and the computed type.  EmitLoad() loads the value at addr as type
+    // ty, or in the stored shape with float lanes if ty is NULL, and
+    // EmitStore() converts to the storage, so every access to a variable
+    // goes through them.
+    llvm::Type  *HalfType(llvm::Type *ty) const;
+    llvm::Type  *PaddedType(llvm::Type *ty) const;
+    llvm::Value *Convert(llvm::Value *val, llvm::Type *to);
+    llvm::Value *EmitLoad(llvm::Value *addr, llvm::Type *ty, const char *name);
+    void         EmitStore(llvm::Value *val, llvm::Value *addr);
+
     llvm::Type *GetIntType() const;
     llvm::Type *GetBoolType() const;
     llvm::Type *GetFloatType() const;
@@ -46,10 +91,11 @@ class IRGenerator {
   private:
     llvm::LLVMContext *context;
     llvm::Module      *module;
+    llvm::IRBuilder<> *builder;
 
-    // track which function or basic block is active
+    // track which function is active; the builder's insertion point is
+    // the active basic block
     llvm::Function    *currentFunc;
-    llvm::BasicBlock  *currentBB;
 
     static const char *TargetTriple;
     static const char *TargetLayout;
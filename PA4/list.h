@@ -29,6 +29,7 @@
 #define _H_list
 
 #include <deque>
+#include <vector>
 #include "utility.h"  // for Assert()
 using namespace std;
 
@@ -80,6 +81,11 @@ template<class Element> class List {
     void PrintAll(int indentLevel, const char *label = NULL)
         { for (int i = 0; i < NumElements(); i++)
              Nth(i)->Print(indentLevel, label); }
+
+       // Appends every element to nodes, for use by GetChildren()
+    void AppendAllTo(vector<Node*> *nodes)
+        { for (int i = 0; i < NumElements(); i++)
+             nodes->push_back(Nth(i)); }
              
 
 };
@@ -9,6 +9,11 @@
 #include "utility.h"
 #include "errors.h"
 #include "parser.h"
+#include "timer.h"
+#include "memstats.h"
+#include "ast.h"
+#include "irgen.h"
+#include "scanner.h"
 
 
 /* Function: main()
@@ -17,14 +22,54 @@
  * on any debugging flags requested by the user when invoking the program.
  * InitScanner() is used to set up the scanner.
  * InitParser() is used to set up the parser. The call to yyparse() will
- * attempt to parse a complete program from the input. 
+ * attempt to parse a complete program from the input. If that succeeds
+ * without errors, the parsed program is emitted as LLVM bitcode.
+ *
+ * -fstop-after=<phase> ends the pipeline early, which is used to time the
+ * front end on its own: "scan" only runs the scanner over the input,
+ * "parse" stops after building the AST, and "emit" builds the IR (which
+ * is also where types are checked) without writing out any bitcode.
+ *
+ * -flean-ir emits leaner IR: the values of expression statements are not
+ * computed, and local values and blocks are left unnamed.
  */
 int main(int argc, char *argv[])
 {
     ParseCommandLine(argc, argv);
+    InitMemStats();
+    PhaseTimer::Init();
     InitScanner();
     InitParser();
-    yyparse();
+
+    const char *stopAfter = IsOptionOn("stop-after") ? GetOptionValue("stop-after") : "";
+    if (*stopAfter && strcmp(stopAfter, "scan") && strcmp(stopAfter, "parse") &&
+        strcmp(stopAfter, "emit")) {
+        fprintf(stderr, "glc: unknown phase '%s' for -fstop-after (scan, parse or emit)\n", stopAfter);
+        return 2;
+    }
+
+    if (strcmp(stopAfter, "scan") == 0) {
+        PhaseTimer timer("scan only");
+        while (yylex() != 0)
+            ;
+    } else {
+        PhaseTimer timer("parse");
+        yyparse();
+    }
+    PhaseTimer::SetCounter("lines", GetNumLines());
+    PhaseTimer::SetCounter("tokens", GetNumTokens());
+
+    llvm::Module *mod = NULL;
+    if (ReportError::NumErrors() == 0 && program != NULL && strcmp(stopAfter, "parse")) {
+        program->Emit();
+        mod = Node::irgen->GetOrCreateModule("Program_Module.bc");
+    }
+
+    PhaseTimer::Report(stderr);
+    ReportMemStats(stderr, mod);
+    if (IsOptionOn("time-trace") && !PhaseTimer::WriteTrace(GetOptionValue("time-trace"))) {
+        fprintf(stderr, "glc: cannot write time trace to '%s'\n", GetOptionValue("time-trace"));
+    }
     return (ReportError::NumErrors() == 0? 0 : -1);
 }
 
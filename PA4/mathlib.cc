@@ -0,0 +1,79 @@
+/* File: mathlib.cc
+ * ----------------
+ * Implementation of the math library linker.
+ */
+
+#include "mathlib.h"
+#include "utility.h"
+#include <string.h>
+#include <vector>
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/Bitcode/ReaderWriter.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+
+// glmath.bc, as an array written by xxd -i (see the Makefile)
+extern unsigned char glmath_bc[];
+extern unsigned int glmath_bc_len;
+
+std::string MathFunctionName(const char *name) {
+    // a bare -ffast-math gives up NaNs and infinities, and so the
+    // special cases the precise variants handle, unless -fmath says
+    bool fast = IsOptionOn("fast-math") && *GetOptionValue("fast-math") == '\0';
+    if (IsOptionOn("math"))
+        fast = strcmp(GetOptionValue("math"), "fast") == 0;
+    return std::string(MathPrefix) + name + (fast ? "_fast" : "");
+}
+
+static bool IsMathFunction(llvm::Function *f) {
+    return f->getName().startswith(MathPrefix);
+}
+
+void LinkMathLibrary(llvm::Module *mod) {
+    bool used = false;
+    for (llvm::Module::iterator f = mod->begin(); f != mod->end(); ++f)
+        used = used || (f->isDeclaration() && IsMathFunction(&*f));
+    if (!used)
+        return;
+
+    llvm::StringRef data(reinterpret_cast<const char *>(glmath_bc), glmath_bc_len);
+    std::unique_ptr<llvm::MemoryBuffer> buffer = llvm::MemoryBuffer::getMemBuffer(data, "glmath.bc", false);
+    llvm::ErrorOr<std::unique_ptr<llvm::Module>> library =
+        llvm::parseBitcodeFile(buffer->getMemBufferRef(), mod->getContext());
+    if (!library)
+        Failure("cannot read the math library: %s", library.getError().message().c_str());
+
+    // the library is built for the host; take on the module's target so
+    // the linker does not warn about the mismatch
+    (*library)->setDataLayout(mod->getDataLayout());
+    (*library)->setTargetTriple(mod->getTargetTriple());
+    if (llvm::Linker::linkModules(*mod, std::move(*library), llvm::Linker::Flags::LinkOnlyNeeded))
+        Failure("cannot link the math library");
+
+    std::vector<llvm::Function*> linked;
+    for (llvm::Module::iterator f = mod->begin(); f != mod->end(); ++f) {
+        if (!f->isDeclaration() && IsMathFunction(&*f))
+            linked.push_back(&*f);
+    }
+
+    for (size_t i = 0; i < linked.size(); i++) {
+        llvm::Function *f = linked[i];
+        std::vector<llvm::CallInst*> calls;
+        for (llvm::Value::user_iterator u = f->user_begin(); u != f->user_end(); ++u) {
+            if (llvm::CallInst *call = llvm::dyn_cast<llvm::CallInst>(*u))
+                calls.push_back(call);
+        }
+        PrintDebug("math", "linked %s for %d calls\n", f->getName().str().c_str(), (int)calls.size());
+
+        for (size_t j = 0; j < calls.size(); j++) {
+            llvm::InlineFunctionInfo info;
+            llvm::InlineFunction(calls[j], info);
+        }
+        if (f->use_empty())
+            f->eraseFromParent();
+        else
+            f->setLinkage(llvm::GlobalValue::InternalLinkage);
+    }
+}
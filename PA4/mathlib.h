@@ -0,0 +1,45 @@
+/**
+ * File: mathlib.h
+ * ---------------
+ * The bundled math library: vec4 versions of the transcendental
+ * built-ins (sin, cos, tan, exp, exp2, log, log2, pow and atan), written
+ * in C in glmath.c and embedded in glc as bitcode.
+ *
+ * The built-ins are emitted as calls to glmath_<name>, or under
+ * -fmath=fast to glmath_<name>_fast, which skips the special cases and
+ * trades a few ulp for speed (see glmath.c for the error bounds); a bare
+ * -ffast-math picks the fast variants too unless -fmath=precise is
+ * given.  Once the module is emitted the functions it calls are linked
+ * in from the library and inlined.  -d math prints each function linked.
+ */
+
+#ifndef _H_mathlib
+#define _H_mathlib
+
+#include <string>
+
+namespace llvm {
+  class Module;
+}
+
+/* The library's functions are the ones whose names start with this. */
+static const char *const MathPrefix = "glmath_";
+
+/**
+ * Function: MathFunctionName()
+ * ----------------------------
+ * The library function that computes the built-in name, in the variant
+ * -fmath selects.
+ */
+std::string MathFunctionName(const char *name);
+
+/**
+ * Function: LinkMathLibrary()
+ * ---------------------------
+ * Links in the library functions mod declares, inlines every call to
+ * them and removes them again, so the module is left with no calls into
+ * the library.  Does nothing if mod calls none.
+ */
+void LinkMathLibrary(llvm::Module *mod);
+
+#endif
@@ -0,0 +1,126 @@
+/* File: memstats.cc
+ * -----------------
+ * Implementation of the -fmem-report statistics.
+ */
+
+#include "memstats.h"
+#include "utility.h"
+#include "ast.h"
+#include "symtable.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instruction.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <new>
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+extern vector<const char*> savedLines; // in scanner.l
+
+static long allocCount, allocBytes;
+static bool countNodes = false;
+static vector<Node*> *nodes;
+
+void *operator new(size_t size) {
+    allocCount++;
+    allocBytes += size;
+    void *p = malloc(size ? size : 1);
+    if (p == NULL) {
+        // llvm is built without exceptions, so there is nobody to catch
+        // a bad_alloc; fail the way the default handler would
+        fprintf(stderr, "glc: out of memory\n");
+        abort();
+    }
+    return p;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    free(p);
+}
+
+void InitMemStats() {
+    countNodes = IsOptionOn("mem-report");
+    if (countNodes)
+        nodes = new vector<Node*>;
+}
+
+AllocStats GetAllocStats() {
+    AllocStats stats;
+    stats.count = allocCount;
+    stats.bytes = allocBytes;
+    return stats;
+}
+
+long GetPeakRSS() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+void CountNode(Node *node) {
+    if (countNodes)
+        nodes->push_back(node);
+}
+
+static bool ByCount(const pair<string, long> &a, const pair<string, long> &b) {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+}
+
+static void PrintCounts(FILE *out, const char *title, map<string, long> &counts) {
+    vector<pair<string, long> > sorted(counts.begin(), counts.end());
+    long total = 0;
+
+    sort(sorted.begin(), sorted.end(), ByCount);
+    fprintf(out, "\n  %s:\n", title);
+    for (unsigned int i = 0; i < sorted.size(); i++) {
+        fprintf(out, "  %10ld  %s\n", sorted[i].second, sorted[i].first.c_str());
+        total += sorted[i].second;
+    }
+    fprintf(out, "  %10ld  Total\n", total);
+}
+
+void ReportMemStats(FILE *out, llvm::Module *mod) {
+    if (!IsOptionOn("mem-report"))
+        return;
+
+    map<string, long> nodeCounts;
+    for (unsigned int i = 0; i < nodes->size(); i++)
+        nodeCounts[nodes->at(i)->GetPrintNameForNode()]++;
+    PrintCounts(out, "AST nodes by class", nodeCounts);
+
+    SymbolTable *symtab = Node::symtab;
+    fprintf(out, "\n  Symbol table:\n");
+    fprintf(out, "  %10ld  scope pushes\n", symtab->pushCount);
+    fprintf(out, "  %10ld  lookups\n", symtab->lookupCount);
+    fprintf(out, "  %10ld  scopes searched by lookups\n", symtab->scopeSearchCount);
+
+    long lineBytes = 0;
+    for (unsigned int i = 0; i < savedLines.size(); i++)
+        lineBytes += strlen(savedLines[i]) + 1;
+    fprintf(out, "\n  Scanner saved lines:\n");
+    fprintf(out, "  %10ld  lines\n", (long)savedLines.size());
+    fprintf(out, "  %10ld  bytes\n", lineBytes);
+
+    if (mod == NULL)
+        return;
+
+    map<string, long> opcodeCounts;
+    for (llvm::Module::iterator f = mod->begin(); f != mod->end(); ++f)
+        for (llvm::Function::iterator bb = f->begin(); bb != f->end(); ++bb)
+            for (llvm::BasicBlock::iterator inst = bb->begin(); inst != bb->end(); ++inst)
+                opcodeCounts[inst->getOpcodeName()]++;
+    PrintCounts(out, "LLVM instructions by opcode", opcodeCounts);
+}
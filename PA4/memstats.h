@@ -0,0 +1,42 @@
+/**
+ * File: memstats.h
+ * ----------------
+ * Memory and allocation statistics for -fmem-report.
+ *
+ * The global operator new/delete are replaced so that every heap
+ * allocation made through them (ours and LLVM's) is counted; memory
+ * obtained directly from malloc()/strdup() is not.  The counters feed
+ * the per-phase table kept by PhaseTimer.  When -fmem-report is given,
+ * every ast node is also registered at construction so the nodes can be
+ * counted by class once the compile is done.
+ */
+
+#ifndef _H_memstats
+#define _H_memstats
+
+#include <stdio.h>
+
+class Node;
+namespace llvm { class Module; }
+
+struct AllocStats {
+    long count;                 // number of operator new calls
+    long bytes;                 // bytes requested by those calls
+};
+
+void InitMemStats();
+AllocStats GetAllocStats();
+long GetPeakRSS();              // in kilobytes
+void CountNode(Node *node);
+
+/**
+ * Function: ReportMemStats()
+ * --------------------------
+ * Prints the ast node counts by class, the symbol table activity, the
+ * size of the scanner's saved source lines and, if a module was emitted,
+ * the LLVM instruction counts by opcode.  Does nothing unless
+ * -fmem-report was given.
+ */
+void ReportMemStats(FILE *out, llvm::Module *mod);
+
+#endif
@@ -0,0 +1,94 @@
+/* File: optimize.cc
+ * -----------------
+ * Implementation of the -O<level> pass pipeline.
+ */
+
+#include "optimize.h"
+#include <vector>
+#include "llvm/IR/Module.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+void OptimizeModule(llvm::Module *mod, int level, llvm::TargetMachine *tm) {
+    if (level <= 0)
+        return;
+
+    llvm::PassManagerBuilder builder;
+    builder.OptLevel = level > 3 ? 3 : level;
+    builder.SizeLevel = 0;
+    builder.LoopVectorize = level > 1;
+    builder.SLPVectorize = level > 1;
+    if (level > 1)
+        builder.Inliner = llvm::createFunctionInliningPass(builder.OptLevel, 0);
+    else
+        builder.Inliner = llvm::createAlwaysInlinerPass();
+
+    llvm::legacy::FunctionPassManager fpm(mod);
+    llvm::legacy::PassManager mpm;
+    if (tm != NULL) {
+        fpm.add(llvm::createTargetTransformInfoWrapperPass(tm->getTargetIRAnalysis()));
+        mpm.add(llvm::createTargetTransformInfoWrapperPass(tm->getTargetIRAnalysis()));
+    }
+    builder.populateFunctionPassManager(fpm);
+    builder.populateModulePassManager(mpm);
+
+    fpm.doInitialization();
+    for (llvm::Module::iterator f = mod->begin(); f != mod->end(); ++f)
+        fpm.run(*f);
+    fpm.doFinalization();
+    mpm.run(*mod);
+}
+
+/* Function: Contract()
+ * --------------------
+ * Fuses the add or subtract i if one of its operands is a multiply only
+ * it uses; c - a*b becomes (-a)*b + c.  Returns whether it did.
+ */
+static bool Contract(llvm::BinaryOperator *i) {
+    for (int k = 0; k < 2; k++) {
+        llvm::BinaryOperator *mul = llvm::dyn_cast<llvm::BinaryOperator>(i->getOperand(k));
+        if (mul == NULL || mul->getOpcode() != llvm::Instruction::FMul || !mul->hasOneUse())
+            continue;
+
+        llvm::IRBuilder<> builder(i);
+        builder.SetFastMathFlags(i->getFastMathFlags());
+        llvm::Value *a = mul->getOperand(0), *b = mul->getOperand(1), *c = i->getOperand(1 - k);
+        if (i->getOpcode() == llvm::Instruction::FSub && k == 0)
+            c = builder.CreateFNeg(c);
+        else if (i->getOpcode() == llvm::Instruction::FSub)
+            a = builder.CreateFNeg(a);
+
+        llvm::Value *args[] = { a, b, c };
+        llvm::Function *fmuladd = llvm::Intrinsic::getDeclaration(i->getModule(), llvm::Intrinsic::fmuladd, i->getType());
+        llvm::Value *fused = builder.CreateCall(fmuladd, args);
+        fused->takeName(i);
+        i->replaceAllUsesWith(fused);
+        i->eraseFromParent();
+        mul->eraseFromParent();
+        return true;
+    }
+    return false;
+}
+
+long ContractMultiplyAdds(llvm::Module *mod) {
+    std::vector<llvm::BinaryOperator*> candidates;
+    for (llvm::Module::iterator f = mod->begin(); f != mod->end(); ++f) {
+        for (llvm::Function::iterator bb = f->begin(); bb != f->end(); ++bb) {
+            for (llvm::BasicBlock::iterator i = bb->begin(); i != bb->end(); ++i) {
+                llvm::BinaryOperator *op = llvm::dyn_cast<llvm::BinaryOperator>(&*i);
+                if (op != NULL && (op->getOpcode() == llvm::Instruction::FAdd || op->getOpcode() == llvm::Instruction::FSub))
+                    candidates.push_back(op);
+            }
+        }
+    }
+
+    long fused = 0;
+    for (size_t i = 0; i < candidates.size(); i++)
+        fused += Contract(candidates[i]);
+    return fused;
+}
@@ -0,0 +1,41 @@
+/**
+ * File: optimize.h
+ * ----------------
+ * The LLVM optimization pipeline run on the emitted module.
+ *
+ * glc runs it when given -O<level> (0 to 3, off by default), timed as the
+ * "optimize" phase.  glbench runs the same pipeline so the code it
+ * measures is the code glc would ship at that level.
+ */
+
+#ifndef _H_optimize
+#define _H_optimize
+
+#include <stddef.h>   // for NULL
+
+namespace llvm {
+  class Module;
+  class TargetMachine;
+}
+
+/**
+ * Function: OptimizeModule()
+ * --------------------------
+ * Runs the standard -O<level> function and module pass pipelines over
+ * mod.  If a target machine is given, its cost model is used by the
+ * vectorizers and other target-aware passes; otherwise the generic one.
+ */
+void OptimizeModule(llvm::Module *mod, int level, llvm::TargetMachine *tm = NULL);
+
+/**
+ * Function: ContractMultiplyAdds()
+ * --------------------------------
+ * -ffp-contract=fast: replaces every float add or subtract of a multiply
+ * that has no other use with llvm.fmuladd, wherever the two came from in
+ * the source.  Run after OptimizeModule, which has by then put values
+ * from different statements next to each other.  Returns the number of
+ * multiply-adds made.
+ */
+long ContractMultiplyAdds(llvm::Module *mod);
+
+#endif
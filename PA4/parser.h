@@ -35,4 +35,6 @@
 int yyparse();              // Defined in the generated y.tab.c file
 void InitParser();          // Defined in parser.y
 
+extern Program *program;    // Set by yyparse() once the whole input is parsed
+
 #endif
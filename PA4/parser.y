@@ -22,6 +22,19 @@
 
 void yyerror(const char *msg); // standard error-handling routine
 
+Program *program = NULL;
+
+/* Function: ArrayOf()
+ * -------------------
+ * The type of a declaration with the given array sizes: float a[2][3]
+ * is an array of 2 arrays of 3 floats, so a[i] is a float[3].
+ */
+static Type *ArrayOf(yyltype loc, Type *elem, List<int> *sizes) {
+    for (int i = sizes->NumElements() - 1; i >= 0; i--)
+        elem = new ArrayType(loc, elem, sizes->Nth(i));
+    return elem;
+}
+
 %}
 
 /* The section before the first %% is the Definitions section of the yacc
@@ -56,6 +69,8 @@ void yyerror(const char *msg); // standard error-handling routine
     Operator *ops;
     Identifier *funcId;
     List<Expr*> *argList;
+    LoopHints *loopHints;
+    List<int> *sizeList;
 }
 
 
@@ -72,6 +87,7 @@ void yyerror(const char *msg); // standard error-handling routine
 %token   T_While T_For T_If T_Else T_Return T_Break T_Continue T_Do 
 %token   T_Switch T_Case T_Default
 %token   T_In T_Out T_Const T_Uniform
+%token   T_Highp T_Mediump T_Lowp
 %token   T_LeftParen T_RightParen T_LeftBracket T_RightBracket T_LeftBrace T_RightBrace
 %token   T_Dot T_Comma T_Colon T_Semicolon T_Question
 
@@ -80,12 +96,15 @@ void yyerror(const char *msg); // standard error-handling routine
 %token   <identifier> T_Plus T_Star
 %token   <identifier> T_MulAssign T_DivAssign T_AddAssign T_SubAssign T_Equal
 %token   <identifier> T_LeftAngle T_RightAngle T_Dash T_Slash
+%token   <identifier> T_LeftShift T_RightShift
 %token   <identifier> T_Inc T_Dec 
 %token   <identifier> T_Identifier
-%token   <integerConstant> T_IntConstant
+%token   <integerConstant> T_IntConstant T_UintConstant
 %token   <floatConstant> T_FloatConstant
 %token   <boolConstant> T_BoolConstant
 %token   <identifier> T_FieldSelection
+%token   <integerConstant> T_PragmaUnroll T_PragmaVectorize
+%token   T_PragmaNoUnroll
 
 %nonassoc LOWEST
 %nonassoc LOWER_THAN_ELSE
@@ -111,8 +130,9 @@ void yyerror(const char *msg); // standard error-handling routine
 %type <decl>      Declaration
 %type <funcDecl>  FuncDecl
 %type <typeDecl>  TypeDecl
-%type <typeQualifier> TypeQualify
-%type <expression> PrimaryExpr PostfixExpr UnaryExpr MultiExpr AdditionExpr RelationExpr Initializer FunctionCallExpr FunctionCallHeaderWithParameters FunctionCallHeaderNoParameters
+%type <typeQualifier> TypeQualify StorageQualify PrecisionQualify
+%type <sizeList>  ArraySizes
+%type <expression> PrimaryExpr PostfixExpr UnaryExpr MultiExpr AdditionExpr ShiftExpr RelationExpr Initializer FunctionCallExpr FunctionCallHeaderWithParameters FunctionCallHeaderNoParameters
 %type <expression> EqualityExpr LogicAndExpr LogicOrExpr Expression
  /*%type <floatConstant> Initializer*/
 %type <varDecl>    SingleDecl
@@ -124,6 +144,7 @@ void yyerror(const char *msg); // standard error-handling routine
 %type <ops>        AssignOp
 %type <funcId>     FunctionIdentifier
 %type <argList>    ArgumentList
+%type <loopHints>  LoopHints
 
 %%
 /* Rules
@@ -137,13 +158,12 @@ Program   :    DeclList            {
                                       /* pp2: The @1 is needed to convince 
                                        * yacc to set up yylloc. You can remove 
                                        * it once you have other uses of @n*/
-                                      Program *program = new Program($1);
-                                      // if no errors, advance to next phase
+                                      program = new Program($1);
+                                      // if no errors, main() advances to the next phase
                                       if (ReportError::NumErrors() == 0) {
                                           if ( IsDebugOn("dumpAST") ) {
                                             program->Print(0);
                                           }
-                                          program->Emit();
                                       }
                                     }
           ;
@@ -214,35 +234,71 @@ SingleDecl    : TypeDecl T_Identifier
                             Identifier *id = new Identifier(yylloc, (const char *)$3); 
                             $$ = new VarDecl(id, $2, $1, $5);
                          }
-              | TypeDecl T_Identifier T_LeftBracket T_IntConstant T_RightBracket 
+              | TypeDecl T_Identifier ArraySizes
                          { 
                             Identifier *id = new Identifier(@2, (const char *)$2);
-                            $$ = new VarDecl(id, new ArrayType(@1, $1, $4));
+                            $$ = new VarDecl(id, ArrayOf(@1, $1, $3));
                          }
-              | TypeQualify TypeDecl T_Identifier T_LeftBracket T_IntConstant T_RightBracket 
+              | TypeQualify TypeDecl T_Identifier ArraySizes
                          { 
                             Identifier *id = new Identifier(@3, $3);
-                            $$ = new VarDecl(id, new ArrayType(@2, $2, $5), $1);
+                            $$ = new VarDecl(id, ArrayOf(@2, $2, $4), $1);
+                         }
+              | TypeDecl T_Identifier ArraySizes T_Equal T_LeftBrace ArgumentList T_RightBrace
+                         {
+                            Identifier *id = new Identifier(@2, (const char *)$2);
+                            $$ = new VarDecl(id, ArrayOf(@1, $1, $3), new InitializerList(@5, $6));
+                         }
+              | TypeQualify TypeDecl T_Identifier ArraySizes T_Equal T_LeftBrace ArgumentList T_RightBrace
+                         {
+                            Identifier *id = new Identifier(@3, $3);
+                            $$ = new VarDecl(id, ArrayOf(@2, $2, $4), $1, new InitializerList(@6, $7));
                          }
 
               ;
 
+ArraySizes    : T_LeftBracket T_IntConstant T_RightBracket
+                         { ($$ = new List<int>)->Append($2); }
+              | ArraySizes T_LeftBracket T_IntConstant T_RightBracket
+                         { ($$ = $1)->Append($3); }
+              ;
+
 Initializer        : Expression    { $$ = $1; }
                    ;
 
-TypeQualify    : T_In       {$$ = TypeQualifier::inTypeQualifier;}
+TypeQualify    : StorageQualify                  { $$ = $1; }
+               | PrecisionQualify                { $$ = $1; }
+               | StorageQualify PrecisionQualify { $$ = new TypeQualifier($1, $2); }
+               ;
+
+StorageQualify : T_In       {$$ = TypeQualifier::inTypeQualifier;}
                | T_Out      {$$ = TypeQualifier::outTypeQualifier;}
                | T_Const    {$$ = TypeQualifier::constTypeQualifier;}
                | T_Uniform  {$$ = TypeQualifier::uniformTypeQualifier;}
                ;
 
+PrecisionQualify : T_Highp   {$$ = TypeQualifier::highpTypeQualifier;}
+                 | T_Mediump {$$ = TypeQualifier::mediumpTypeQualifier;}
+                 | T_Lowp    {$$ = TypeQualifier::lowpTypeQualifier;}
+                 ;
+
 TypeDecl       : T_Int                   { $$ = Type::intType;    }
                | T_Void                  { $$ = Type::voidType;   }
                | T_Float                 { $$ = Type::floatType;  }
                | T_Bool                  { $$ = Type::boolType;   }
+               | T_Uint                  { $$ = Type::uintType;   }
                | T_Vec2                  { $$ = Type::vec2Type;   }
                | T_Vec3                  { $$ = Type::vec3Type;   }
                | T_Vec4                  { $$ = Type::vec4Type;   }
+               | T_Ivec2                 { $$ = Type::ivec2Type;  }
+               | T_Ivec3                 { $$ = Type::ivec3Type;  }
+               | T_Ivec4                 { $$ = Type::ivec4Type;  }
+               | T_Uvec2                 { $$ = Type::uvec2Type;  }
+               | T_Uvec3                 { $$ = Type::uvec3Type;  }
+               | T_Uvec4                 { $$ = Type::uvec4Type;  }
+               | T_Bvec2                 { $$ = Type::bvec2Type;  }
+               | T_Bvec3                 { $$ = Type::bvec3Type;  }
+               | T_Bvec4                 { $$ = Type::bvec4Type;  }
                | T_Mat2                  { $$ = Type::mat2Type;   }
                | T_Mat3                  { $$ = Type::mat3Type;   }
                | T_Mat4                  { $$ = Type::mat4Type;   }
@@ -272,6 +328,24 @@ SingleStatement   : T_Semicolon      { $$ = new EmptyExpr();  }
                   | JumpStmt         { $$ = $1; }
                   | WhileStmt        { $$ = $1; }
                   | ForStmt          { $$ = $1; }
+                  | LoopHints WhileStmt
+                                     {
+                                       dynamic_cast<LoopStmt*>($2)->SetHints(*$1);
+                                       $$ = $2;
+                                     }
+                  | LoopHints ForStmt
+                                     {
+                                       dynamic_cast<LoopStmt*>($2)->SetHints(*$1);
+                                       $$ = $2;
+                                     }
+                  ;
+
+LoopHints         : T_PragmaUnroll                { ($$ = new LoopHints)->unroll = $1; }
+                  | T_PragmaNoUnroll              { ($$ = new LoopHints)->unroll = 1; }
+                  | T_PragmaVectorize             { ($$ = new LoopHints)->vectorize = $1; }
+                  | LoopHints T_PragmaUnroll      { ($$ = $1)->unroll = $2; }
+                  | LoopHints T_PragmaNoUnroll    { ($$ = $1)->unroll = 1; }
+                  | LoopHints T_PragmaVectorize   { ($$ = $1)->vectorize = $2; }
                   ;
 
 SelectionStmt     : T_If T_LeftParen Expression T_RightParen Statement T_Else Statement
@@ -312,6 +386,7 @@ PrimaryExpr        : T_Identifier    { Identifier *id = new Identifier(yylloc, (
                                        $$ = new VarExpr(yyloc, id);
                                      }
                    | T_IntConstant   { $$ = new IntConstant(yylloc, $1); }
+                   | T_UintConstant  { $$ = new UintConstant(yylloc, $1); }
                    | T_FloatConstant { $$ = new FloatConstant(yylloc, $1); } 
                    | T_BoolConstant  { $$ = new BoolConstant(yylloc, $1); }
                    | T_LeftParen Expression T_RightParen { $$ = $2;}
@@ -333,6 +408,7 @@ ArgumentList : Expression                       { ($$ = new List<Expr*>)->Append
              ;
 
 FunctionIdentifier  : T_Identifier        { $$ = new Identifier(@1, $1); }
+                    | TypeDecl            { $$ = new Identifier(@1, $1->GetTypeName()); }
                     ;
 
 PostfixExpr        : PrimaryExpr     { $$ = $1; }
@@ -406,23 +482,36 @@ AdditionExpr       : MultiExpr       { $$ = $1; }
                            }
                    ;
 
-RelationExpr       : AdditionExpr       { $$ = $1; }
-                   | RelationExpr T_LeftAngle AdditionExpr
+ShiftExpr          : AdditionExpr       { $$ = $1; }
+                   | ShiftExpr T_LeftShift AdditionExpr
+                           {
+                             Operator *op = new Operator(yylloc, $2);
+                             $$ = new ArithmeticExpr($1, op, $3);
+                           }
+                   | ShiftExpr T_RightShift AdditionExpr
+                           {
+                             Operator *op = new Operator(yylloc, $2);
+                             $$ = new ArithmeticExpr($1, op, $3);
+                           }
+                   ;
+
+RelationExpr       : ShiftExpr          { $$ = $1; }
+                   | RelationExpr T_LeftAngle ShiftExpr
                            {
                              Operator *op = new Operator(yylloc, $2);
                              $$ = new RelationalExpr($1, op, $3);
                            }
-                   | RelationExpr T_RightAngle AdditionExpr
+                   | RelationExpr T_RightAngle ShiftExpr
                            {
                              Operator *op = new Operator(yylloc, $2);
                              $$ = new RelationalExpr($1, op, $3);
                            }
-                   | RelationExpr T_GreaterEqual AdditionExpr
+                   | RelationExpr T_GreaterEqual ShiftExpr
                            {
                              Operator *op = new Operator(yylloc, $2);
                              $$ = new RelationalExpr($1, op, $3);
                            }
-                   | RelationExpr T_LessEqual AdditionExpr
+                   | RelationExpr T_LessEqual ShiftExpr
                            {
                              Operator *op = new Operator(yylloc, $2);
                              $$ = new RelationalExpr($1, op, $3);
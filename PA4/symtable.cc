@@ -14,6 +14,7 @@ void SymbolTable::push_scope(scopeType st) {
 	symbolTable->push_back(scope);
 	scopeTypeStack->push_back(st);
 	currentScope++;
+	pushCount++;
 
 }
 
@@ -39,7 +40,9 @@ bool SymbolTable::add_decl(string ident, FnDecl* fndec) {
 
 Decl* SymbolTable::search_scope(string ident) {
 	int num = 0;
+	lookupCount++;
 	for(int i = currentScope; i >= 0; i--) {
+		scopeSearchCount++;
 		num = symbolTable->at(i).count(ident);
 		if (num > 0) {
 			return symbolTable->at(i).at(ident).first;
@@ -51,7 +54,9 @@ Decl* SymbolTable::search_scope(string ident) {
 
 llvm::Value* SymbolTable::val_search(string ident) {
 	int num = 0;
+	lookupCount++;
 	for(int i = currentScope; i >= 0; i--) {
+		scopeSearchCount++;
 		num = symbolTable->at(i).count(ident);
 		if (num > 0) {
 			return symbolTable->at(i).at(ident).second;
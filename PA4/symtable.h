@@ -40,7 +40,10 @@ class SymbolTable {
 		FnDecl* lastFunc;
 		bool foundReturn;
 
-		SymbolTable() : currentScope(-1) {
+		// activity counters for -fmem-report
+		long pushCount, lookupCount, scopeSearchCount;
+
+		SymbolTable() : currentScope(-1), pushCount(0), lookupCount(0), scopeSearchCount(0) {
 			symbolTable = new vector< map < string, pair<Decl*, llvm::Value* > > >();
 			scopeTypeStack = new vector< scopeType >();
 			justLike = false;
@@ -0,0 +1,206 @@
+/* File: timer.cc
+ * --------------
+ * Implementation of the phase timers behind -ftime-report/-ftime-trace.
+ */
+
+#include "timer.h"
+#include "utility.h"
+#include "memstats.h"
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <map>
+using namespace std;
+
+struct PhaseRecord {
+    string phase, detail;
+    int depth;                  // nesting level when the phase first ran
+    int count;
+    double wall, cpu;           // accumulated, in seconds
+    long allocs, bytes;         // accumulated operator new calls and bytes
+    long peakRSS;               // peak resident set size at phase end, in KB
+};
+
+struct TraceEvent {
+    int record;
+    double start, duration;     // in seconds since PhaseTimer::Init()
+};
+
+static vector<PhaseRecord> records;
+static map<string, int> recordIndex;
+static vector<TraceEvent> events;
+static vector<pair<string, long> > counters;
+static double initWall, initCpu;
+
+PhaseTimer *PhaseTimer::current = NULL;
+bool PhaseTimer::enabled = false;
+
+static double Seconds(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int FindRecord(const char *phase, const char *detail, int depth) {
+    string key = string(phase) + '\0' + (detail ? detail : "");
+    map<string, int>::iterator it = recordIndex.find(key);
+    if (it != recordIndex.end())
+        return it->second;
+
+    PhaseRecord r;
+    r.phase = phase;
+    r.detail = detail ? detail : "";
+    r.depth = depth;
+    r.count = 0;
+    r.wall = r.cpu = 0;
+    r.allocs = r.bytes = r.peakRSS = 0;
+    records.push_back(r);
+    return recordIndex[key] = records.size() - 1;
+}
+
+void PhaseTimer::Init() {
+    enabled = IsOptionOn("time-report") || IsOptionOn("time-trace") ||
+              IsOptionOn("mem-report");
+    initWall = Seconds(CLOCK_MONOTONIC);
+    initCpu = Seconds(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+PhaseTimer::PhaseTimer(const char *phase, const char *detail, bool tr) {
+    record = -1;
+    if (!enabled)
+        return;
+
+    int depth = 0;
+    for (PhaseTimer *t = current; t != NULL; t = t->outer)
+        depth++;
+
+    record = FindRecord(phase, detail, depth);
+    traced = tr;
+    outer = current;
+    current = this;
+    startAllocs = GetAllocStats();
+    startCpu = Seconds(CLOCK_PROCESS_CPUTIME_ID);
+    startWall = Seconds(CLOCK_MONOTONIC);
+}
+
+PhaseTimer::~PhaseTimer() {
+    if (record == -1)
+        return;
+
+    double wall = Seconds(CLOCK_MONOTONIC) - startWall;
+    double cpu = Seconds(CLOCK_PROCESS_CPUTIME_ID) - startCpu;
+    AllocStats allocs = GetAllocStats();
+    PhaseRecord &r = records[record];
+    r.count++;
+    r.wall += wall;
+    r.cpu += cpu;
+    r.allocs += allocs.count - startAllocs.count;
+    r.bytes += allocs.bytes - startAllocs.bytes;
+    r.peakRSS = GetPeakRSS();
+
+    if (traced) {
+        TraceEvent e;
+        e.record = record;
+        e.start = startWall - initWall;
+        e.duration = wall;
+        events.push_back(e);
+    }
+    current = outer;
+}
+
+void PhaseTimer::Report(FILE *out) {
+    if (IsOptionOn("time-report"))
+        ReportTime(out);
+    if (IsOptionOn("mem-report"))
+        ReportMemory(out);
+}
+
+void PhaseTimer::ReportTime(FILE *out) {
+
+    double wall = Seconds(CLOCK_MONOTONIC) - initWall;
+    double cpu = Seconds(CLOCK_PROCESS_CPUTIME_ID) - initCpu;
+
+    fprintf(out, "===%s===\n", string(70, '-').c_str());
+    fprintf(out, "%*s\n", 49, "glc compile time report");
+    fprintf(out, "===%s===\n", string(70, '-').c_str());
+    fprintf(out, "  %10s  %10s  %8s  %s\n", "Wall (s)", "CPU (s)", "Count", "Phase");
+    for (unsigned int i = 0; i < records.size(); i++) {
+        PhaseRecord &r = records[i];
+        fprintf(out, "  %10.6f  %10.6f  %8d  %*s%s%s%s\n", r.wall, r.cpu, r.count,
+                2 * r.depth, "", r.phase.c_str(), r.detail.empty() ? "" : " ",
+                r.detail.c_str());
+    }
+    fprintf(out, "  %10.6f  %10.6f  %8s  Total\n", wall, cpu, "");
+}
+
+void PhaseTimer::ReportMemory(FILE *out) {
+    AllocStats total = GetAllocStats();
+
+    fprintf(out, "===%s===\n", string(70, '-').c_str());
+    fprintf(out, "%*s\n", 50, "glc compile memory report");
+    fprintf(out, "===%s===\n", string(70, '-').c_str());
+    fprintf(out, "  %10s  %12s  %10s  %s\n", "Allocs", "Bytes", "Peak KB", "Phase");
+    for (unsigned int i = 0; i < records.size(); i++) {
+        PhaseRecord &r = records[i];
+        fprintf(out, "  %10ld  %12ld  %10ld  %*s%s%s%s\n", r.allocs, r.bytes, r.peakRSS,
+                2 * r.depth, "", r.phase.c_str(), r.detail.empty() ? "" : " ",
+                r.detail.c_str());
+    }
+    fprintf(out, "  %10ld  %12ld  %10ld  Total\n", total.count, total.bytes, GetPeakRSS());
+}
+
+void PhaseTimer::SetCounter(const char *name, long value) {
+    for (unsigned int i = 0; i < counters.size(); i++) {
+        if (counters[i].first == name) {
+            counters[i].second = value;
+            return;
+        }
+    }
+    counters.push_back(make_pair(string(name), value));
+}
+
+static void WriteJSONString(FILE *out, const string &s) {
+    fputc('"', out);
+    for (unsigned int i = 0; i < s.size(); i++) {
+        char c = s[i];
+        if (c == '"' || c == '\\')
+            fprintf(out, "\\%c", c);
+        else if ((unsigned char)c < 0x20)
+            fprintf(out, "\\u%04x", c);
+        else
+            fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+bool PhaseTimer::WriteTrace(const char *fileName) {
+    FILE *out = fopen(fileName, "w");
+    if (out == NULL)
+        return false;
+
+    fprintf(out, "{\"traceEvents\":[\n");
+    for (unsigned int i = 0; i < events.size(); i++) {
+        PhaseRecord &r = records[events[i].record];
+        fprintf(out, "%s{\"name\":", i ? ",\n" : "");
+        WriteJSONString(out, r.detail.empty() ? r.phase : r.phase + " " + r.detail);
+        fprintf(out, ",\"cat\":");
+        WriteJSONString(out, r.phase);
+        fprintf(out, ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f",
+                events[i].start * 1e6, events[i].duration * 1e6);
+        if (!r.detail.empty()) {
+            fprintf(out, ",\"args\":{\"detail\":");
+            WriteJSONString(out, r.detail);
+            fprintf(out, "}");
+        }
+        fprintf(out, "}");
+    }
+    fprintf(out, "\n],\"otherData\":{");
+    for (unsigned int i = 0; i < counters.size(); i++) {
+        fprintf(out, "%s", i ? "," : "");
+        WriteJSONString(out, counters[i].first);
+        fprintf(out, ":%ld", counters[i].second);
+    }
+    fprintf(out, "},\"displayTimeUnit\":\"ms\"}\n");
+    return fclose(out) == 0;
+}
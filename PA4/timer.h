@@ -0,0 +1,66 @@
+/**
+ * File: timer.h
+ * -------------
+ * Per-phase compile time instrumentation.
+ *
+ * A PhaseTimer measures the wall and CPU time spent between its
+ * construction and its destruction, so timing a phase is just a matter
+ * of declaring one at the top of the scope that implements it:
+ *
+ *    {
+ *       PhaseTimer timer("parse");
+ *       yyparse();
+ *    }
+ *
+ * Timers nest; a timer started while another one is running is reported
+ * as a sub-phase of the running one.  The optional detail string
+ * separates repeated instances of a phase, e.g. one IR emission entry per
+ * function.  Timers are no-ops unless -ftime-report, -ftime-trace or
+ * -fmem-report was given on the command line:
+ *
+ *    -ftime-report        print a table of all phases to stderr
+ *    -ftime-trace=<file>  write a Chrome trace-event JSON file with one
+ *                         span per phase and per function
+ *    -fmem-report         print the heap allocations and peak RSS of each
+ *                         phase to stderr (see memstats.h)
+ *
+ * Counters set with SetCounter() (such as the number of tokens scanned)
+ * are written to the trace file's "otherData" section so tools reading
+ * the trace can compute throughput.
+ */
+
+#ifndef _H_timer
+#define _H_timer
+
+#include <stdio.h>
+#include "memstats.h"
+
+class PhaseTimer {
+  public:
+    // traced is false for phases that run too often to be shown as
+    // individual spans (such as scanning one token); they are still
+    // accumulated in the report.
+    PhaseTimer(const char *phase, const char *detail = NULL, bool traced = true);
+    ~PhaseTimer();
+
+    static void Init();
+    static bool IsEnabled() { return enabled; }
+    static void Report(FILE *out);
+    static bool WriteTrace(const char *fileName);
+    static void SetCounter(const char *name, long value);
+
+  private:
+    int record;                 // index into the record table, -1 if disabled
+    bool traced;
+    double startWall, startCpu;
+    AllocStats startAllocs;
+    PhaseTimer *outer;
+
+    static void ReportTime(FILE *out);
+    static void ReportMemory(FILE *out);
+
+    static PhaseTimer *current;
+    static bool enabled;
+};
+
+#endif
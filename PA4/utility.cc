@@ -11,6 +11,7 @@
 using std::vector;
 
 static vector<const char*> debugKeys;
+static vector<const char*> optionNames, optionValues;
 static const int BufferSize = 2048;
 
 void Failure(const char *format, ...) {
@@ -58,19 +59,64 @@ void PrintDebug(const char *key, const char *format, ...) {
   printf("+++ (%s): %s%s", key, buf, buf[strlen(buf)-1] != '\n'? "\n" : "");
 }
 
-void ParseCommandLine(int argc, char *argv[]) {
-  if (argc == 1)
-    return;
-  
-  if (strcmp(argv[1], "-d") != 0) { // first arg is not -d
-    printf("Incorrect Use:   ");
-    for (int i = 1; i < argc; i++) printf("%s ", argv[i]);
-    printf("\n");
-    printf("Correct Usage:   -d <debug-key-1> <debug-key-2> ... \n");
-    exit(2);
+int IndexOfOption(const char *name) {
+  for (unsigned int i = 0; i < optionNames.size(); i++)
+    if (!strcmp(optionNames[i], name))
+      return i;
+
+  return -1;
+}
+
+void SetOption(const char *name, const char *value) {
+  int k = IndexOfOption(name);
+  if (k != -1) {
+    optionNames.erase(optionNames.begin() + k);
+    optionValues.erase(optionValues.begin() + k);
   }
+  if (value) {
+    optionNames.push_back(strdup(name));
+    optionValues.push_back(strdup(value));
+  }
+}
 
-  for (int i = 2; i < argc; i++)
-    SetDebugForKey(argv[i], true);
+bool IsOptionOn(const char *name) {
+  return (IndexOfOption(name) != -1);
 }
 
+const char *GetOptionValue(const char *name) {
+  int k = IndexOfOption(name);
+  return (k == -1 ? NULL : optionValues[k]);
+}
+
+static void ParseOption(const char *arg) {
+  char name[BufferSize];
+  const char *eq = strchr(arg, '=');
+
+  snprintf(name, sizeof(name), "%.*s", (int)(eq ? eq - arg : strlen(arg)), arg);
+  if (!strncmp(name, "no-", 3))
+    SetOption(name + 3, NULL);
+  else
+    SetOption(name, eq ? eq + 1 : "");
+}
+
+void ParseCommandLine(int argc, char *argv[]) {
+  bool debugKeysFollow = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-d")) {
+      debugKeysFollow = true;
+    } else if (!strncmp(argv[i], "-f", 2) && argv[i][2] != '\0') {
+      ParseOption(argv[i] + 2);
+    } else if (!strncmp(argv[i], "-O", 2) && argv[i][2] >= '0' && argv[i][2] <= '3' && argv[i][3] == '\0') {
+      SetOption("opt-level", argv[i] + 2);
+    } else if (debugKeysFollow && argv[i][0] != '-') {
+      SetDebugForKey(argv[i], true);
+    } else {
+      printf("Incorrect Use:   ");
+      for (int j = 1; j < argc; j++) printf("%s ", argv[j]);
+      printf("\n");
+      printf("Correct Usage:   [-O<level>] [-f<option>[=<value>] ...] [-d <debug-key-1> <debug-key-2> ...]\n");
+      exit(2);
+    }
+  }
+}
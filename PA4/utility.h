@@ -73,12 +73,45 @@ void SetDebugForKey(const char *key, bool val);
 
 bool IsDebugOn(const char *key);
 
+/**
+ * Function: SetOption()
+ * Usage: SetOption("time-trace", "trace.json");
+ * ---------------------------------------------
+ * Records a compiler option, optionally with a value.  Options are the
+ * -f<name>[=<value>] flags given on the command line; -fno-<name> turns
+ * a previously given option back off.  Passing NULL as the value clears
+ * the option.
+ */
+
+void SetOption(const char *name, const char *value);
+
+/**
+ * Function: IsOptionOn()
+ * Usage: if (IsOptionOn("time-report")) ...
+ * -----------------------------------------
+ * Return true/false based on whether this option was given.
+ */
+
+bool IsOptionOn(const char *name);
+
+/**
+ * Function: GetOptionValue()
+ * Usage: const char *file = GetOptionValue("time-trace");
+ * -------------------------------------------------------
+ * Returns the value given with the option (the text after the '='), an
+ * empty string if the option was given without a value, or NULL if the
+ * option is not on.
+ */
+
+const char *GetOptionValue(const char *name);
+
 /**
  * Function: ParseCommandLine
  * --------------------------
- * Turn on the debugging flags from the command line.  Verifies that
- * first argument is -d, and then interpret all the arguments that follow
- * as being flags to turn on.
+ * Turn on the options and debugging flags from the command line.  Any
+ * -f<name>[=<value>] argument sets an option, and -O<level> sets the
+ * "opt-level" option.  A -d argument means that all the plain arguments
+ * that follow are debug flags to turn on.
  */
 
 void ParseCommandLine(int argc, char *argv[]);